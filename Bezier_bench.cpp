@@ -0,0 +1,164 @@
+/*
+Bezier flattening benchmark: fixed segment counts vs tolerance-driven
+flattening on a mix of curve sizes (2 px .. 1000 px).
+
+  fixed N    : Bezier2D::tesselate_* with N segments (new vector per curve)
+  adaptive   : Bezier2D::flatten_* at 0.25 px into one reused buffer
+
+Reports ns per curve, points per curve and the worst distance from the
+curve to its polyline (densely sampled).
+
+Then fixed-count cubic tessellation (16 segments) three ways:
+
+  per point  : Bernstein evaluation + push_back into a new vector
+  fwd diff   : Bezier2D::forward_diff_cubic, curve after curve into one
+               preallocated buffer
+  SoA batch  : Bezier2D::evaluate over a Batch<4>, all curves at once
+*/
+
+#include "Bezier2D.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+struct Cubic { Point2D p[4]; };
+
+static double seg_dist(const Point2D& p, const Point2D& a, const Point2D& b) {
+    double vx = b.x - a.x, vy = b.y - a.y;
+    double wx = p.x - a.x, wy = p.y - a.y;
+    double L = vx*vx + vy*vy;
+    double t = (L > 0.0) ? std::max(0.0, std::min(1.0, (wx*vx + wy*vy) / L)) : 0.0;
+    double dx = wx - t*vx, dy = wy - t*vy;
+    return std::sqrt(dx*dx + dy*dy);
+}
+
+// Worst distance from densely sampled curve points to the polyline
+template<typename Eval>
+static double max_error(Eval eval, const std::vector<Point2D>& poly) {
+    double worst = 0.0;
+    for (int i=0; i<=512; ++i) {
+        Point2D p = eval(i / 512.0);
+        double best = 1e30;
+        for (size_t k=0; k+1<poly.size(); ++k) best = std::min(best, seg_dist(p, poly[k], poly[k+1]));
+        worst = std::max(worst, best);
+    }
+    return worst;
+}
+
+int main() {
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<double> U(-1.0, 1.0);
+    std::vector<Cubic> curves;
+    for (int i=0; i<20000; ++i) {
+        double scale = std::pow(10.0, 0.3 + 2.7 * (0.5 + 0.5 * U(rng)));   // 2 .. 1000 px
+        Point2D o(500 + 400*U(rng), 500 + 400*U(rng));
+        Cubic c;
+        for (auto& p : c.p) p = Point2D(o.x + scale*U(rng), o.y + scale*U(rng));
+        curves.push_back(c);
+    }
+
+    auto ns = [&](auto t0, auto t1) {
+        return std::chrono::duration<double, std::nano>(t1 - t0).count() / curves.size();
+    };
+    const double tol = 0.25;
+    volatile double sink = 0.0;
+
+    std::printf("%-22s %10s %10s %12s\n", "method", "ns/curve", "pts/curve", "max err px");
+    for (int kind=0; kind<2; ++kind) {
+        const char* name = kind ? "cubic" : "quadratic";
+        auto evalOf = [&](const Cubic& c) {
+            return [&c, kind](double t) {
+                return kind ? Bezier2D::cubic(c.p[0], c.p[1], c.p[2], c.p[3], t)
+                            : Bezier2D::quad(c.p[0], c.p[1], c.p[3], t);
+            };
+        };
+
+        for (int segs : { 16, 64 }) {
+            size_t pts = 0;
+            auto t0 = std::chrono::steady_clock::now();
+            for (const auto& c : curves) {
+                auto v = kind ? Bezier2D::tesselate_cubic(c.p[0], c.p[1], c.p[2], c.p[3], segs)
+                              : Bezier2D::tesselate_quadratic(c.p[0], c.p[1], c.p[3], segs);
+                pts += v.size();
+                sink = sink + v.back().x;
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            double err = 0.0;
+            for (size_t i=0; i<curves.size(); i+=200) {
+                const auto& c = curves[i];
+                auto v = kind ? Bezier2D::tesselate_cubic(c.p[0], c.p[1], c.p[2], c.p[3], segs)
+                              : Bezier2D::tesselate_quadratic(c.p[0], c.p[1], c.p[3], segs);
+                err = std::max(err, max_error(evalOf(c), v));
+            }
+            char label[32];
+            std::snprintf(label, sizeof label, "%s fixed %d", name, segs);
+            std::printf("%-22s %10.1f %10.1f %12.3f\n", label, ns(t0,t1), (double)pts / curves.size(), err);
+        }
+
+        std::vector<Point2D> buf;
+        size_t pts = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (const auto& c : curves) {
+            buf.clear();
+            buf.push_back(c.p[0]);
+            if (kind) Bezier2D::flatten_cubic(c.p[0], c.p[1], c.p[2], c.p[3], tol, buf);
+            else      Bezier2D::flatten_quadratic(c.p[0], c.p[1], c.p[3], tol, buf);
+            pts += buf.size();
+            sink = sink + buf.back().x;
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        double err = 0.0;
+        for (size_t i=0; i<curves.size(); i+=200) {
+            const auto& c = curves[i];
+            buf.clear();
+            buf.push_back(c.p[0]);
+            if (kind) Bezier2D::flatten_cubic(c.p[0], c.p[1], c.p[2], c.p[3], tol, buf);
+            else      Bezier2D::flatten_quadratic(c.p[0], c.p[1], c.p[3], tol, buf);
+            err = std::max(err, max_error(evalOf(c), buf));
+        }
+        char label[32];
+        std::snprintf(label, sizeof label, "%s adaptive", name);
+        std::printf("%-22s %10.1f %10.1f %12.3f\n", label, ns(t0,t1), (double)pts / curves.size(), err);
+    }
+
+    // Fixed-count tessellation
+    const int segs = 16;
+    auto t0 = std::chrono::steady_clock::now();
+    for (const auto& c : curves) {
+        std::vector<Point2D> v;
+        for (int i=0; i<=segs; ++i) v.push_back(Bezier2D::cubic(c.p[0], c.p[1], c.p[2], c.p[3], (double)i / segs));
+        sink = sink + v[segs/2].x;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::vector<Point2D> all(curves.size() * (segs + 1));
+    double drift = 0.0;
+    auto t2 = std::chrono::steady_clock::now();
+    for (size_t k=0; k<curves.size(); ++k) {
+        const auto& c = curves[k];
+        Bezier2D::forward_diff_cubic(c.p[0], c.p[1], c.p[2], c.p[3], segs, &all[k * (segs + 1)]);
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    sink = sink + all[all.size()/2].x;
+    for (size_t k=0; k<curves.size(); ++k) {
+        const auto& c = curves[k];
+        for (int i=0; i<=segs; ++i)
+            drift = std::max(drift, all[k * (segs + 1) + i].distance_to(
+                Bezier2D::cubic(c.p[0], c.p[1], c.p[2], c.p[3], (double)i / segs)));
+    }
+
+    Bezier2D::Batch<4> batch;
+    for (const auto& c : curves) batch.add(c.p[0], c.p[1], c.p[2], c.p[3]);
+    std::vector<double> xs, ys;
+    Bezier2D::evaluate(batch, segs, xs, ys);        // warm the output buffers
+    auto t4 = std::chrono::steady_clock::now();
+    Bezier2D::evaluate(batch, segs, xs, ys);
+    auto t5 = std::chrono::steady_clock::now();
+    sink = sink + xs[xs.size()/2];
+
+    std::printf("\ncubic, %d segments      ns/curve\n", segs);
+    std::printf("  per point          %10.1f\n", ns(t0,t1));
+    std::printf("  fwd diff           %10.1f   (max drift %.2e px)\n", ns(t2,t3), drift);
+    std::printf("  SoA batch          %10.1f\n", ns(t4,t5));
+    return 0;
+}
@@ -0,0 +1,136 @@
+/*
+Sphere generation benchmark: recursive vs direct builders.
+
+  icosphere   : subdivide_icosphere (level after level from the
+                icosahedron) vs make_icosphere_arrays (level N written
+                straight into flat arrays) and make_icosphere on top of it
+  cube-sphere : the previous add_vertex/add_face builder vs
+                make_cube_sphere_arrays / make_cube_sphere
+
+Reports ms and an estimate of the memory held by the result (Face objects
+with their own index vectors vs one flat index array). Every mesh is also
+checked: vertex count, Euler characteristic 2, each edge shared by exactly
+two triangles, all vertices on the sphere. The cube-sphere output must
+match the previous builder exactly.
+*/
+
+#include "MeshBuilders.hpp"
+#include <chrono>
+#include <cstdio>
+#include <unordered_map>
+
+// The cube-sphere builder as it was: one add_vertex/add_face per element
+static Mesh3D cube_sphere_reference(int subdiv, double radius) {
+    Mesh3D mesh;
+    auto buildFace = [&](int axis, int dir) {
+        int base = (int)mesh.vertices.size();
+        for (int i=0; i<=subdiv; ++i) {
+            double u = (double)i/subdiv, uu = -1.0 + 2.0*u;
+            for (int j=0; j<=subdiv; ++j) {
+                double v = (double)j/subdiv, vv = -1.0 + 2.0*v;
+                double x=0,y=0,z=0;
+                if (axis==0) { x = dir; y=uu; z=vv; }
+                if (axis==1) { y = dir; x=uu; z=vv; }
+                if (axis==2) { z = dir; x=uu; y=vv; }
+                double len = std::sqrt(x*x + y*y + z*z);
+                mesh.add_vertex(Point3D(x/len*radius, y/len*radius, z/len*radius), Point2D(u, v));
+            }
+        }
+        for (int i=0; i<subdiv; ++i) {
+            for (int j=0; j<subdiv; ++j) {
+                int v0 = base + i*(subdiv+1) + j, v1 = v0 + 1;
+                int v2 = v0 + (subdiv+1),         v3 = v2 + 1;
+                mesh.add_face({v0,v1,v3});
+                mesh.add_face({v0,v3,v2});
+            }
+        }
+    };
+    buildFace(0,1);  buildFace(0,-1);
+    buildFace(1,1);  buildFace(1,-1);
+    buildFace(2,1);  buildFace(2,-1);
+    return mesh;
+}
+
+// Heap bytes: vertex storage plus, per Face, the object and its own
+// 3-int allocation (16 bytes of malloc overhead assumed)
+static double mesh_mb(const Mesh3D& m) {
+    size_t b = m.vertices.capacity() * sizeof(Point3D) + m.uv.capacity() * sizeof(Point2D)
+             + m.faces.capacity() * sizeof(Face);
+    for (const auto& f : m.faces) b += f.indices.capacity() * sizeof(int) + 16;
+    return b / 1048576.0;
+}
+
+static double flat_mb(size_t verts, size_t uvs, size_t idx) {
+    return (verts * sizeof(Point3D) + uvs * sizeof(Point2D) + idx * sizeof(int)) / 1048576.0;
+}
+
+// Closed, manifold, genus 0, on the sphere
+static bool check(const std::vector<Point3D>& v, const std::vector<int>& idx, double radius) {
+    std::unordered_map<uint64_t,int> edges;
+    edges.reserve(idx.size());
+    for (size_t t=0; t<idx.size(); t+=3)
+        for (int k=0; k<3; ++k) {
+            uint64_t a = idx[t+k], b = idx[t+(k+1)%3];
+            ++edges[a < b ? (a << 32 | b) : (b << 32 | a)];
+        }
+    bool ok = true;
+    for (const auto& e : edges) ok &= e.second == 2;
+    long euler = (long)v.size() - (long)edges.size() + (long)(idx.size() / 3);
+    for (const auto& p : v) ok &= std::fabs(std::sqrt(p.x*p.x + p.y*p.y + p.z*p.z) - radius) < 1e-9;
+    return ok && euler == 2;
+}
+
+static std::vector<int> flatten(const Mesh3D& m) {
+    std::vector<int> idx;
+    for (const auto& f : m.faces) idx.insert(idx.end(), f.indices.begin(), f.indices.end());
+    return idx;
+}
+
+int main() {
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+    using clk = std::chrono::steady_clock;
+
+    std::printf("icosphere  verts       recursive ms   MB   arrays ms   MB   mesh ms   ok\n");
+    const Mesh3D base = make_icosahedron(1.0);
+    for (int L=4; L<=8; ++L) {
+        auto t0 = clk::now();
+        Mesh3D rec = subdivide_icosphere(base, L, 1.0);
+        auto t1 = clk::now();
+        std::vector<Point3D> v; std::vector<int> idx;
+        make_icosphere_arrays(L, 1.0, v, idx);
+        auto t2 = clk::now();
+        Mesh3D direct = make_icosphere(L, 1.0);
+        auto t3 = clk::now();
+
+        size_t n = (size_t)1 << L;
+        bool ok = v.size() == 10*n*n + 2 && idx.size() == 60*n*n
+               && rec.vertices.size() == v.size() && rec.faces.size() == idx.size() / 3
+               && check(v, idx, 1.0) && flatten(direct) == idx;
+        std::printf("L=%d  %10zu   %10.1f %6.1f   %9.1f %5.1f   %7.1f   %s\n", L, v.size(),
+                    ms(t0,t1), mesh_mb(rec), ms(t1,t2), flat_mb(v.size(), 0, idx.size()),
+                    ms(t2,t3), ok ? "yes" : "NO");
+    }
+
+    std::printf("\ncube-sphere verts       previous ms   MB   arrays ms   MB   mesh ms   same\n");
+    for (int s : { 32, 128, 512 }) {
+        // Timed one at a time, each result freed before the next
+        double tOld, tArr, tMesh, mbOld;
+        { auto t0 = clk::now(); Mesh3D m = cube_sphere_reference(s, 1.0); tOld = ms(t0, clk::now()); mbOld = mesh_mb(m); }
+        { auto t0 = clk::now(); Mesh3D m = make_cube_sphere(s, 1.0); tMesh = ms(t0, clk::now()); }
+        std::vector<Point3D> v; std::vector<Point2D> uv; std::vector<int> idx;
+        auto t0 = clk::now();
+        make_cube_sphere_arrays(s, 1.0, v, uv, idx);
+        tArr = ms(t0, clk::now());
+
+        Mesh3D old = cube_sphere_reference(s, 1.0);
+        Mesh3D now = make_cube_sphere(s, 1.0);
+        bool same = now.vertices.size() == old.vertices.size() && now.faces.size() == old.faces.size()
+                 && flatten(now) == flatten(old) && flatten(now) == idx;
+        for (size_t i=0; same && i<old.vertices.size(); ++i)
+            same = old.vertices[i].x == v[i].x && old.vertices[i].y == v[i].y && old.vertices[i].z == v[i].z
+                && old.uv[i].x == uv[i].x && old.uv[i].y == uv[i].y;
+        std::printf("s=%-4d %10zu   %10.1f %6.1f   %9.1f %5.1f   %7.1f   %s\n", s, v.size(),
+                    tOld, mbOld, tArr, flat_mb(v.size(), uv.size(), idx.size()), tMesh, same ? "yes" : "NO");
+    }
+    return 0;
+}
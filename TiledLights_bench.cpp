@@ -0,0 +1,79 @@
+/*
+Forward+ scaling benchmark: 1..1024 short-range point lights over a 32x32
+block of cubes, Phong shaded, in two meshings of the same kind of scene:
+
+  cube grid : make_cube_grid, 1x1 faces (small triangles)
+  merged    : make_cube_grid_merged terrain, greedy-merged faces spanning
+              up to 8x8 cells (large triangles)
+
+  per-triangle : lights range-culled against each triangle's bounding sphere
+  tiled        : render_depth() prepass, lights binned per 16x16 screen tile,
+                 Phong reads only its tile's list
+
+Times are the best of 3 frames.
+*/
+
+#include "MeshBuilders.hpp"
+#include "MeshRenderer2D.hpp"
+#include "View3DParameters.hpp"
+#include "RasterBuffer.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+int main() {
+    View3DParameters params(Point3D(16,18,-14), Point3D(16,0,16), Point3D(0,1,0),
+                            60.0*M_PI/180.0, 1.0, 0.1, 200.0);
+    View3D cam = params.make_view();
+    Projection3D proj = params.make_projection();
+
+    Transformation3D V = cam.view_matrix();
+    RasterBuffer<uint8_t> rb(512, 512, 3, 0, true);
+    MeshRenderer2D renderer(rb, cam, proj);
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    std::vector<Light> all;
+    for (int i=0;i<1024;++i) {
+        Point3D pos = V.apply(Point3D(U(rng)*32.0, 1.2 + U(rng), U(rng)*32.0));
+        all.push_back(Light::point(pos, Point3D(U(rng), U(rng), U(rng)), 2.5));
+    }
+
+    auto ms = [](auto t0, auto t1) {
+        return std::chrono::duration<double, std::milli>(t1 - t0).count();
+    };
+
+    auto run = [&](const char* name, Mesh3D mesh) {
+        for (auto& p : mesh.vertices) p = V.apply(p);
+        auto vnorm = mesh.compute_vertex_normals();
+        std::printf("%s: %zu faces, %zu triangles\n", name, mesh.faces.size(), mesh.triangulation().tris.size());
+        std::printf("%6s %14s %10s %12s\n", "lights", "per-tri(ms)", "tiled(ms)", "lights/tile");
+        for (int n=1; n<=1024; n*=2) {
+            renderer.lights.assign(all.begin(), all.begin()+n);
+            double perTri = 1e300, tiled = 1e300;
+            for (int rep=0; rep<3; ++rep) {
+                renderer.tiledLighting = false;
+                rb.clear_depth(); rb.data.assign(rb.data.size(),0);
+                auto t0 = std::chrono::steady_clock::now();
+                renderer.render(mesh, vnorm, RenderMode::Phong);
+                auto t1 = std::chrono::steady_clock::now();
+
+                renderer.tiledLighting = true;
+                rb.clear_depth(); rb.data.assign(rb.data.size(),0);
+                auto t2 = std::chrono::steady_clock::now();
+                renderer.render_depth(mesh);
+                renderer.render(mesh, vnorm, RenderMode::Phong);
+                auto t3 = std::chrono::steady_clock::now();
+                perTri = std::min(perTri, ms(t0,t1));
+                tiled  = std::min(tiled,  ms(t2,t3));
+            }
+            std::printf("%6d %14.2f %10.2f %12.2f\n", n, perTri, tiled,
+                        renderer.tileGrid.mean_lights_per_tile());
+        }
+    };
+
+    run("cube grid", make_cube_grid(32, 32, 1.0, 1.0, 1.0, 0.0));
+    run("merged", make_cube_grid_merged(32, 32, [](int i, int j) { return 1 + (i/8 + j/8) % 2; }));
+    rb.save_ppm("tiled_lights.ppm");
+    return 0;
+}
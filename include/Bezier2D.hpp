@@ -1,42 +1,220 @@
 #pragma once
 #include "Point2D.hpp"
-#include <vector>
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <vector>
 
 class Bezier2D {
 public:
     // Evaluate quadratic Bezier at t in [0,1]
     static Point2D quad(const Point2D& p0, const Point2D& p1, const Point2D& p2, double t) {
         double u = 1.0 - t;
-        return p0*(u*u) + p1*(2*u*t) + p2*(t*t);
+        double b0 = u*u, b1 = 2.0*u*t, b2 = t*t;
+        return Point2D(b0*p0.x + b1*p1.x + b2*p2.x, b0*p0.y + b1*p1.y + b2*p2.y);
     }
 
     // Evaluate cubic Bezier at t in [0,1]
     static Point2D cubic(const Point2D& p0, const Point2D& p1, const Point2D& p2, const Point2D& p3, double t) {
         double u = 1.0 - t;
         double u2 = u*u, t2 = t*t;
-        double u3 = u2*u, t3 = t2*t;
-        return p0*u3 + p1*(3*u2*t) + p2*(3*u*t2) + p3*t3;
+        double b0 = u2*u, b1 = 3.0*u2*t, b2 = 3.0*u*t2, b3 = t2*t;
+        return Point2D(b0*p0.x + b1*p1.x + b2*p2.x + b3*p3.x,
+                       b0*p0.y + b1*p1.y + b2*p2.y + b3*p3.y);
     }
 
     // Tesselate to polyline with N+1 points (including endpoints)
     static std::vector<Point2D> tesselate_quadratic(const Point2D& p0, const Point2D& p1, const Point2D& p2, int segments) {
-        std::vector<Point2D> out;
-        out.reserve(segments+1);
-        for (int i=0; i<=segments; ++i) {
-            double t = (segments==0) ? 0.0 : static_cast<double>(i)/segments;
-            out.push_back(quad(p0,p1,p2,t));
-        }
+        std::vector<Point2D> out(std::max(segments, 0) + 1);
+        forward_diff_quadratic(p0, p1, p2, segments, out.data());
         return out;
     }
 
     static std::vector<Point2D> tesselate_cubic(const Point2D& p0, const Point2D& p1, const Point2D& p2, const Point2D& p3, int segments) {
-        std::vector<Point2D> out;
-        out.reserve(segments+1);
-        for (int i=0; i<=segments; ++i) {
-            double t = (segments==0) ? 0.0 : static_cast<double>(i)/segments;
-            out.push_back(cubic(p0,p1,p2,p3,t));
-        }
+        std::vector<Point2D> out(std::max(segments, 0) + 1);
+        forward_diff_cubic(p0, p1, p2, p3, segments, out.data());
         return out;
     }
+
+    // Forward differencing: write segments+1 evenly spaced points to `out`
+    // (caller-owned, no allocation). After setup each point costs 2 (quad)
+    // or 3 (cubic) additions per coordinate. The last point is set to the
+    // end point exactly, so rounding drift never opens a gap between curves.
+    static void forward_diff_quadratic(const Point2D& p0, const Point2D& p1, const Point2D& p2,
+                                       int segments, Point2D* out) {
+        out[0] = p0;
+        if (segments <= 0) return;
+        double h = 1.0 / segments, h2 = h*h;
+        // B(t) = p0 + b*t + a*t^2
+        double ax = p0.x - 2.0*p1.x + p2.x, ay = p0.y - 2.0*p1.y + p2.y;
+        double bx = 2.0*(p1.x - p0.x),      by = 2.0*(p1.y - p0.y);
+        double x = p0.x, y = p0.y;
+        double dx = ax*h2 + bx*h, dy = ay*h2 + by*h;
+        double ddx = 2.0*ax*h2,   ddy = 2.0*ay*h2;
+        for (int i=1; i<segments; ++i) {
+            x += dx; y += dy;
+            dx += ddx; dy += ddy;
+            out[i].x = x; out[i].y = y;
+        }
+        out[segments] = p2;
+    }
+
+    static void forward_diff_cubic(const Point2D& p0, const Point2D& p1, const Point2D& p2, const Point2D& p3,
+                                   int segments, Point2D* out) {
+        out[0] = p0;
+        if (segments <= 0) return;
+        double h = 1.0 / segments, h2 = h*h, h3 = h2*h;
+        // B(t) = p0 + c*t + b*t^2 + a*t^3
+        double ax = p3.x - p0.x + 3.0*(p1.x - p2.x), ay = p3.y - p0.y + 3.0*(p1.y - p2.y);
+        double bx = 3.0*(p0.x - 2.0*p1.x + p2.x),    by = 3.0*(p0.y - 2.0*p1.y + p2.y);
+        double cx = 3.0*(p1.x - p0.x),               cy = 3.0*(p1.y - p0.y);
+        double x = p0.x, y = p0.y;
+        double dx = ax*h3 + bx*h2 + cx*h,  dy = ay*h3 + by*h2 + cy*h;
+        double ddx = 6.0*ax*h3 + 2.0*bx*h2, ddy = 6.0*ay*h3 + 2.0*by*h2;
+        double dddx = 6.0*ax*h3,           dddy = 6.0*ay*h3;
+        for (int i=1; i<segments; ++i) {
+            x += dx; y += dy;
+            dx += ddx; dy += ddy;
+            ddx += dddx; ddy += dddy;
+            out[i].x = x; out[i].y = y;
+        }
+        out[segments] = p3;
+    }
+
+    // Many curves of one degree (N control points) in SoA layout, for
+    // tessellating thousands of curves per frame:
+    //
+    //   Bezier2D::Batch<4> batch;            // cubics
+    //   batch.add(p0, p1, p2, p3);  ...
+    //   Bezier2D::evaluate(batch, 16, xs, ys);
+    //   // point s of curve i: (xs[s*batch.size() + i], ys[s*batch.size() + i])
+    template<int N>
+    struct Batch {
+        std::vector<double> x[N], y[N];      // x[k][i]: control point k of curve i
+
+        size_t size() const { return x[0].size(); }
+        void clear() { for (int k=0; k<N; ++k) { x[k].clear(); y[k].clear(); } }
+
+        template<typename... P>
+        void add(const P&... pts) {
+            static_assert(sizeof...(P) == N, "one point per control point");
+            const Point2D* p[N] = { &pts... };
+            for (int k=0; k<N; ++k) { x[k].push_back(p[k]->x); y[k].push_back(p[k]->y); }
+        }
+    };
+
+    // Evaluate every curve of a batch at segments+1 even steps. The Bernstein
+    // weights of a step are shared by all curves, so the inner loop runs
+    // across curves with N multiply-adds per coordinate and no dependency
+    // between iterations, which the compiler vectorizes. outX/outY are
+    // resized to (segments+1)*size() and allocate nothing once grown.
+    template<int N>
+    static void evaluate(const Batch<N>& b, int segments,
+                         std::vector<double>& outX, std::vector<double>& outY) {
+        static_assert(N >= 2 && N <= 4, "linear, quadratic or cubic");
+        const size_t n = b.size();
+        segments = std::max(segments, 1);
+        outX.resize((size_t)(segments + 1) * n);
+        outY.resize((size_t)(segments + 1) * n);
+        for (int s=0; s<=segments; ++s) {
+            double w[N];
+            bernstein<N>((double)s / segments, w);
+            eval_row<N>(b.x, w, n, &outX[(size_t)s * n]);
+            eval_row<N>(b.y, w, n, &outY[(size_t)s * n]);
+        }
+    }
+
+    // Flattening to a pixel tolerance: append a polyline that stays within
+    // `tolerance` of the curve, with as few points as the method allows.
+    // p0 itself is not appended (it ends whatever came before), so curves
+    // chain; push it first when starting a polyline. Returns the number of
+    // points appended. Reuse `out` and nothing is allocated once it has grown.
+
+    // A quadratic's second derivative is constant, so uniform steps are
+    // already optimal: the chord over a step dt strays by at most
+    // |p0 - 2p1 + p2| * dt^2 / 4, which gives the count directly.
+    static size_t flatten_quadratic(const Point2D& p0, const Point2D& p1, const Point2D& p2,
+                                    double tolerance, std::vector<Point2D>& out) {
+        double ddx = p0.x - 2.0*p1.x + p2.x, ddy = p0.y - 2.0*p1.y + p2.y;
+        double dd = std::sqrt(ddx*ddx + ddy*ddy);
+        double n_ = std::ceil(std::sqrt(dd / (4.0 * std::max(tolerance, 1e-6))));
+        int n = (int)std::min(std::max(n_, 1.0), (double)kMaxSegments);
+
+        // Power basis: B(t) = p0 + b*t + a*t^2
+        double bx = 2.0*(p1.x - p0.x), by = 2.0*(p1.y - p0.y);
+        double inv = 1.0 / n;
+        for (int i=1; i<n; ++i) {
+            double t = i * inv;
+            out.emplace_back(p0.x + t*(bx + t*ddx), p0.y + t*(by + t*ddy));
+        }
+        out.push_back(p2);
+        return (size_t)n;
+    }
+
+    // Cubics bend unevenly, so they are split adaptively (de Casteljau at
+    // t = 1/2) until each piece passes a flatness test that bounds its
+    // distance from the chord; flat stretches end up as single segments.
+    static size_t flatten_cubic(const Point2D& p0, const Point2D& p1, const Point2D& p2, const Point2D& p3,
+                                double tolerance, std::vector<Point2D>& out) {
+        const double tol2 = 16.0 * std::max(tolerance, 1e-6) * std::max(tolerance, 1e-6);
+        struct Piece { double x[4], y[4]; int depth; };
+        std::array<Piece, kMaxDepth + 2> stack;     // depth-first: left half on top
+        int top = 0;
+        stack[top++] = { { p0.x, p1.x, p2.x, p3.x }, { p0.y, p1.y, p2.y, p3.y }, 0 };
+        size_t emitted = 0;
+        while (top > 0) {
+            Piece c = stack[--top];
+            double ux = 3.0*c.x[1] - 2.0*c.x[0] - c.x[3], uy = 3.0*c.y[1] - 2.0*c.y[0] - c.y[3];
+            double vx = 3.0*c.x[2] - c.x[0] - 2.0*c.x[3], vy = 3.0*c.y[2] - c.y[0] - 2.0*c.y[3];
+            double flat = std::max(ux*ux, vx*vx) + std::max(uy*uy, vy*vy);
+            if (flat <= tol2 || c.depth >= kMaxDepth) {
+                out.emplace_back(c.x[3], c.y[3]);
+                ++emitted;
+                continue;
+            }
+            Piece l, r;
+            l.depth = r.depth = c.depth + 1;
+            split_half(c.x, l.x, r.x);
+            split_half(c.y, l.y, r.y);
+            stack[top++] = r;
+            stack[top++] = l;
+        }
+        return emitted;
+    }
+
+private:
+    static constexpr int kMaxSegments = 1 << 16;   // quadratic step cap
+    static constexpr int kMaxDepth    = 16;        // cubic subdivision cap
+
+    template<int N>
+    static void bernstein(double t, double* w) {
+        double u = 1.0 - t;
+        if constexpr (N == 2) { w[0] = u; w[1] = t; }
+        if constexpr (N == 3) { w[0] = u*u; w[1] = 2.0*u*t; w[2] = t*t; }
+        if constexpr (N == 4) { w[0] = u*u*u; w[1] = 3.0*u*u*t; w[2] = 3.0*u*t*t; w[3] = t*t*t; }
+    }
+
+    template<int N>
+    static void eval_row(const std::vector<double>* c, const double* w, size_t n, double* __restrict out) {
+        const double* __restrict c0 = c[0].data();
+        const double* __restrict c1 = c[1].data();
+        const double* __restrict c2 = c[N > 2 ? 2 : 1].data();
+        const double* __restrict c3 = c[N > 3 ? 3 : 1].data();
+        const double w0 = w[0], w1 = w[1];
+        const double w2 = N > 2 ? w[2] : 0.0, w3 = N > 3 ? w[3] : 0.0;
+        for (size_t i=0; i<n; ++i) {
+            double v = w0*c0[i] + w1*c1[i];
+            if (N > 2) v += w2*c2[i];
+            if (N > 3) v += w3*c3[i];
+            out[i] = v;
+        }
+    }
+
+    static void split_half(const double* c, double* l, double* r) {
+        double m01 = 0.5*(c[0] + c[1]), m12 = 0.5*(c[1] + c[2]), m23 = 0.5*(c[2] + c[3]);
+        double m012 = 0.5*(m01 + m12), m123 = 0.5*(m12 + m23);
+        double mid = 0.5*(m012 + m123);
+        l[0] = c[0]; l[1] = m01;  l[2] = m012; l[3] = mid;
+        r[0] = mid;  r[1] = m123; r[2] = m23;  r[3] = c[3];
+    }
 };
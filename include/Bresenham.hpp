@@ -1,21 +1,148 @@
 #pragma once
 #include "RasterBuffer.hpp"
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <vector>
 
 namespace Bresenham {
 
-inline void line(RasterBuffer<uint8_t>& rb, int x0, int y0, int x1, int y1, uint8_t color=255) {
-    int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
-    int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
-    int err = dx + dy;
-    for (;;) {
-        rb.set_pixel(x0,y0,color);
-        if (x0 == x1 && y0 == y1) break;
-        int e2 = 2*err;
-        if (e2 >= dy) { err += dy; x0 += sx; }
-        if (e2 <= dx) { err += dx; y0 += sy; }
+// Pixels [x0,x1) x [y0,y1); always intersected with the buffer's clip
+using ClipRect = PixelRect;
+
+inline ClipRect full(const RasterBuffer<uint8_t>& rb) { return rb.clip; }
+
+namespace detail {
+
+inline int64_t floor_div(int64_t a, int64_t b) { int64_t q = a / b; return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q; }
+inline int64_t ceil_div(int64_t a, int64_t b)  { return -floor_div(-a, b); }
+
+// C = channel count known at compile time, 0 = use rb.channels
+template<int C>
+inline void put(uint8_t* p, const uint8_t* v, int channels) {
+    if (C == 0) std::copy_n(v, channels, p);
+    else for (int c=0; c<C; ++c) p[c] = v[c];
+}
+
+// The line is walked along its major axis, step i = 0..amaj, with the
+// minor offset q(i) = floor((2*i*amin + amaj) / (2*amaj)), i.e. i*amin/amaj
+// rounded. Both axes are monotonic in i, so the clip rectangle maps to one
+// range of steps, found in closed form before the loop. The loop then runs
+// only over visible pixels and writes through a pointer, unchecked.
+template<int C>
+void line(RasterBuffer<uint8_t>& rb, const ClipRect& clip,
+          int x0, int y0, int x1, int y1, const uint8_t* v) {
+    const int xmin = std::max(clip.x0, rb.clip.x0), xmax = std::min(clip.x1, rb.clip.x1) - 1;
+    const int ymin = std::max(clip.y0, rb.clip.y0), ymax = std::min(clip.y1, rb.clip.y1) - 1;
+    if (xmin > xmax || ymin > ymax) return;
+
+    const int ch = (C == 0) ? rb.channels : C;
+    const ptrdiff_t rowStep = (ptrdiff_t)rb.width * ch;
+    uint8_t* data = rb.data.data();
+    auto at = [&](int x, int y) { return data + ((size_t)y * rb.width + x) * ch; };
+
+    // Horizontal and vertical lines: one clipped run
+    if (y0 == y1) {
+        if (y0 < ymin || y0 > ymax) return;
+        int a = std::max(std::min(x0, x1), xmin), b = std::min(std::max(x0, x1), xmax);
+        if (a > b) return;
+        uint8_t* p = at(a, y0);
+        if (ch == 1) { std::memset(p, v[0], (size_t)(b - a + 1)); return; }
+        for (int x=a; x<=b; ++x, p+=ch) put<C>(p, v, ch);
+        return;
     }
+    if (x0 == x1) {
+        if (x0 < xmin || x0 > xmax) return;
+        int a = std::max(std::min(y0, y1), ymin), b = std::min(std::max(y0, y1), ymax);
+        if (a > b) return;
+        uint8_t* p = at(x0, a);
+        for (int y=a; y<=b; ++y, p+=rowStep) put<C>(p, v, ch);
+        return;
+    }
+
+    const int sx = x1 > x0 ? 1 : -1, sy = y1 > y0 ? 1 : -1;
+    const int64_t adx = std::abs((int64_t)x1 - x0), ady = std::abs((int64_t)y1 - y0);
+    const bool xMajor = adx >= ady;
+    const int64_t amaj = xMajor ? adx : ady, amin = xMajor ? ady : adx;
+    const int maj0 = xMajor ? x0 : y0,  min0 = xMajor ? y0 : x0;
+    const int smaj = xMajor ? sx : sy,  smin = xMajor ? sy : sx;
+    const int majLo = xMajor ? xmin : ymin, majHi = xMajor ? xmax : ymax;
+    const int minLo = xMajor ? ymin : xmin, minHi = xMajor ? ymax : xmax;
+
+    int64_t iLo = 0, iHi = amaj, num = amaj;
+    int64_t majS = maj0, minS = min0;
+    const bool inside = std::min(x0, x1) >= xmin && std::max(x0, x1) <= xmax &&
+                        std::min(y0, y1) >= ymin && std::max(y0, y1) <= ymax;
+    if (!inside) {
+        // Steps whose major coordinate is inside
+        if (smaj > 0) { iLo = std::max<int64_t>(iLo, majLo - maj0); iHi = std::min<int64_t>(iHi, majHi - maj0); }
+        else          { iLo = std::max<int64_t>(iLo, maj0 - majHi); iHi = std::min<int64_t>(iHi, maj0 - majLo); }
+        // ... and whose minor offset is in [qa,qb]:
+        //   q(i) >= qa  <=>  i >= ceil((2*amaj*qa - amaj) / (2*amin))
+        //   q(i) <= qb  <=>  i <  (2*amaj*(qb+1) - amaj) / (2*amin)
+        const int64_t qa = smin > 0 ? (int64_t)minLo - min0 : (int64_t)min0 - minHi;
+        const int64_t qb = smin > 0 ? (int64_t)minHi - min0 : (int64_t)min0 - minLo;
+        iLo = std::max(iLo, ceil_div(2*amaj*qa - amaj, 2*amin));
+        iHi = std::min(iHi, ceil_div(2*amaj*(qb + 1) - amaj, 2*amin) - 1);
+        if (iLo > iHi) return;
+
+        // Error term at the first visible step
+        num = 2*iLo*amin + amaj;
+        const int64_t q = floor_div(num, 2*amaj);
+        num -= q * 2*amaj;
+        majS = maj0 + smaj * iLo;
+        minS = min0 + smin * q;
+    }
+    uint8_t* p = xMajor ? at((int)majS, (int)minS) : at((int)minS, (int)majS);
+    const ptrdiff_t majStep = xMajor ? (ptrdiff_t)sx * ch : sy * rowStep;
+    const ptrdiff_t minStep = xMajor ? sy * rowStep : (ptrdiff_t)sx * ch;
+    const int64_t inc = 2*amin, lim = 2*amaj;
+    for (int64_t i=iLo; i<=iHi; ++i) {
+        put<C>(p, v, ch);
+        p += majStep;
+        num += inc;
+        if (num >= lim) { num -= lim; p += minStep; }
+    }
+}
+
+inline void dispatch(RasterBuffer<uint8_t>& rb, const ClipRect& clip,
+                     int x0, int y0, int x1, int y1, const uint8_t* v) {
+    switch (rb.channels) {
+        case 1:  line<1>(rb, clip, x0, y0, x1, y1, v); break;
+        case 3:  line<3>(rb, clip, x0, y0, x1, y1, v); break;
+        case 4:  line<4>(rb, clip, x0, y0, x1, y1, v); break;
+        default: line<0>(rb, clip, x0, y0, x1, y1, v); break;
+    }
+}
+
+} // namespace detail
+
+// Gray goes to every channel, as set_pixel(x,y,gray) does
+inline void line(RasterBuffer<uint8_t>& rb, const ClipRect& clip,
+                 int x0, int y0, int x1, int y1, uint8_t color=255) {
+    uint8_t v[4] = { color, color, color, color };
+    if (rb.channels > 4) return;
+    detail::dispatch(rb, clip, x0, y0, x1, y1, v);
+}
+
+inline void line(RasterBuffer<uint8_t>& rb, int x0, int y0, int x1, int y1, uint8_t color=255) {
+    line(rb, full(rb), x0, y0, x1, y1, color);
+}
+
+// Color line; a 1-channel buffer gets the average, as set_pixel(x,y,r,g,b)
+inline void line(RasterBuffer<uint8_t>& rb, const ClipRect& clip,
+                 int x0, int y0, int x1, int y1, uint8_t r, uint8_t g, uint8_t b, uint8_t a=255) {
+    uint8_t v[4] = { r, g, b, a };
+    if (rb.channels == 1) v[0] = (uint8_t)((r + g + b) / 3);
+    if (rb.channels > 4) return;
+    detail::dispatch(rb, clip, x0, y0, x1, y1, v);
+}
+
+inline void line(RasterBuffer<uint8_t>& rb, int x0, int y0, int x1, int y1,
+                 uint8_t r, uint8_t g, uint8_t b, uint8_t a=255) {
+    line(rb, full(rb), x0, y0, x1, y1, r, g, b, a);
 }
 
 // Midpoint/Bresenham circle
@@ -47,4 +174,215 @@ inline void circle(RasterBuffer<uint8_t>& rb, int cx, int cy, int radius, uint8_
     }
 }
 
+// --- Filled circles and ellipses ---
+// Drawn as one clipped span per row (RasterBuffer::fill_span), so every
+// pixel is written exactly once.
+
+// Midpoint circle walk reporting each row offset dy = 0..r once with the
+// half width of the disc on that row. Rows ±y come from the walk itself;
+// rows ±x are reported when the walk leaves column x, at the widest y seen.
+template<typename RowFn>
+inline void circle_rows(int radius, RowFn&& row) {
+    if (radius < 0) return;
+    int x = radius, y = 0, err = 1 - radius;
+    while (x >= y) {
+        row(y, x);
+        int yPrev = y;
+        ++y;
+        if (err < 0) {
+            err += 2*y + 1;
+        } else {
+            if (x > yPrev) row(x, yPrev);
+            --x;
+            err += 2*(y - x + 1);
+        }
+    }
+}
+
+// Rows of an axis-aligned ellipse: the widest dx with
+// (dx/(rx+1/2))^2 + (dy/(ry+1/2))^2 <= 1, tracked incrementally (no sqrt)
+template<typename RowFn>
+inline void ellipse_rows(int rx, int ry, RowFn&& row) {
+    if (rx < 0 || ry < 0) return;
+    const int64_t A = (int64_t)(2*rx + 1) * (2*rx + 1), B = (int64_t)(2*ry + 1) * (2*ry + 1);
+    int64_t dx = rx;
+    for (int64_t dy=0; dy<=ry; ++dy) {
+        while (dx > 0 && 4*dx*dx*B + 4*dy*dy*A > A*B) --dx;
+        row((int)dy, (int)dx);
+    }
+}
+
+inline void fill_circle(RasterBuffer<uint8_t>& rb, int cx, int cy, int radius, uint8_t color=255) {
+    circle_rows(radius, [&](int dy, int hw) {
+        rb.fill_span(cy + dy, cx - hw, cx + hw + 1, color);
+        if (dy) rb.fill_span(cy - dy, cx - hw, cx + hw + 1, color);
+    });
+}
+
+inline void fill_circle(RasterBuffer<uint8_t>& rb, int cx, int cy, int radius,
+                        uint8_t r, uint8_t g, uint8_t b, uint8_t a=255) {
+    circle_rows(radius, [&](int dy, int hw) {
+        rb.fill_span(cy + dy, cx - hw, cx + hw + 1, r, g, b, a);
+        if (dy) rb.fill_span(cy - dy, cx - hw, cx + hw + 1, r, g, b, a);
+    });
+}
+
+inline void fill_ellipse(RasterBuffer<uint8_t>& rb, int cx, int cy, int rx, int ry, uint8_t color=255) {
+    ellipse_rows(rx, ry, [&](int dy, int hw) {
+        rb.fill_span(cy + dy, cx - hw, cx + hw + 1, color);
+        if (dy) rb.fill_span(cy - dy, cx - hw, cx + hw + 1, color);
+    });
+}
+
+inline void fill_ellipse(RasterBuffer<uint8_t>& rb, int cx, int cy, int rx, int ry,
+                         uint8_t r, uint8_t g, uint8_t b, uint8_t a=255) {
+    ellipse_rows(rx, ry, [&](int dy, int hw) {
+        rb.fill_span(cy + dy, cx - hw, cx + hw + 1, r, g, b, a);
+        if (dy) rb.fill_span(cy - dy, cx - hw, cx + hw + 1, r, g, b, a);
+    });
+}
+
+// Row table and band order of fill_circles; keep one with the caller to
+// reuse its memory between calls
+struct CircleScratch {
+    std::vector<int>      half;
+    std::vector<uint32_t> start, order;
+};
+
+// Many discs of one radius and color in one call. The row table is built
+// once, discs are visited in bands of 16 rows (same color, so the order is
+// free) to keep writes local, and discs fully inside the clip skip
+// clipping altogether.
+inline void fill_circles(RasterBuffer<uint8_t>& rb, const int* cx, const int* cy, size_t n,
+                         int radius, uint8_t color, CircleScratch& scratch) {
+    if (radius < 0 || n == 0) return;
+    std::vector<int>& half = scratch.half;
+    half.resize(radius + 1);
+    circle_rows(radius, [&](int dy, int hw) { half[dy] = hw; });
+
+    // Counting sort by band; off-target centers go to the first/last band
+    const int bands = (rb.height >> 4) + 1;
+    std::vector<uint32_t>& start = scratch.start;
+    std::vector<uint32_t>& order = scratch.order;
+    start.assign(bands + 1, 0);
+    order.resize(n);
+    auto band = [&](int y) { return std::min(std::max(y, 0), rb.height) >> 4; };
+    for (size_t i=0; i<n; ++i) ++start[band(cy[i]) + 1];
+    for (int b=0; b<bands; ++b) start[b + 1] += start[b];
+    for (size_t i=0; i<n; ++i) order[start[band(cy[i])]++] = (uint32_t)i;
+
+    const int ch = rb.channels;
+    const size_t stride = (size_t)rb.width * ch;
+    for (uint32_t i : order) {
+        const int x = cx[i], y = cy[i];
+        if (x - radius >= rb.clip.x0 && x + radius < rb.clip.x1 &&
+            y - radius >= rb.clip.y0 && y + radius < rb.clip.y1) {
+            uint8_t* mid = &rb.data[((size_t)y * rb.width + x) * ch];
+            for (int dy=0; dy<=radius; ++dy) {
+                const size_t len = (size_t)(2*half[dy] + 1) * ch;
+                std::fill_n(mid + dy*stride - (size_t)half[dy]*ch, len, color);
+                if (dy) std::fill_n(mid - dy*stride - (size_t)half[dy]*ch, len, color);
+            }
+            continue;
+        }
+        for (int dy=0; dy<=radius; ++dy) {
+            rb.fill_span(y + dy, x - half[dy], x + half[dy] + 1, color);
+            if (dy) rb.fill_span(y - dy, x - half[dy], x + half[dy] + 1, color);
+        }
+    }
+}
+
+inline void fill_circles(RasterBuffer<uint8_t>& rb, const int* cx, const int* cy, size_t n,
+                         int radius, uint8_t color=255) {
+    CircleScratch scratch;
+    fill_circles(rb, cx, cy, n, radius, color, scratch);
+}
+
+// --- Anti-aliased (Wu) outlines ---
+// Along the major axis of each octant the exact curve crosses between two
+// pixels, which share the intensity by distance. Pixels are blended over
+// what is there: p += (color - p) * coverage.
+
+namespace detail {
+
+inline void blend(RasterBuffer<uint8_t>& rb, int x, int y, const uint8_t* v, double cov) {
+    if (!rb.in_clip(x, y) || cov <= 0.0) return;
+    uint8_t* p = &rb.data[((size_t)y * rb.width + x) * rb.channels];
+    const int ch = std::min(rb.channels, 4);
+    for (int c=0; c<ch; ++c) p[c] = (uint8_t)(p[c] + (v[c] - p[c]) * cov + 0.5);
+}
+
+// (±x, ±y) without repeating a pixel when x or y is 0
+inline void blend4(RasterBuffer<uint8_t>& rb, int cx, int cy, int x, int y, const uint8_t* v, double cov) {
+    blend(rb, cx + x, cy + y, v, cov);
+    if (x) blend(rb, cx - x, cy + y, v, cov);
+    if (y) blend(rb, cx + x, cy - y, v, cov);
+    if (x && y) blend(rb, cx - x, cy - y, v, cov);
+}
+
+inline void circle_aa(RasterBuffer<uint8_t>& rb, int cx, int cy, double radius, const uint8_t* v) {
+    if (radius <= 0.0) return;
+    const double r2 = radius * radius;
+    // Octant x in [0, r/sqrt2]: exact y = sqrt(r^2 - x^2) >= x
+    for (int x=0; x <= (int)(radius / std::sqrt(2.0)); ++x) {
+        double y = std::sqrt(r2 - (double)x * x);
+        int y0 = (int)std::floor(y);
+        double f = y - y0;
+        for (int k=0; k<2; ++k) {
+            int yy = y0 + k;
+            double cov = k ? f : 1.0 - f;
+            blend4(rb, cx, cy, x, yy, v, cov);
+            if (yy != x) blend4(rb, cx, cy, yy, x, v, cov);   // mirror across the diagonal
+        }
+    }
+}
+
+inline void ellipse_aa(RasterBuffer<uint8_t>& rb, int cx, int cy, double rx, double ry, const uint8_t* v) {
+    if (rx <= 0.0 || ry <= 0.0) return;
+    // Where the slope is 1 splits x-major from y-major
+    const double d = std::sqrt(rx*rx + ry*ry);
+    const int xEnd = (int)(rx*rx / d), yEnd = (int)(ry*ry / d);
+    for (int x=0; x<=xEnd; ++x) {
+        double y = ry * std::sqrt(std::max(0.0, 1.0 - (x*x) / (rx*rx)));
+        int y0 = (int)std::floor(y);
+        double f = y - y0;
+        blend4(rb, cx, cy, x, y0, v, 1.0 - f);
+        blend4(rb, cx, cy, x, y0 + 1, v, f);
+    }
+    for (int y=0; y<=yEnd; ++y) {
+        double x = rx * std::sqrt(std::max(0.0, 1.0 - (y*y) / (ry*ry)));
+        int x0 = (int)std::floor(x);
+        if (x0 <= xEnd) continue;   // already covered by the x-major half
+        double f = x - x0;
+        blend4(rb, cx, cy, x0, y, v, 1.0 - f);
+        blend4(rb, cx, cy, x0 + 1, y, v, f);
+    }
+}
+
+} // namespace detail
+
+inline void circle_aa(RasterBuffer<uint8_t>& rb, int cx, int cy, double radius, uint8_t color=255) {
+    const uint8_t v[4] = { color, color, color, color };
+    detail::circle_aa(rb, cx, cy, radius, v);
+}
+
+inline void circle_aa(RasterBuffer<uint8_t>& rb, int cx, int cy, double radius,
+                      uint8_t r, uint8_t g, uint8_t b, uint8_t a=255) {
+    uint8_t v[4] = { r, g, b, a };
+    if (rb.channels == 1) v[0] = (uint8_t)((r + g + b) / 3);
+    detail::circle_aa(rb, cx, cy, radius, v);
+}
+
+inline void ellipse_aa(RasterBuffer<uint8_t>& rb, int cx, int cy, double rx, double ry, uint8_t color=255) {
+    const uint8_t v[4] = { color, color, color, color };
+    detail::ellipse_aa(rb, cx, cy, rx, ry, v);
+}
+
+inline void ellipse_aa(RasterBuffer<uint8_t>& rb, int cx, int cy, double rx, double ry,
+                       uint8_t r, uint8_t g, uint8_t b, uint8_t a=255) {
+    uint8_t v[4] = { r, g, b, a };
+    if (rb.channels == 1) v[0] = (uint8_t)((r + g + b) / 3);
+    detail::ellipse_aa(rb, cx, cy, rx, ry, v);
+}
+
 } // namespace
@@ -1,18 +1,84 @@
 #pragma once
 #include "IGraphicObject2D.hpp"
+#include "DamageRegion.hpp"
+#include <algorithm>
 #include <memory>
 #include <vector>
 
+// A group of objects, drawn in order. Used as a scene root it also tracks
+// damage: add/remove/modify mark the affected pixels, and redraw() repaints
+// only those rectangles instead of the whole target.
+//
+//   scene.modify(marker, [&] { marker->p = Point2D(x, y); });
+//   DamageRegion d = scene.redraw(rb);
+//   rb.save_ppm("frame_part.ppm", d.bounds());
 class CompoundGraphicObject2D : public IGraphicObject2D {
 public:
     void add(std::shared_ptr<IGraphicObject2D> obj) {
+        if (obj) invalidate(obj->bounds());
         children.push_back(std::move(obj));
     }
 
+    void remove(const std::shared_ptr<IGraphicObject2D>& obj) {
+        auto it = std::find(children.begin(), children.end(), obj);
+        if (it == children.end()) return;
+        if (obj) invalidate(obj->bounds());
+        children.erase(it);
+    }
+
+    // Change a child in place: its area before and after is marked dirty
+    template<typename Fn>
+    void modify(const std::shared_ptr<IGraphicObject2D>& obj, Fn&& change) {
+        invalidate(obj->bounds());
+        change();
+        invalidate(obj->bounds());
+    }
+
+    void invalidate(const PixelRect& r) { dirty.add(r); }
+    const DamageRegion& damage() const { return dirty; }
+
     void draw(RasterBuffer<uint8_t>& rb, uint8_t intensity=255) const override {
         for (const auto& ch : children) ch->draw(rb, intensity);
     }
 
+    PixelRect bounds() const override {
+        PixelRect r;
+        for (const auto& ch : children) r = r.united(ch->bounds());
+        return r;
+    }
+
+    // Clear each damaged rect (within rb) to `background`, then draw every
+    // child that overlaps one, with rb's clip set to that rect. Children
+    // stay the outer loop, so where rects overlap the drawing order is
+    // still the tree order. Returns the repainted region, clipped to rb,
+    // and starts collecting a new one.
+    DamageRegion redraw(RasterBuffer<uint8_t>& rb, uint8_t intensity=255, uint8_t background=0) {
+        DamageRegion done;
+        const PixelRect old = rb.clip;
+        const PixelRect full{ 0, 0, rb.width, rb.height };
+        for (const PixelRect& d : dirty.rects()) done.add(d.intersected(full));
+        for (const PixelRect& r : done.rects()) {
+            rb.set_clip(r);
+            for (int y=r.y0; y<r.y1; ++y) rb.fill_span(y, r.x0, r.x1, background);
+        }
+        const PixelRect all = done.bounds();
+        for (const auto& ch : children) {
+            const PixelRect b = ch->bounds();
+            if (!b.intersects(all)) continue;
+            for (const PixelRect& r : done.rects()) {
+                if (!b.intersects(r)) continue;
+                rb.set_clip(r);
+                ch->draw(rb, intensity);
+            }
+        }
+        rb.clip = old;
+        dirty.clear();
+        return done;
+    }
+
+    const std::vector<std::shared_ptr<IGraphicObject2D>>& items() const { return children; }
+
 private:
     std::vector<std::shared_ptr<IGraphicObject2D>> children;
+    DamageRegion dirty;
 };
@@ -0,0 +1,52 @@
+#pragma once
+#include "PixelRect.hpp"
+#include <vector>
+
+// Dirty rectangles of a scene. A new rect is merged with any existing one
+// when their bounding box is no bigger than the two areas together (so
+// overlapping or touching damage becomes one rect), and past maxRects
+// everything collapses into the overall bounding box; repaint cost stays
+// bounded either way. Rects may still overlap a little, which only means
+// some pixels are repainted twice.
+class DamageRegion {
+public:
+    size_t maxRects = 16;
+
+    void add(PixelRect r) {
+        if (r.empty()) return;
+        for (size_t i=0; i<list.size(); ) {
+            PixelRect u = list[i].united(r);
+            if (u.area() <= list[i].area() + r.area()) {
+                r = u;
+                list.erase(list.begin() + i);
+                i = 0;                  // the grown rect may now reach others
+            } else {
+                ++i;
+            }
+        }
+        list.push_back(r);
+        if (list.size() > maxRects) {
+            PixelRect b = bounds();
+            list.assign(1, b);
+        }
+    }
+
+    const std::vector<PixelRect>& rects() const { return list; }
+    bool empty() const { return list.empty(); }
+    void clear() { list.clear(); }
+
+    PixelRect bounds() const {
+        PixelRect b;
+        for (const auto& r : list) b = b.united(r);
+        return b;
+    }
+
+    long long area() const {
+        long long a = 0;
+        for (const auto& r : list) a += r.area();
+        return a;
+    }
+
+private:
+    std::vector<PixelRect> list;
+};
@@ -0,0 +1,209 @@
+#pragma once
+#include "Point2D.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+// Triangle setup shared by MeshRenderer2D and the depth-only passes
+// (Z prepass, shadow maps). Everything that decides coverage lives here so
+// a depth-only pass covers exactly the pixels the shading pass will.
+namespace DepthRaster {
+
+// Signed area *2 (helper for winding/backface)
+inline double edge_function(const Point2D& a, const Point2D& b, const Point2D& c) {
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+// Barycentric weights at an arbitrary screen position (x,y)
+inline bool barycentric_at(const std::array<Point2D,3>& S, double area, double x, double y,
+                           double& w0, double& w1, double& w2) {
+    if (area == 0.0) return false;
+    w0 = edge_function(S[1], S[2], Point2D(x,y)) / area;
+    w1 = edge_function(S[2], S[0], Point2D(x,y)) / area;
+    w2 = 1.0 - w0 - w1;
+    return (w0 >= 0.0 && w1 >= 0.0 && w2 >= 0.0);
+}
+
+// Barycentric weights for pixel center (x+0.5,y+0.5); `area` is
+// edge_function(S[0],S[1],S[2]) hoisted out of the pixel loop
+inline bool barycentric(const std::array<Point2D,3>& S, double area, int px, int py,
+                        double& w0, double& w1, double& w2) {
+    return barycentric_at(S, area, px + 0.5, py + 0.5, w0, w1, w2);
+}
+
+// Per-triangle edge setup shared by every rasterizer that has to agree with
+// another one pixel-for-pixel (Z prepass and shading pass). Each edge is
+// evaluated from its lexicographically smaller endpoint, so the two
+// triangles sharing an edge compute exactly opposite values there and no
+// sample on it is lost to rounding. Weights are edge values times
+// 1/|area|: no divide in the pixel loop.
+struct Edges {
+    double lx[3], ly[3], dx[3], dy[3], sgn[3];   // edge i: sgn * ((p-l) x d)
+    double invArea = 0;
+
+    // False for a zero-area triangle
+    bool setup(const std::array<Point2D,3>& S) {
+        double area = edge_function(S[0], S[1], S[2]);
+        if (area == 0.0) return false;
+        invArea = 1.0 / std::abs(area);
+        const double wind = area > 0 ? 1.0 : -1.0;
+        for (int i=0; i<3; ++i) {
+            const Point2D& p = S[(i+1)%3];    // edge opposite vertex i
+            const Point2D& q = S[(i+2)%3];
+            const bool swap = q.x < p.x || (q.x == p.x && q.y < p.y);
+            const Point2D& l = swap ? q : p;
+            const Point2D& h = swap ? p : q;
+            lx[i] = l.x; ly[i] = l.y;
+            dx[i] = h.x - l.x; dy[i] = h.y - l.y;
+            sgn[i] = swap ? -wind : wind;
+        }
+        return true;
+    }
+
+    inline double edge(int i, double x, double y) const {
+        return sgn[i] * (dx[i]*(y - ly[i]) - dy[i]*(x - lx[i]));
+    }
+
+    // Barycentric weights at (x,y); true when inside or on an edge
+    inline bool weights(double x, double y, double& w0, double& w1, double& w2) const {
+        const double e0 = edge(0, x, y), e1 = edge(1, x, y), e2 = edge(2, x, y);
+        w0 = e0 * invArea; w1 = e1 * invArea; w2 = e2 * invArea;
+        return e0 >= 0.0 && e1 >= 0.0 && e2 >= 0.0;
+    }
+
+    // Narrow [x0,x1] to the pixels of row y that can have a sample inside,
+    // for samples at heights y+yLo..y+yHi (just the center by default),
+    // with a pixel of slack each side so rounding never drops one: the
+    // per-sample test still decides. Empty rows come back x0 > x1.
+    void span(int y, int& x0, int& x1, double yLo = 0.5, double yHi = 0.5) const {
+        double lo = x0 + 0.5, hi = x1 + 0.5;
+        for (int i=0; i<3; ++i) {
+            // edge(i, x, py) = a*x + k(py); the bound moves linearly with py
+            const double a = -sgn[i] * dy[i];
+            if (std::abs(a) < 1e-6) continue;           // near-horizontal: no usable bound
+            const double kLo = sgn[i] * (dx[i]*(y + yLo - ly[i]) + dy[i]*lx[i]);
+            const double kHi = sgn[i] * (dx[i]*(y + yHi - ly[i]) + dy[i]*lx[i]);
+            if (a > 0.0) lo = std::max(lo, std::min(-kLo / a, -kHi / a));
+            else         hi = std::min(hi, std::max(-kLo / a, -kHi / a));
+        }
+        if (lo > hi + 2.0) { x1 = x0 - 1; return; }
+        x0 = std::max(x0, (int)std::floor(lo - 0.5) - 1);
+        x1 = std::min(x1, (int)std::ceil(hi - 0.5) + 1);
+    }
+};
+
+// Triangle bounding box clipped to a WxH target
+inline void tri_bounds(const std::array<Point2D,3>& S,
+                       int& minX, int& minY, int& maxX, int& maxY,
+                       int W, int H) {
+    minX = std::max(0, (int)std::floor(std::min({S[0].x, S[1].x, S[2].x})));
+    minY = std::max(0, (int)std::floor(std::min({S[0].y, S[1].y, S[2].y})));
+    maxX = std::min(W-1, (int)std::ceil (std::max({S[0].x, S[1].x, S[2].x})));
+    maxY = std::min(H-1, (int)std::ceil (std::max({S[0].y, S[1].y, S[2].y})));
+}
+
+// Perspective-correct depth (1/z weights); invW = {1,1,1} gives plain
+// linear interpolation, which is what orthographic shadow maps want
+inline double perspective_depth(double w0, double w1, double w2,
+                                const std::array<double,3>& zView,
+                                const std::array<double,3>& invW) {
+    double a0 = w0*invW[0], a1 = w1*invW[1], a2 = w2*invW[2];
+    double iw = a0 + a1 + a2;
+    if (iw <= 1e-12) return w0*zView[0] + w1*zView[1] + w2*zView[2];
+    return (a0*zView[0] + a1*zView[1] + a2*zView[2]) / iw;
+}
+
+// Rasterize one screen-space triangle into a bare depth array (W*H,
+// row-major, smaller = nearer). No color, normals or lights are touched.
+// Either winding is accepted; callers cull beforehand if they want to.
+template<typename DepthT>
+void triangle(DepthT* depth, int W, int H,
+              const std::array<Point2D,3>& S,
+              const std::array<double,3>& zView,
+              const std::array<double,3>& invW) {
+    Edges E;
+    if (!E.setup(S)) return;
+    int minX, minY, maxX, maxY;
+    tri_bounds(S, minX, minY, maxX, maxY, W, H);
+    for (int y=minY; y<=maxY; ++y) {
+        DepthT* row = depth + (size_t)y*W;
+        int x0 = minX, x1 = maxX;
+        E.span(y, x0, x1);
+        for (int x=x0; x<=x1; ++x) {
+            double w0,w1,w2;
+            if (!E.weights(x + 0.5, y + 0.5, w0, w1, w2)) continue;
+            DepthT z = (DepthT)perspective_depth(w0, w1, w2, zView, invW);
+            if (z < row[x]) row[x] = z;
+        }
+    }
+}
+
+// MSAA variant of triangle(): `depth` holds `samples` values per pixel
+// (contiguous per pixel), sample positions from `pattern` as (dx,dy) pairs
+template<typename DepthT>
+void triangle_samples(DepthT* depth, int W, int H, int samples, const float* pattern,
+                      const std::array<Point2D,3>& S,
+                      const std::array<double,3>& zView,
+                      const std::array<double,3>& invW) {
+    Edges E;
+    if (!E.setup(S)) return;
+    int minX, minY, maxX, maxY;
+    tri_bounds(S, minX, minY, maxX, maxY, W, H);
+    for (int y=minY; y<=maxY; ++y) {
+        int x0 = minX, x1 = maxX;
+        E.span(y, x0, x1, 0.0, 1.0);
+        for (int x=x0; x<=x1; ++x) {
+            DepthT* px = depth + ((size_t)y*W + x)*samples;
+            for (int s=0; s<samples; ++s) {
+                double w0,w1,w2;
+                if (!E.weights(x + pattern[2*s], y + pattern[2*s+1], w0, w1, w2)) continue;
+                DepthT z = (DepthT)perspective_depth(w0, w1, w2, zView, invW);
+                if (z < px[s]) px[s] = z;
+            }
+        }
+    }
+}
+
+// Cheaper variant for depth that is linear in screen space (orthographic
+// shadow maps): edge functions and depth are stepped incrementally along
+// each row instead of being re-evaluated per pixel. Coverage matches
+// triangle() up to rounding, so use it only where no shading pass has to
+// agree with it pixel-for-pixel.
+template<typename DepthT>
+void triangle_linear(DepthT* depth, int W, int H,
+                     const std::array<Point2D,3>& S,
+                     const std::array<double,3>& z) {
+    double area = edge_function(S[0], S[1], S[2]);
+    if (area == 0.0) return;
+    int minX, minY, maxX, maxY;
+    tri_bounds(S, minX, minY, maxX, maxY, W, H);
+    if (minX > maxX || minY > maxY) return;
+
+    // Normalized edge functions e_i(x,y) = A_i*x + B_i*y + C_i, e_i >= 0 inside
+    const double inv = 1.0 / area;
+    double A0 = (S[1].y - S[2].y)*inv, B0 = (S[2].x - S[1].x)*inv;
+    double A1 = (S[2].y - S[0].y)*inv, B1 = (S[0].x - S[2].x)*inv;
+    double C0 = -(A0*S[1].x + B0*S[1].y);
+    double C1 = -(A1*S[2].x + B1*S[2].y);
+    // z = z2 + w0*(z0-z2) + w1*(z1-z2)
+    double dz0 = z[0] - z[2], dz1 = z[1] - z[2];
+    double dzdx = A0*dz0 + A1*dz1;
+
+    for (int y=minY; y<=maxY; ++y) {
+        double py = y + 0.5, px = minX + 0.5;
+        double w0 = A0*px + B0*py + C0;
+        double w1 = A1*px + B1*py + C1;
+        double zz = z[2] + w0*dz0 + w1*dz1;
+        DepthT* row = depth + (size_t)y*W;
+        for (int x=minX; x<=maxX; ++x) {
+            if (w0 >= 0.0 && w1 >= 0.0 && w0 + w1 <= 1.0) {
+                DepthT d = (DepthT)zz;
+                if (d < row[x]) row[x] = d;
+            }
+            w0 += A0; w1 += A1; zz += dzdx;
+        }
+    }
+}
+
+} // namespace
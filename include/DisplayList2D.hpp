@@ -0,0 +1,122 @@
+#pragma once
+#include "Bresenham.hpp"
+#include "CompoundGraphicObject2D.hpp"
+#include "GO_Point2D.hpp"
+#include "GO_Polygon2D.hpp"
+#include "GO_Polyline2D.hpp"
+#include "ParallelFor.hpp"
+#include "RasterBuffer.hpp"
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Flattened, replayable form of a CompoundGraphicObject2D tree.
+//
+//   DisplayList2D dl;
+//   dl.compile(scene);          // once, or whenever the tree changes
+//   dl.replay(rb);              // every frame; threads != 1 splits rows
+//
+// compile() walks the tree once and sorts the primitives by type into SoA
+// command buffers: polylines and polygon outlines become line segments
+// (already rounded to pixels, as Drawing2D::line does), GO_Point2D becomes
+// a point. Replay is then a straight loop per type with no pointer chasing
+// or virtual calls. Other IGraphicObject2D types are kept and drawn
+// through their own draw() after the batches.
+//
+// Order: each type keeps the tree order, but segments are drawn before
+// points and unknown objects come last. Trees drawn with one intensity
+// (the usual overlay case) come out exactly as CompoundGraphicObject2D::draw.
+//
+// Parallel replay gives each worker a band of rows; every worker clips
+// the whole list to its band (Bresenham::ClipRect), which writes the same
+// pixels a serial replay would.
+class DisplayList2D {
+public:
+    void clear() {
+        sx0.clear(); sy0.clear(); sx1.clear(); sy1.clear(); sv.clear();
+        px.clear(); py.clear(); pv.clear();
+        others.clear();
+    }
+
+    void compile(const CompoundGraphicObject2D& tree, uint8_t intensity=255) {
+        clear();
+        append(tree, intensity);
+    }
+
+    // Add one tree (or one object) after what is already recorded
+    void append(const CompoundGraphicObject2D& tree, uint8_t intensity=255) {
+        for (const auto& obj : tree.items()) append(obj, intensity);
+    }
+
+    void append(const std::shared_ptr<IGraphicObject2D>& obj, uint8_t intensity=255) {
+        const IGraphicObject2D* o = obj.get();
+        if (!o) return;
+        if (auto* c = dynamic_cast<const CompoundGraphicObject2D*>(o)) { append(*c, intensity); return; }
+        if (auto* p = dynamic_cast<const GO_Point2D*>(o))    { add_point(p->p, intensity); return; }
+        if (auto* l = dynamic_cast<const GO_Polyline2D*>(o)) { add_polyline(l->pts, intensity, false); return; }
+        if (auto* g = dynamic_cast<const GO_Polygon2D*>(o))  { add_polyline(g->pts, intensity, true); return; }
+        others.push_back({ obj, intensity });
+    }
+
+    void add_point(const Point2D& p, uint8_t v) {
+        px.push_back((int)std::lround(p.x));
+        py.push_back((int)std::lround(p.y));
+        pv.push_back(v);
+    }
+
+    // Same segments, in the same direction, as Drawing2D::polyline/polygon
+    void add_polyline(const std::vector<Point2D>& pts, uint8_t v, bool closed) {
+        if (pts.size() < 2) return;
+        for (size_t i=0; i+1<pts.size(); ++i) add_segment(pts[i], pts[i+1], v);
+        if (closed) add_segment(pts.back(), pts.front(), v);
+    }
+
+    void add_segment(const Point2D& a, const Point2D& b, uint8_t v) {
+        sx0.push_back((int)std::lround(a.x)); sy0.push_back((int)std::lround(a.y));
+        sx1.push_back((int)std::lround(b.x)); sy1.push_back((int)std::lround(b.y));
+        sv.push_back(v);
+    }
+
+    size_t segments() const { return sv.size(); }
+    size_t points() const   { return pv.size(); }
+
+    void replay(RasterBuffer<uint8_t>& rb, int threads=1) const {
+        parallel_for(0, rb.height, [&](int y0, int y1) {
+            replay_rows(rb, y0, y1);
+        }, threads, 64);
+        for (const auto& o : others) o.obj->draw(rb, o.intensity);
+    }
+
+private:
+    struct Other { std::shared_ptr<IGraphicObject2D> obj; uint8_t intensity; };
+
+    std::vector<int> sx0, sy0, sx1, sy1;   // segments
+    std::vector<uint8_t> sv;
+    std::vector<int> px, py;               // points
+    std::vector<uint8_t> pv;
+    std::vector<Other> others;
+
+    void replay_rows(RasterBuffer<uint8_t>& rb, int y0, int y1) const {
+        const Bresenham::ClipRect band{ 0, y0, rb.width, y1 };
+        const bool whole = (y0 == 0 && y1 == rb.height);
+        const size_t ns = sv.size();
+        for (size_t i=0; i<ns; ++i) {
+            if (!whole) {
+                int lo = std::min(sy0[i], sy1[i]), hi = std::max(sy0[i], sy1[i]);
+                if (hi < y0 || lo >= y1) continue;
+            }
+            Bresenham::line(rb, band, sx0[i], sy0[i], sx1[i], sy1[i], sv[i]);
+        }
+
+        const int ch = rb.channels, W = rb.width;
+        const PixelRect c = rb.clip.intersected(band);
+        const size_t np = pv.size();
+        for (size_t i=0; i<np; ++i) {
+            const int x = px[i], y = py[i];
+            if (x < c.x0 || x >= c.x1 || y < c.y0 || y >= c.y1) continue;
+            uint8_t* p = &rb.data[((size_t)y * W + x) * ch];
+            for (int c=0; c<ch; ++c) p[c] = pv[i];
+        }
+    }
+};
@@ -3,9 +3,13 @@
 #include "RasterBuffer.hpp"
 #include "Bresenham.hpp"
 #include "Bezier2D.hpp"
+#include "Shading.hpp"
+#include "ScanConverter.hpp"
+#include "PathRasterizer.hpp"
 #include <vector>
 #include <cstdint>
 #include <cmath>
+#include <algorithm>
 
 class Drawing2D {
 public:
@@ -34,122 +38,42 @@ public:
         }
     }
 
-    void fill_polygon(const std::vector<Point2D>& pts, uint8_t c=255) {
-        if (pts.size() < 3) return;
+    // Polygon fillers run on a shared edge-table scan converter (see
+    // ScanConverter.hpp) and write whole spans. Its buffers live in this
+    // Drawing2D, so reuse one instance for many polygons.
 
-        // Find y-range
-        int minY = (int)std::floor(pts[0].y), maxY = minY;
-        for (auto& p : pts) {
-            minY = std::min(minY, (int)std::floor(p.y));
-            maxY = std::max(maxY, (int)std::floor(p.y));
-        }
-
-        // Scanline
-        for (int y = minY; y <= maxY; ++y) {
-            std::vector<int> nodes;
-            size_t n = pts.size();
-            for (size_t i=0,j=n-1; i<n; j=i++) {
-                const Point2D& pi = pts[i];
-                const Point2D& pj = pts[j];
-                if ((pi.y < y && pj.y >= y) || (pj.y < y && pi.y >= y)) {
-                    int x = (int)(pi.x + (y - pi.y) * (pj.x - pi.x) / (pj.y - pi.y));
-                    nodes.push_back(x);
-                }
-            }
-            std::sort(nodes.begin(), nodes.end());
-            for (size_t k=0; k+1 < nodes.size(); k+=2) {
-                for (int x=nodes[k]; x<nodes[k+1]; ++x) {
-                    rb.set_pixel(x,y,c);
-                }
-            }
-        }
+    void fill_polygon(const std::vector<Point2D>& pts, uint8_t c=255,
+                      FillRule rule = FillRule::EvenOdd) {
+        scanFlat.fill(pts, [](int, double*) {}, rule, 0, rb.height,
+            [&](int y, int x0, int x1, const double*, const double*) {
+                rb.fill_span(y, x0, x1, c);
+            });
     }
 
     void fill_polygon_z(const std::vector<Point2D>& pts2d,
                         const std::vector<double>& depths,
-                        uint8_t c=255) {
+                        uint8_t c=255,
+                        FillRule rule = FillRule::EvenOdd) {
         if (pts2d.size()<3 || pts2d.size()!=depths.size()) return;
-
-        int minY = (int)std::floor(pts2d[0].y), maxY = minY;
-        for (auto& p : pts2d) {
-            minY = std::min(minY,(int)std::floor(p.y));
-            maxY = std::max(maxY,(int)std::floor(p.y));
-        }
-
-        for (int y=minY; y<=maxY; ++y) {
-            struct Node { int x; double z; };
-            std::vector<Node> nodes;
-            size_t n=pts2d.size();
-            for (size_t i=0,j=n-1; i<n; j=i++) {
-                const Point2D& pi = pts2d[i];
-                const Point2D& pj = pts2d[j];
-                double zi = depths[i], zj = depths[j];
-                if ((pi.y<y && pj.y>=y) || (pj.y<y && pi.y>=y)) {
-                    double t = (y - pi.y) / (pj.y - pi.y);
-                    int x = (int)(pi.x + t*(pj.x - pi.x));
-                    double z = zi + t*(zj - zi);
-                    nodes.push_back({x,z});
-                }
-            }
-            std::sort(nodes.begin(), nodes.end(),
-                      [](auto&a,auto&b){return a.x<b.x;});
-            for (size_t k=0;k+1<nodes.size();k+=2) {
-                int x0=nodes[k].x, x1=nodes[k+1].x;
-                double z0=nodes[k].z, z1=nodes[k+1].z;
-                for (int x=x0;x<=x1;++x) {
-                    double t = (x1==x0)?0.0:(double)(x-x0)/(x1-x0);
-                    double z = z0 + t*(z1-z0);
-                    if (rb.test_and_set_depth(x,y,z)) {
-                        rb.set_pixel(x,y,c);
-                    }
-                }
-            }
-        }
+        scanZ.fill(pts2d, [&](int i, double* a) { a[0] = depths[i]; }, rule, 0, rb.height,
+            [&](int y, int x0, int x1, const double* l, const double* r) {
+                double dz = (x1==x0) ? 0.0 : (r[0]-l[0])/(x1-x0);
+                rb.fill_span_depth(y, x0, x1+1, l[0], dz, c);
+            });
     }
 
     void fill_polygon_shaded(const   std::vector<Point2D>& pts2d,
                              const std::vector<double>& depths,
-                             const std::vector<uint8_t>& intensities) {
+                             const std::vector<uint8_t>& intensities,
+                             FillRule rule = FillRule::EvenOdd) {
         if (pts2d.size()<3) return;
         if (pts2d.size()!=depths.size() || pts2d.size()!=intensities.size()) return;
-
-        int minY=(int)std::floor(pts2d[0].y), maxY=minY;
-        for (auto& p : pts2d) {
-            minY=std::min(minY,(int)std::floor(p.y));
-            maxY=std::max(maxY,(int)std::floor(p.y));
-        }
-
-        for (int y=minY; y<=maxY; ++y) {
-            struct Node { int x; double z; double i; };
-            std::vector<Node> nodes;
-            size_t n=pts2d.size();
-            for (size_t i=0,j=n-1;i<n;j=i++) {
-                const Point2D& pi=pts2d[i]; const Point2D& pj=pts2d[j];
-                double zi=depths[i], zj=depths[j];
-                double ii=intensities[i], ij=intensities[j];
-                if ((pi.y<y && pj.y>=y)||(pj.y<y && pi.y>=y)) {
-                    double t=(y-pi.y)/(pj.y-pi.y);
-                    int x=(int)(pi.x+t*(pj.x-pi.x));
-                    double z=zi+t*(zj-zi);
-                    double I=ii+t*(ij-ii);
-                    nodes.push_back({x,z,I});
-                }
-            }
-            std::sort(nodes.begin(),nodes.end(),[](auto&a,auto&b){return a.x<b.x;});
-            for (size_t k=0;k+1<nodes.size();k+=2) {
-                int x0=nodes[k].x, x1=nodes[k+1].x;
-                double z0=nodes[k].z, z1=nodes[k+1].z;
-                double i0=nodes[k].i, i1=nodes[k+1].i;
-                for (int x=x0;x<=x1;++x) {
-                    double t=(x1==x0)?0.0:(double)(x-x0)/(x1-x0);
-                    double z=z0+t*(z1-z0);
-                    double I=i0+t*(i1-i0);
-                    if (rb.test_and_set_depth(x,y,z)) {
-                        rb.set_pixel(x,y, clamp255(I));
-                    }
-                }
-            }
-        }
+        scanShaded.fill(pts2d, [&](int i, double* a) { a[0] = depths[i]; a[1] = intensities[i]; },
+            rule, 0, rb.height,
+            [&](int y, int x0, int x1, const double* l, const double* r) {
+                double inv = (x1==x0) ? 0.0 : 1.0/(x1-x0);
+                rb.fill_span_shaded(y, x0, x1+1, l[0], (r[0]-l[0])*inv, l[1], (r[1]-l[1])*inv);
+            });
     }
 
     // Per-pixel Phong shading with Z-buffer
@@ -158,73 +82,90 @@ public:
                             const std::vector<Point3D>& viewNorm,   // per-vertex view-space normals
                             uint8_t base=200,
                             double kd=0.7, double ks=0.3, double shininess=16.0,
-                            const Point3D& lightDir = Point3D(0,0,-1)) {
+                            const Point3D& lightDir = Point3D(0,0,-1),
+                            FillRule rule = FillRule::EvenOdd) {
         if (pts2d.size()<3 || pts2d.size()!=viewPos.size() || pts2d.size()!=viewNorm.size()) return;
 
-        // y-range
-        int minY=(int)std::floor(pts2d[0].y), maxY=minY;
-        for (auto& p : pts2d) {
-            minY=std::min(minY,(int)std::floor(p.y));
-            maxY=std::max(maxY,(int)std::floor(p.y));
-        }
-
-        for (int y=minY; y<=maxY; ++y) {
-            struct Node { int x; double z; Point3D n; Point3D pos; };
-            std::vector<Node> nodes;
-            size_t n=pts2d.size();
-            for (size_t i=0,j=n-1;i<n;j=i++) {
-                const Point2D& A=pts2d[i]; const Point2D& B=pts2d[j];
-                const Point3D& pA=viewPos[i]; const Point3D& pB=viewPos[j];
-                const Point3D& nA=viewNorm[i]; const Point3D& nB=viewNorm[j];
-
-                bool crosses = (A.y<y && B.y>=y) || (B.y<y && A.y>=y);
-                if (!crosses) continue;
-
-                double t = (B.y == A.y) ? 0.0 : (y - A.y) / (B.y - A.y);
-                int x   = (int)std::floor(A.x + t*(B.x - A.x));
-                double z= pA.z + t*(pB.z - pA.z);
-                Point3D N( nA.x + t*(nB.x - nA.x),
-                           nA.y + t*(nB.y - nA.y),
-                           nA.z + t*(nB.z - nA.z) );
-                Point3D P( pA.x + t*(pB.x - pA.x),
-                           pA.y + t*(pB.y - pA.y),
-                           pA.z + t*(pB.z - pA.z) );
-                nodes.push_back({x,z,N,P});
-            }
-
-            std::sort(nodes.begin(),nodes.end(),[](auto&a,auto&b){return a.x<b.x;});
-            for (size_t k=0;k+1<nodes.size();k+=2) {
-                int x0=nodes[k].x, x1=nodes[k+1].x;
-                double z0=nodes[k].z, z1=nodes[k+1].z;
-                Point3D n0=nodes[k].n, n1=nodes[k+1].n;
-                Point3D p0=nodes[k].pos, p1=nodes[k+1].pos;
-
-                for (int x=x0; x<=x1; ++x) {
-                    double t = (x1==x0)?0.0:(double)(x-x0)/(x1-x0);
-                    double z = z0 + t*(z1 - z0);
-                    if (!rb.test_and_set_depth(x,y,z)) continue;
-
-                    Point3D N( n0.x + t*(n1.x - n0.x),
-                               n0.y + t*(n1.y - n0.y),
-                               n0.z + t*(n1.z - n0.z) );
-                    Point3D P( p0.x + t*(p1.x - p0.x),
-                               p0.y + t*(p1.y - p0.y),
-                               p0.z + t*(p1.z - p0.z) );
+        // Attributes: normal xyz, position xyz (z doubles as depth)
+        auto attr = [&](int i, double* a) {
+            a[0] = viewNorm[i].x; a[1] = viewNorm[i].y; a[2] = viewNorm[i].z;
+            a[3] = viewPos[i].x;  a[4] = viewPos[i].y;  a[5] = viewPos[i].z;
+        };
+        scanPhong.fill(pts2d, attr, rule, 0, rb.height,
+            [&](int y, int x0, int x1, const double* l, const double* r) {
+                double inv = (x1==x0) ? 0.0 : 1.0/(x1-x0);
+                rb.fill_span_depth_fn(y, x0, x1+1, l[5], (r[5]-l[5])*inv, [&](int x) {
+                    double t = (x-x0)*inv;
+                    Point3D N( l[0] + t*(r[0] - l[0]),
+                               l[1] + t*(r[1] - l[1]),
+                               l[2] + t*(r[2] - l[2]) );
+                    Point3D P( l[3] + t*(r[3] - l[3]),
+                               l[4] + t*(r[4] - l[4]),
+                               l[5] + t*(r[5] - l[5]) );
 
                     // View-space: camera at origin, looking -Z → viewDir = -P
                     Point3D viewDir(-P.x, -P.y, -P.z);
                     double I01 = phong01(N, lightDir, viewDir, kd, ks, shininess);
-                    uint8_t I = (uint8_t)std::round((base/255.0)*255.0*I01);
-                    rb.set_pixel(x,y,I);
-                }
-            }
-        }
+                    return (uint8_t)std::round((base/255.0)*255.0*I01);
+                });
+            }, true);   // span ends floored, as the per-pixel Phong filler did
+    }
+
+    // Anti-aliased paths (see PathRasterizer.hpp). Coordinates are continuous:
+    // pixel (x,y) covers [x,x+1) x [y,y+1), so its center is (x+0.5, y+0.5).
+
+    void fill_path_aa(const std::vector<Point2D>& pts, uint8_t c=255, double alpha=1.0) {
+        path.begin(rb.width, rb.height);
+        path.add_polygon(pts);
+        path.fill(rb, c, alpha);
+    }
+
+    void polyline_aa(const std::vector<Point2D>& pts, double width, uint8_t c=255,
+                     LineJoin join = LineJoin::Miter, LineCap cap = LineCap::Butt,
+                     bool closed = false, double alpha=1.0) {
+        path.begin(rb.width, rb.height);
+        path.add_stroke(pts, width, join, cap, closed);
+        path.fill(rb, c, alpha);
+    }
+
+    void line_aa(const Point2D& a, const Point2D& b, double width=1.0, uint8_t c=255,
+                 LineCap cap = LineCap::Butt, double alpha=1.0) {
+        path.begin(rb.width, rb.height);
+        path.add_stroke({ a, b }, width, LineJoin::Miter, cap);
+        path.fill(rb, c, alpha);
     }
 
     void circle(const Point2D& center, int radius, uint8_t c=255) {
         Bresenham::circle(rb, (int)std::lround(center.x), (int)std::lround(center.y), radius, c);
     }
 
+    void fill_circle(const Point2D& center, int radius, uint8_t c=255) {
+        Bresenham::fill_circle(rb, (int)std::lround(center.x), (int)std::lround(center.y), radius, c);
+    }
+
+    void fill_ellipse(const Point2D& center, int rx, int ry, uint8_t c=255) {
+        Bresenham::fill_ellipse(rb, (int)std::lround(center.x), (int)std::lround(center.y), rx, ry, c);
+    }
+
+    void circle_aa(const Point2D& center, double radius, uint8_t c=255) {
+        Bresenham::circle_aa(rb, (int)std::lround(center.x), (int)std::lround(center.y), radius, c);
+    }
+
+    void ellipse_aa(const Point2D& center, double rx, double ry, uint8_t c=255) {
+        Bresenham::ellipse_aa(rb, (int)std::lround(center.x), (int)std::lround(center.y), rx, ry, c);
+    }
+
+    // Filled discs of one radius at every center, in a single call
+    void fill_markers(const std::vector<Point2D>& centers, int radius, uint8_t c=255) {
+        markerX.resize(centers.size());
+        markerY.resize(centers.size());
+        for (size_t i=0; i<centers.size(); ++i) {
+            markerX[i] = (int)std::lround(centers[i].x);
+            markerY[i] = (int)std::lround(centers[i].y);
+        }
+        Bresenham::fill_circles(rb, markerX.data(), markerY.data(), centers.size(), radius, c, markerScratch);
+    }
+
     void quadratic_bezier(const Point2D& p0, const Point2D& p1, const Point2D& p2, int segments, uint8_t c=255) {
         auto pts = Bezier2D::tesselate_quadratic(p0,p1,p2,segments);
         polyline(pts, c);
@@ -235,6 +176,32 @@ public:
         polyline(pts, c);
     }
 
+    // Flattened to within `tolerance` pixels instead of a fixed count
+    void quadratic_bezier_adaptive(const Point2D& p0, const Point2D& p1, const Point2D& p2,
+                                   double tolerance=0.25, uint8_t c=255) {
+        curvePts.clear();
+        curvePts.push_back(p0);
+        Bezier2D::flatten_quadratic(p0,p1,p2,tolerance,curvePts);
+        polyline(curvePts, c);
+    }
+
+    void cubic_bezier_adaptive(const Point2D& p0, const Point2D& p1, const Point2D& p2, const Point2D& p3,
+                               double tolerance=0.25, uint8_t c=255) {
+        curvePts.clear();
+        curvePts.push_back(p0);
+        Bezier2D::flatten_cubic(p0,p1,p2,p3,tolerance,curvePts);
+        polyline(curvePts, c);
+    }
+
 private:
     RasterBuffer<uint8_t>& rb;
+
+    ScanConverter<0> scanFlat;
+    ScanConverter<1> scanZ;        // depth
+    ScanConverter<2> scanShaded;   // depth, intensity
+    ScanConverter<6> scanPhong;    // normal, position
+    PathRasterizer   path;
+    std::vector<Point2D> curvePts;    // reused by the adaptive curve calls
+    std::vector<int> markerX, markerY;
+    Bresenham::CircleScratch markerScratch;
 };
@@ -0,0 +1,289 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "RasterBuffer.hpp"
+#include "ParallelFor.hpp"
+
+// FXAA-style post-process anti-aliasing for a finished RasterBuffer<uint8_t>
+// (gray, RGB or RGBA). Much cheaper than MSAA; it only needs the colors.
+//
+//   FXAAPass fxaa;
+//   fxaa.apply(rb);
+//
+// 1. Luma into a padded 8-bit plane (the pixels themselves for gray).
+// 2. Per row, a branch-free local-contrast test over the 4-neighbourhood
+//    flags edge pixels and counts them; these plain byte loops are what the
+//    compiler vectorizes, and they reject most of the image.
+// 3. A prefix sum over the row counts places every row's edge pixels in
+//    one flat list, filled branch-free from the flags.
+// 4. Listed pixels get the FXAA treatment, a batch at a time: their 3x3
+//    luma is gathered into columns and one vectorized loop finds the edge
+//    orientation and sub-pixel offset of each; then a short search along
+//    the edge for its end points, and a blend towards the neighbour across
+//    the edge by the larger of the edge-end and sub-pixel offsets.
+//
+// Rows are processed in bands across threads. Blended colors go into the
+// list and are written back afterwards, so every band reads the unmodified
+// image. All buffers are members and keep their size between frames.
+class FXAAPass {
+public:
+    double edgeThreshold    = 0.125;   // contrast relative to the local max luma,
+                                       // rounded to a power of two (1/4, 1/8, 1/16...)
+    double edgeThresholdMin = 0.0625;  // absolute contrast floor (dark areas)
+    double subpixel         = 0.75;    // 0 = off, 1 = softest
+    int    maxSearch        = 8;       // edge-end search steps per side
+    int    threads          = 0;       // 0 = hardware concurrency
+
+    double lastMs      = 0.0;
+    double lastMsPerMP = 0.0;
+    size_t lastEdgePixels = 0;         // pixels that were blended
+
+    void apply(RasterBuffer<uint8_t>& rb) {
+        auto t0 = std::chrono::steady_clock::now();
+        W = rb.width; H = rb.height; C = rb.channels;
+        P = W + 2;
+
+        luma.resize((size_t)P * (H + 2));
+        flags.resize((size_t)W * H);
+        rowStart.resize(H + 1);
+
+        parallel_for(0, H, [&](int y0, int y1) {
+            switch (C) {
+                case 1:  luma_rows<1>(rb, y0, y1); break;
+                case 3:  luma_rows<3>(rb, y0, y1); break;
+                default: luma_rows<4>(rb, y0, y1); break;
+            }
+        }, threads, 32);
+        pad_luma();
+
+        const uint8_t thrMin = (uint8_t)std::min(255.0, edgeThresholdMin * 255.0 + 0.5);
+        const int relShift = std::max(0, std::min(7, (int)std::lround(-std::log2(std::max(1e-3, edgeThreshold)))));
+        parallel_for(0, H, [&](int y0, int y1) {
+            for (int y=y0; y<y1; ++y) rowStart[y + 1] = detect_row(y, thrMin, relShift);
+        }, threads, 16);
+
+        rowStart[0] = 0;
+        for (int y=0; y<H; ++y) rowStart[y + 1] += rowStart[y];
+        if (fixes.size() < rowStart[H]) fixes.resize(rowStart[H]);
+
+        parallel_for(0, H, [&](int y0, int y1) {
+            for (int y=y0; y<y1; ++y) blend_row(rb, y);
+        }, threads, 16);
+
+        const Fix* fx = fixes.data();
+        size_t n = 0;
+        for (size_t k=0; k<rowStart[H]; ++k) {
+            if (fx[k].t == 0) continue;
+            std::copy_n(fx[k].c, C, &rb.data[(size_t)fx[k].idx * C]);
+            ++n;
+        }
+        lastEdgePixels = n;
+
+        auto t1 = std::chrono::steady_clock::now();
+        lastMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        lastMsPerMP = lastMs / ((double)W * H / 1e6);
+    }
+
+private:
+    struct Fix { uint32_t idx; uint8_t c[4]; int t; };   // t = 0: left as is
+
+    int W = 0, H = 0, C = 1, P = 0;     // P = padded luma stride
+    std::vector<uint8_t> luma;          // (W+2)*(H+2), borders replicated
+    std::vector<uint8_t> flags;         // 1 = edge pixel
+    std::vector<size_t> rowStart;       // first entry of row y in `fixes`
+    std::vector<Fix> fixes;             // edge pixels of all rows, in order
+
+    inline uint8_t* luma_row(int y) { return &luma[(size_t)(y + 1) * P + 1]; }
+
+    // Rec.601 weights in 8-bit fixed point (77+150+29 = 256). The channel
+    // count is a template argument so the strided loads have a fixed stride.
+    template<int CH>
+    void luma_rows(const RasterBuffer<uint8_t>& rb, int y0, int y1) {
+        const int n = W;
+        for (int y=y0; y<y1; ++y) {
+            const uint8_t* __restrict src = &rb.data[(size_t)y * n * CH];
+            uint8_t* __restrict dst = luma_row(y);
+            if (CH == 1) { std::copy_n(src, n, dst); continue; }
+            for (int x=0; x<n; ++x) {
+                const uint8_t* p = src + (size_t)x * CH;
+                dst[x] = (uint8_t)((77*p[0] + 150*p[1] + 29*p[2]) >> 8);
+            }
+        }
+    }
+
+    void pad_luma() {
+        for (int y=0; y<H; ++y) {
+            uint8_t* r = luma_row(y);
+            r[-1] = r[0]; r[W] = r[W-1];
+        }
+        std::copy_n(&luma[P], P, &luma[0]);
+        std::copy_n(&luma[(size_t)H * P], P, &luma[(size_t)(H + 1) * P]);
+    }
+
+    // Branch-free contrast test, all in bytes so it vectorizes to 16 pixels
+    // per instruction: range >= max(thrMin, maxLuma >> relShift). Returns
+    // the number of edge pixels in the row.
+    size_t detect_row(int y, uint8_t thrMin, int relShift) {
+        const uint8_t* __restrict u = luma_row(y - 1);
+        const uint8_t* __restrict m = luma_row(y);
+        const uint8_t* __restrict d = luma_row(y + 1);
+        uint8_t* __restrict f = &flags[(size_t)y * W];
+        const int n = W;   // a local bound: byte stores could alias the member
+        for (int x=0; x<n; ++x) {
+            uint8_t hi = std::max(std::max(std::max(u[x], d[x]), std::max(m[x-1], m[x+1])), m[x]);
+            uint8_t lo = std::min(std::min(std::min(u[x], d[x]), std::min(m[x-1], m[x+1])), m[x]);
+            uint8_t range = (uint8_t)(hi - lo);
+            uint8_t need  = std::max(thrMin, (uint8_t)(hi >> relShift));
+            f[x] = (uint8_t)(range >= need);
+        }
+        size_t count = 0;
+        for (int x=0; x<n; ++x) count += f[x];
+        return count;
+    }
+
+    // Compact the row's flags into its slice of `fixes` (store every x,
+    // advance only on edges; quiet runs of 8 are skipped a word at a time),
+    // then blend the listed pixels a batch at a time
+    void blend_row(const RasterBuffer<uint8_t>& rb, int y) {
+        Fix* out = &fixes[rowStart[y]];
+        const size_t count = rowStart[y + 1] - rowStart[y];
+        if (!count) return;
+        const uint8_t* f = &flags[(size_t)y * W];
+        const uint32_t base = (uint32_t)((size_t)y * W);
+        Fix spare;
+        size_t k = 0;
+        int x = 0;
+        for (; x + 8 <= W && k < count; x += 8) {
+            uint64_t word;
+            std::memcpy(&word, f + x, 8);
+            if (!word) continue;
+            for (int i=0; i<8; ++i) {
+                Fix& dst = k < count ? out[k] : spare;   // past the row's last edge
+                dst.idx = base + (uint32_t)(x + i);
+                k += f[x + i];
+            }
+        }
+        for (; x < W && k < count; ++x) {
+            out[k].idx = base + (uint32_t)x;
+            k += f[x];
+        }
+
+        Batch b;
+        for (size_t k0=0; k0<count; k0+=kBatch) {
+            Fix* fx = out + k0;
+            const int n = (int)std::min<size_t>(kBatch, count - k0);
+            for (int j=0; j<n; ++j) {
+                const int px = (int)(fx[j].idx - base);
+                const uint8_t* c = &luma[(size_t)(y + 1) * P + px + 1];
+                b.x[j] = px;
+                b.M[j]  = c[0];    b.N[j]  = c[-P];   b.S[j]  = c[P];
+                b.E[j]  = c[1];    b.Wl[j] = c[-1];
+                b.NW[j] = c[-P-1]; b.NE[j] = c[-P+1]; b.SW[j] = c[P-1]; b.SE[j] = c[P+1];
+            }
+            classify(b, n);
+            for (int j=0; j<n; ++j) {
+                int nx, ny;
+                fx[j].t = blend_amount(b, j, y, nx, ny);
+                if (fx[j].t <= 0) { fx[j].t = 0; continue; }
+                const uint8_t* a = &rb.data[(size_t)fx[j].idx * C];
+                const uint8_t* q = &rb.data[((size_t)ny * W + nx) * C];
+                for (int c=0; c<C; ++c) fx[j].c[c] = (uint8_t)(a[c] + (((q[c] - a[c]) * fx[j].t + 128) >> 8));
+            }
+        }
+    }
+
+    // Up to kBatch edge pixels of one row with their 3x3 luma gathered into
+    // columns, so classify() is a single loop over plain int arrays that the
+    // compiler vectorizes. Lives on the stack: every band has its own.
+    static constexpr int kBatch = 64;
+    struct Batch {
+        int x[kBatch];
+        int M[kBatch], N[kBatch], S[kBatch], E[kBatch], Wl[kBatch];
+        int NW[kBatch], NE[kBatch], SW[kBatch], SE[kBatch];
+        float sp[kBatch];                 // sub-pixel blend, 0..subpixel
+        int horizontal[kBatch];           // edge runs along x, blend across y
+        int step[kBatch];                 // -1: blend towards N / W, +1: S / E
+        int avg2[kBatch];                 // 2 * luma on the edge
+        int grad[kBatch];                 // luma step across the edge
+    };
+
+    void classify(Batch& b, int n) const {
+        const float sub = (float)subpixel;
+        for (int j=0; j<n; ++j) {
+            int M = b.M[j], N = b.N[j], S = b.S[j], E = b.E[j], Wl = b.Wl[j];
+            int NW = b.NW[j], NE = b.NE[j], SW = b.SW[j], SE = b.SE[j];
+            int hi = std::max(std::max(std::max(N, S), std::max(E, Wl)), M);
+            int lo = std::min(std::min(std::min(N, S), std::min(E, Wl)), M);
+
+            // Sub-pixel aliasing: how much M stands out from its 3x3
+            // neighbourhood, |avg - M| / range with both sides scaled by 12
+            // and clamped as integers
+            int den = 12 * std::max(1, hi - lo);
+            int num = std::min(den, std::abs(2 * (N + S + E + Wl) + NW + NE + SW + SE - 12 * M));
+            float sp = (float)num / (float)den;
+            sp = sp * sp * (3.0f - 2.0f * sp);
+            b.sp[j] = sp * sp * sub;
+
+            int horz = std::abs(NW - 2*Wl + SW) + 2*std::abs(N - 2*M + S) + std::abs(NE - 2*E + SE);
+            int vert = std::abs(NW - 2*N + NE) + 2*std::abs(Wl - 2*M + E) + std::abs(SW - 2*S + SE);
+            int h = horz >= vert;
+            int l1 = h ? N : Wl, l2 = h ? S : E;
+            int g1 = l1 - M, g2 = l2 - M;
+            int first = std::abs(g1) >= std::abs(g2);
+            b.horizontal[j] = h;
+            b.step[j] = first ? -1 : 1;
+            b.avg2[j] = (first ? l1 : l2) + M;
+            b.grad[j] = std::max(std::abs(g1), std::abs(g2));
+        }
+    }
+
+    // How far to blend batch pixel j of row y towards its neighbour (nx,ny)
+    // across the edge, in 1/256ths. The padded luma plane makes the first
+    // step of the search safe; the limits keep the rest inside it.
+    int blend_amount(const Batch& b, int j, int y, int& nx, int& ny) const {
+        const int x = b.x[j], step = b.step[j], avg2 = b.avg2[j], grad = b.grad[j];
+        const bool horizontal = b.horizontal[j];
+        const float sp = b.sp[j];
+        const uint8_t* c = &luma[(size_t)(y + 1) * P + x + 1];
+
+        // Walk along the edge on the boundary between M and the chosen side,
+        // one tight loop per direction: a side ends where the pair straddling
+        // the boundary leaves the edge luma, or at its limit
+        int along  = horizontal ? 1 : P;
+        int across = horizontal ? step * P : step;
+        int pos    = horizontal ? x : y;
+        int extent = horizontal ? W : H;
+        int d1 = maxSearch, d2 = maxSearch, e1 = 0, e2 = 0;
+        auto walk = [&](int dir, int lim, int& d, int& e) {
+            const uint8_t* q = c + dir * along;
+            int k = 1, s = q[0] + q[across] - avg2;
+            while (4*std::abs(s) < grad && k < lim) {
+                q += dir * along;
+                ++k;
+                s = q[0] + q[across] - avg2;
+            }
+            e = s;
+            if (4*std::abs(s) >= grad) d = k;
+        };
+        if (sp < 0.5f && maxSearch > 0) {   // edgeOffset is at most 0.5: otherwise sp wins anyway
+            walk(-1, std::min(maxSearch, pos + 1), d1, e1);
+            walk(+1, std::min(maxSearch, extent - pos), d2, e2);
+        }
+
+        // Only the side whose end point disagrees with M gets blended
+        int dMin = std::min(d1, d2);
+        int eNear = (d1 < d2) ? e1 : e2;
+        bool mBelow = 2*b.M[j] < avg2;
+        float edgeOffset = ((eNear < 0) != mBelow) ? 0.5f - (float)dMin / (d1 + d2) : 0.0f;
+
+        nx = horizontal ? x : std::min(std::max(x + step, 0), W - 1);
+        ny = horizontal ? std::min(std::max(y + step, 0), H - 1) : y;
+        return (int)(std::max(edgeOffset, sp) * 256.0f + 0.5f);
+    }
+};
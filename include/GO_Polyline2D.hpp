@@ -10,4 +10,5 @@ public:
     void draw(RasterBuffer<uint8_t>& rb, uint8_t intensity=255) const override {
         Drawing2D d(rb); d.polyline(pts, intensity);
     }
+    PixelRect bounds() const override { return pixel_bounds(pts); }
 };
@@ -1,9 +1,27 @@
 #pragma once
 #include "Point2D.hpp"
 #include "RasterBuffer.hpp"
+#include <cmath>
+#include <vector>
 
 class IGraphicObject2D {
 public:
     virtual ~IGraphicObject2D() = default;
     virtual void draw(RasterBuffer<uint8_t>& rb, uint8_t intensity=255) const = 0;
+
+    // Pixels draw() may touch. The default says "anywhere", which is always
+    // correct but makes every change repaint everything.
+    virtual PixelRect bounds() const { return PixelRect::everything(); }
+
+protected:
+    // Pixels covered by lines/points through `pts`, rounded as Drawing2D does
+    static PixelRect pixel_bounds(const std::vector<Point2D>& pts) {
+        PixelRect r;
+        for (const auto& p : pts) r = r.united(pixel_bounds(p));
+        return r;
+    }
+    static PixelRect pixel_bounds(const Point2D& p) {
+        int x = (int)std::lround(p.x), y = (int)std::lround(p.y);
+        return { x, y, x + 1, y + 1 };
+    }
 };
@@ -1,6 +1,6 @@
 #pragma once
 #include <memory>
-#include "Point3d.hpp"
+#include "Point3D.hpp"
 #include "Texture2D.hpp"
 
 struct Material {
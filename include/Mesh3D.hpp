@@ -1,6 +1,10 @@
 #pragma once
+#include "Point2D.hpp"
 #include "Point3D.hpp"
 #include "Polygon3D.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <vector>
 #include <numeric>
 #include "Material.hpp"
@@ -10,6 +14,12 @@ struct Face {
     std::vector<int> indices; // indices into Mesh3D::vertices
 };
 
+// Triangles of every face of a mesh, in face order
+struct Triangulation {
+    std::vector<std::array<int,3>> tris;  // vertex indices, winding of the face
+    std::vector<int>               face;  // source face of each triangle
+};
+
 class Mesh3D {
 public:
     std::vector<Point3D> vertices;
@@ -21,26 +31,30 @@ public:
 
     int add_vertex(const Point3D& v) {
         vertices.push_back(v);
+        ++gen;
         return (int)vertices.size()-1;
     }
 
-    int add_vertex(const Point3D& v, const Point2D& tex = Point2D(0,0)) {
+    int add_vertex(const Point3D& v, const Point2D& tex) {
         vertices.push_back(v);
         uv.push_back(tex);
+        ++gen;
         return (int)vertices.size()-1;
     }
 
     int add_vertex(const Point3D& v,
-                   const Point2D& tex = Point2D(0,0),
-                   const Point3D& col = Point3D(1,1,1)) {
+                   const Point2D& tex,
+                   const Point3D& col) {
         vertices.push_back(v);
         uv.push_back(tex);
         colors.push_back(col);
+        ++gen;
         return (int)vertices.size()-1;
     }
 
     void add_face(const std::vector<int>& idx) {
         if (idx.size() >= 3) faces.push_back(Face{idx});
+        ++gen;
     }
 
     // Face normal (un-normalized; good for area-weighted accumulate)
@@ -70,6 +84,35 @@ public:
         return accum;
     }
 
+    // Unit face normals (Newell), one per face, written into `out`
+    void face_normals(std::vector<Point3D>& out) const {
+        out.resize(faces.size());
+        for (size_t f=0; f<faces.size(); ++f) out[f] = face_normal(faces[f]).normalized();
+    }
+
+    // Triangles of all faces: triangles as they are, convex polygons as
+    // fans, concave ones by ear clipping. Built on first use and reused
+    // until generation() changes; it holds topology only, so moving
+    // vertices (e.g. into view space) keeps it. Not safe to call
+    // concurrently on one mesh.
+    const Triangulation& triangulation() const {
+        if (triGen == gen) return triCache;
+        triCache.tris.clear();
+        triCache.face.clear();
+        std::vector<int> ring;
+        std::vector<Point2D> flat;
+        for (size_t f=0; f<faces.size(); ++f) triangulate_face(faces[f], (int)f, ring, flat);
+        triGen = gen;
+        return triCache;
+    }
+
+    // Bumped by add_vertex(), add_face() and invalidate_triangulation().
+    // Editing `faces` directly does not bump it: call
+    // invalidate_triangulation() afterwards, or the cached triangles
+    // describe the old faces.
+    uint64_t generation() const { return gen; }
+    void invalidate_triangulation() { ++gen; }
+
     // Convenience: convert a face to a Polygon3D (expanded positions)
     Polygon3D to_polygon(const Face& f) const {
         std::vector<Point3D> poly;
@@ -77,4 +120,67 @@ public:
         for (int vi : f.indices) poly.push_back(vertices[vi]);
         return Polygon3D(poly);
     }
+
+private:
+    uint64_t gen = 1;
+    mutable Triangulation triCache;
+    mutable uint64_t triGen = 0;
+
+    void triangulate_face(const Face& f, int id, std::vector<int>& ring, std::vector<Point2D>& flat) const {
+        const auto& idx = f.indices;
+        const size_t n = idx.size();
+        auto emit = [&](int a, int b, int c) {
+            triCache.tris.push_back({ a, b, c });
+            triCache.face.push_back(id);
+        };
+        if (n < 3) return;
+        if (n == 3) { emit(idx[0], idx[1], idx[2]); return; }
+
+        // Flatten onto the dominant plane of the normal, turned so the
+        // polygon runs counter-clockwise
+        Point3D nrm = face_normal(f);
+        double ax = std::fabs(nrm.x), ay = std::fabs(nrm.y), az = std::fabs(nrm.z);
+        flat.resize(n);
+        for (size_t i=0; i<n; ++i) {
+            const Point3D& p = vertices[idx[i]];
+            if (az >= ax && az >= ay) flat[i] = Point2D(nrm.z >= 0 ? p.x : -p.x, p.y);
+            else if (ax >= ay)        flat[i] = Point2D(nrm.x >= 0 ? p.y : -p.y, p.z);
+            else                      flat[i] = Point2D(nrm.y >= 0 ? p.z : -p.z, p.x);
+        }
+        auto cross = [&](int a, int b, int c) {
+            return (flat[b].x - flat[a].x) * (flat[c].y - flat[a].y)
+                 - (flat[b].y - flat[a].y) * (flat[c].x - flat[a].x);
+        };
+
+        bool convex = true;
+        for (size_t i=0; i<n && convex; ++i) convex = cross((int)i, (int)((i+1) % n), (int)((i+2) % n)) >= 0.0;
+        if (convex) {
+            for (size_t i=1; i+1<n; ++i) emit(idx[0], idx[i], idx[i+1]);
+            return;
+        }
+
+        // Ear clipping: cut off a convex corner with no other corner inside
+        ring.resize(n);
+        std::iota(ring.begin(), ring.end(), 0);
+        while (ring.size() > 3) {
+            const size_t m = ring.size();
+            bool cut = false;
+            for (size_t i=0; i<m && !cut; ++i) {
+                int a = ring[(i + m - 1) % m], b = ring[i], c = ring[(i + 1) % m];
+                if (cross(a, b, c) <= 0.0) continue;
+                bool empty = true;
+                for (size_t j=0; j<m && empty; ++j) {
+                    int p = ring[j];
+                    if (p == a || p == b || p == c) continue;
+                    empty = !(cross(a, b, p) >= 0.0 && cross(b, c, p) >= 0.0 && cross(c, a, p) >= 0.0);
+                }
+                if (!empty) continue;
+                emit(idx[a], idx[b], idx[c]);
+                ring.erase(ring.begin() + i);
+                cut = true;
+            }
+            if (!cut) break;            // degenerate or self-intersecting: fan the rest
+        }
+        for (size_t i=1; i+1<ring.size(); ++i) emit(idx[ring[0]], idx[ring[i]], idx[ring[i+1]]);
+    }
 };
@@ -1,8 +1,15 @@
 #pragma once
 #include "Mesh3D.hpp"
+#include "Transformation3D.hpp"
+#include "ParallelFor.hpp"
+#include "VoxelGrid.hpp"
+#include <algorithm>
+#include <array>
 #include <cmath>
-#include <map>
-#include <tuple>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <vector>
 
 // rows = latitude segments (>=2), cols = longitude segments (>=3)
 inline Mesh3D make_uv_sphere(int rows, int cols, double radius=1.0) {
@@ -48,17 +55,6 @@ inline Mesh3D make_uv_sphere(int rows, int cols, double radius=1.0) {
 
 // ------------------- Icosphere -------------------
 
-namespace {
-    // Hash for edge midpoint lookup
-    struct EdgeKey {
-        int v0, v1;
-        EdgeKey(int a, int b) { v0 = std::min(a,b); v1 = std::max(a,b); }
-        bool operator<(const EdgeKey& other) const {
-            return std::tie(v0,v1) < std::tie(other.v0,other.v1);
-        }
-    };
-}
-
 // Create an icosahedron base
 inline Mesh3D make_icosahedron(double radius=1.0) {
     Mesh3D mesh;
@@ -85,109 +81,285 @@ inline Mesh3D make_icosahedron(double radius=1.0) {
     return mesh;
 }
 
-// Subdivide each triangle of a mesh
-inline Mesh3D subdivide_icosphere(const Mesh3D& mesh, int level, double radius) {
+// Subdivide each triangle of a mesh `level` times, new vertices pushed out
+// to `radius` (faces: first three indices of each).
+//
+// Midpoints are indexed by edge, not looked up: the base mesh's edges are
+// numbered once with a flat open-addressing hash, and from then on every
+// level's edge numbering follows in closed form from the one before
+// (parent edge e splits into child edges 2e and 2e+1, face f adds the
+// interior edges 2E+3f..2E+3f+2), so the midpoint of edge e is simply
+// vertex V+e. Each level is then independent work per face and per edge,
+// split across `threads` (0 = all cores), into buffers sized up front.
+// Triangles stay in flat index arrays until the final Face list is built.
+inline Mesh3D subdivide_icosphere(const Mesh3D& mesh, int level, double radius, int threads = 0) {
     Mesh3D result;
     result.vertices = mesh.vertices;
-    result.faces.clear();
+    if (level <= 0) { result.faces = mesh.faces; return result; }
+
+    // Triangles and, per triangle corner j, the edge (v[j], v[j+1])
+    std::vector<int> tri, triEdge;
+    std::vector<int> edgeA, edgeB;     // edge end points; edgeA decides the child edge half
+    for (const auto& f : mesh.faces) {
+        if (f.indices.size() < 3) continue;
+        tri.insert(tri.end(), f.indices.begin(), f.indices.begin() + 3);
+    }
+    {
+        size_t cap = 16;
+        while (cap < tri.size() * 2) cap <<= 1;
+        std::vector<uint64_t> keys(cap, ~0ull);
+        std::vector<int> ids(cap);
+        triEdge.resize(tri.size());
+        for (size_t t=0; t<tri.size(); t+=3) {
+            for (int j=0; j<3; ++j) {
+                int a = tri[t + j], b = tri[t + (j + 1) % 3];
+                uint64_t key = ((uint64_t)(uint32_t)std::min(a,b) << 32) | (uint32_t)std::max(a,b);
+                size_t h = (size_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & (cap - 1);
+                while (keys[h] != key && keys[h] != ~0ull) h = (h + 1) & (cap - 1);
+                if (keys[h] == ~0ull) {
+                    keys[h] = key;
+                    ids[h] = (int)edgeA.size();
+                    edgeA.push_back(a);
+                    edgeB.push_back(b);
+                }
+                triEdge[t + j] = ids[h];
+            }
+        }
+    }
 
+    // Final sizes: each level adds one vertex per edge, E' = 2E + 3F, F' = 4F
+    size_t V = result.vertices.size(), E = edgeA.size(), F = tri.size() / 3;
+    {
+        size_t v = V, e = E, f = F;
+        for (int l=0; l<level; ++l) { v += e; e = 2*e + 3*f; f *= 4; }
+        result.vertices.reserve(v);
+    }
+
+    std::vector<int> nTri, nTriEdge, nEdgeA, nEdgeB;
     for (int l=0; l<level; ++l) {
-        std::map<EdgeKey,int> midpointCache;
-        std::vector<Face> newFaces;
-
-        for (const auto& f : (l==0 ? mesh.faces : result.faces)) {
-            int v0=f.indices[0], v1=f.indices[1], v2=f.indices[2];
-
-            auto midpoint = [&](int a, int b) {
-                EdgeKey key(a,b);
-                auto it = midpointCache.find(key);
-                if (it!=midpointCache.end()) return it->second;
-
-                Point3D pa = result.vertices[a];
-                Point3D pb = result.vertices[b];
-                Point3D pm = (pa+pb)*0.5;
-                double len = std::sqrt(pm.x*pm.x + pm.y*pm.y + pm.z*pm.z);
-                pm = Point3D(pm.x/len*radius, pm.y/len*radius, pm.z/len*radius);
-                int idx = (int)result.vertices.size();
-                result.vertices.push_back(pm);
-                midpointCache[key]=idx;
-                return idx;
-            };
+        const int Vi = (int)V, Ei = (int)E;
+        result.vertices.resize(V + E);
+        nTri.resize(12 * F);
+        nTriEdge.resize(12 * F);
+        nEdgeA.resize(2 * E + 3 * F);
+        nEdgeB.resize(2 * E + 3 * F);
+
+        // Midpoint vertices and the two halves of every edge
+        Point3D* verts = result.vertices.data();
+        parallel_for(0, (int)E, [&](int e0, int e1) {
+            for (int e=e0; e<e1; ++e) {
+                const Point3D& pa = verts[edgeA[e]];
+                const Point3D& pb = verts[edgeB[e]];
+                double x = 0.5*(pa.x + pb.x), y = 0.5*(pa.y + pb.y), z = 0.5*(pa.z + pb.z);
+                double k = radius / std::sqrt(x*x + y*y + z*z);
+                verts[Vi + e] = Point3D(x*k, y*k, z*k);
+                nEdgeA[2*e] = edgeA[e];     nEdgeB[2*e] = Vi + e;
+                nEdgeA[2*e + 1] = edgeB[e]; nEdgeB[2*e + 1] = Vi + e;
+            }
+        }, threads, 4096);
+
+        // Four children per face, with their edges
+        parallel_for(0, (int)F, [&](int f0, int f1) {
+            for (int f=f0; f<f1; ++f) {
+                const int* v = &tri[3*f];
+                const int* e = &triEdge[3*f];
+                const int a = Vi + e[0], b = Vi + e[1], c = Vi + e[2];
+                auto half = [&](int edge, int vert) { return 2*edge + (edgeA[edge] == vert ? 0 : 1); };
+                const int in = 2*Ei + 3*f;                        // interior edges a-c, b-a, c-b
+                nEdgeA[in] = a; nEdgeB[in] = c;
+                nEdgeA[in + 1] = b; nEdgeB[in + 1] = a;
+                nEdgeA[in + 2] = c; nEdgeB[in + 2] = b;
+
+                int* t = &nTri[12*f];
+                int* te = &nTriEdge[12*f];
+                t[0] = v[0]; t[1]  = a; t[2]  = c;  te[0] = half(e[0], v[0]); te[1]  = in;     te[2]  = half(e[2], v[0]);
+                t[3] = v[1]; t[4]  = b; t[5]  = a;  te[3] = half(e[1], v[1]); te[4]  = in + 1; te[5]  = half(e[0], v[1]);
+                t[6] = v[2]; t[7]  = c; t[8]  = b;  te[6] = half(e[2], v[2]); te[7]  = in + 2; te[8]  = half(e[1], v[2]);
+                t[9] = a;    t[10] = b; t[11] = c;  te[9] = in + 1;           te[10] = in + 2; te[11] = in;
+            }
+        }, threads, 1024);
+
+        tri.swap(nTri);
+        triEdge.swap(nTriEdge);
+        edgeA.swap(nEdgeA);
+        edgeB.swap(nEdgeB);
+        V += E; E = 2*E + 3*F; F *= 4;
+    }
 
-            int a = midpoint(v0,v1);
-            int b = midpoint(v1,v2);
-            int c = midpoint(v2,v0);
+    result.faces.resize(F);
+    parallel_for(0, (int)F, [&](int f0, int f1) {
+        for (int f=f0; f<f1; ++f)
+            result.faces[f].indices.assign(&tri[3*f], &tri[3*f] + 3);
+    }, threads, 4096);
+    return result;
+}
 
-            newFaces.push_back({{v0,a,c}});
-            newFaces.push_back({{v1,b,a}});
-            newFaces.push_back({{v2,c,b}});
-            newFaces.push_back({{a,b,c}});
+// Level-N icosphere written straight into flat arrays, no intermediate
+// levels: n = 2^N, 10*n^2 + 2 vertices (the 12 corners, then n-1 per base
+// edge, then the interior points of each base face) and 20*n^2 triangles,
+// 3 indices each, base face by base face. Every index follows in closed
+// form from (base face, grid row, grid column), so corners/edges and then
+// the 20 faces are filled in parallel. Points are an even grid on each flat
+// base face pushed out to the sphere; the recursive midpoints of
+// subdivide_icosphere sit slightly differently, the counts are the same.
+inline void make_icosphere_arrays(int level, double radius,
+                                  std::vector<Point3D>& verts, std::vector<int>& indices,
+                                  int threads=0) {
+    const Mesh3D ico = make_icosahedron(1.0);
+    const int n = 1 << std::max(0, level);
+    const int perEdge = n - 1, perFace = (n - 1) * (n - 2) / 2;
+
+    // The 30 base edges, numbered once (a < b)
+    std::array<std::array<int,2>,30> edges;
+    std::array<std::array<int,3>,20> faceEdge;
+    int ne = 0;
+    for (int f=0; f<20; ++f) {
+        for (int j=0; j<3; ++j) {
+            int a = ico.faces[f].indices[j], b = ico.faces[f].indices[(j+1)%3];
+            if (a > b) std::swap(a, b);
+            int e = 0;
+            while (e < ne && !(edges[e][0] == a && edges[e][1] == b)) ++e;
+            if (e == ne) edges[ne++] = { a, b };
+            faceEdge[f][j] = e;
         }
-        result.faces = newFaces;
     }
-    return result;
+
+    verts.resize((size_t)10 * n * n + 2);
+    indices.resize((size_t)60 * n * n);
+    const size_t edgeBase = 12, faceBase = 12 + (size_t)30 * perEdge;
+
+    auto onSphere = [&](const Point3D& A, const Point3D& B, const Point3D& C, int i, int j) {
+        double u = (double)i / n, v = (double)j / n, w = 1.0 - u - v;
+        double x = w*A.x + u*B.x + v*C.x, y = w*A.y + u*B.y + v*C.y, z = w*A.z + u*B.z + v*C.z;
+        double k = radius / std::sqrt(x*x + y*y + z*z);
+        return Point3D(x*k, y*k, z*k);
+    };
+
+    for (int c=0; c<12; ++c) verts[c] = ico.vertices[c] * radius;
+    parallel_for(0, 30, [&](int e0, int e1) {
+        for (int e=e0; e<e1; ++e) {
+            const Point3D& A = ico.vertices[edges[e][0]];
+            const Point3D& B = ico.vertices[edges[e][1]];
+            for (int k=1; k<n; ++k) verts[edgeBase + (size_t)e * perEdge + k - 1] = onSphere(A, B, A, k, 0);
+        }
+    }, threads);
+
+    parallel_for(0, 20, [&](int f0, int f1) {
+        for (int f=f0; f<f1; ++f) {
+            const int* fv = ico.faces[f].indices.data();
+            const Point3D& A = ico.vertices[fv[0]];
+            const Point3D& B = ico.vertices[fv[1]];
+            const Point3D& C = ico.vertices[fv[2]];
+
+            // Point k steps from corner `from` along face edge j
+            auto edgePoint = [&](int j, int from, int k) {
+                const auto& e = edges[faceEdge[f][j]];
+                int t = (e[0] == from) ? k : n - k;
+                return (int)(edgeBase + (size_t)faceEdge[f][j] * perEdge + t - 1);
+            };
+            // Interior (i,j), i,j >= 1, i+j <= n-1, row by row
+            auto interior = [&](int i, int j) {
+                int row = j - 1;                                  // rows shrink from n-2 to 1
+                int before = row * (n - 2) - row * (row - 1) / 2;
+                return (int)(faceBase + (size_t)f * perFace + before + (i - 1));
+            };
+            // Grid point (i,j) = A + i/n (B-A) + j/n (C-A)
+            auto vid = [&](int i, int j) {
+                if (j == 0) return i == 0 ? fv[0] : i == n ? fv[1] : edgePoint(0, fv[0], i);
+                if (i == 0) return j == n ? fv[2] : edgePoint(2, fv[0], j);
+                if (i + j == n) return edgePoint(1, fv[1], j);
+                return interior(i, j);
+            };
+
+            for (int j=1; j<n; ++j)
+                for (int i=1; i+j<n; ++i) verts[interior(i, j)] = onSphere(A, B, C, i, j);
+
+            int* out = &indices[(size_t)f * 3 * n * n];
+            for (int j=0; j<n; ++j) {
+                for (int i=0; i+j<n; ++i) {
+                    *out++ = vid(i, j); *out++ = vid(i+1, j); *out++ = vid(i, j+1);
+                    if (i + j + 1 < n) {
+                        *out++ = vid(i+1, j); *out++ = vid(i+1, j+1); *out++ = vid(i, j+1);
+                    }
+                }
+            }
+        }
+    }, threads);
 }
 
-// Make an icosphere with N subdivision levels
-inline Mesh3D make_icosphere(int subdivisions=2, double radius=1.0) {
-    Mesh3D ico = make_icosahedron(radius);
-    if (subdivisions<=0) return ico;
-    return subdivide_icosphere(ico, subdivisions, radius);
+// Make an icosphere with N subdivision levels (see make_icosphere_arrays)
+inline Mesh3D make_icosphere(int subdivisions=2, double radius=1.0, int threads=0) {
+    if (subdivisions<=0) return make_icosahedron(radius);
+    Mesh3D mesh;
+    std::vector<int> idx;
+    make_icosphere_arrays(subdivisions, radius, mesh.vertices, idx, threads);
+    mesh.faces.resize(idx.size() / 3);
+    parallel_for(0, (int)mesh.faces.size(), [&](int f0, int f1) {
+        for (int f=f0; f<f1; ++f) mesh.faces[f].indices.assign(&idx[3*f], &idx[3*f] + 3);
+    }, threads, 4096);
+    return mesh;
 }
 
 // -------- Cube-sphere generator --------
 // subdiv = number of subdivisions per cube edge (>=1).
 // radius = sphere radius.
-inline Mesh3D make_cube_sphere(int subdiv=8, double radius=1.0) {
-    Mesh3D mesh;
+// Cube-sphere into flat arrays: 6 faces of (subdiv+1)^2 vertices each (not
+// shared across cube edges, so every face keeps its own 0..1 UVs) and
+// 2*subdiv^2 triangles per face. Sizes are known up front and each face
+// writes only its own slice, so the faces are built in parallel.
+inline void make_cube_sphere_arrays(int subdiv, double radius,
+                                    std::vector<Point3D>& verts, std::vector<Point2D>& uvs,
+                                    std::vector<int>& indices, int threads=0) {
     if (subdiv < 1) subdiv = 1;
-
-    auto normalize = [&](double x,double y,double z){
-        double len = std::sqrt(x*x + y*y + z*z);
-        return Point3D(x/len*radius, y/len*radius, z/len*radius);
-    };
-
-    // Each face of cube spans [-1,1] in 2D grid.
-    // We'll generate vertices face by face, but deduplicate across edges if you like.
-    // Here, simpler: each face makes its own verts, so some duplication (fine for rendering).
-
-    auto buildFace = [&](int axis, int dir, int faceIndex) {
-        // axis: 0=x,1=y,2=z; dir: +1 or -1
-        // faceIndex: 0..5 (for cube map layout later if needed)
-
-        int base = (int)mesh.vertices.size();
-        for (int i=0; i<=subdiv; ++i) {
-            double u = (double)i/subdiv;
-            double uu = -1.0 + 2.0*u;
-            for (int j=0; j<=subdiv; ++j) {
-                double v = (double)j/subdiv;
-                double vv = -1.0 + 2.0*v
-                double x=0,y=0,z=0;
-                if (axis==0) { x = dir; y=u; z=v; }
-                if (axis==1) { y = dir; x=u; z=v; }
-                if (axis==2) { z = dir; x=u; y=v; }
-                Point3D pos = normalize(x,y,z);
-                Point2D tex(u,v);
-                mesh.add_vertex(pos, tex);
+    const int side = subdiv + 1;
+    const size_t faceVerts = (size_t)side * side, faceIdx = (size_t)6 * subdiv * subdiv;
+    verts.resize(6 * faceVerts);
+    uvs.resize(6 * faceVerts);
+    indices.resize(6 * faceIdx);
+
+    // Face order: +x, -x, +y, -y, +z, -z
+    parallel_for(0, 6, [&](int f0, int f1) {
+        for (int f=f0; f<f1; ++f) {
+            const int axis = f / 2;
+            const double dir = (f & 1) ? -1.0 : 1.0;
+            const int base = (int)(f * faceVerts);
+            Point3D* pv = &verts[base];
+            Point2D* pt = &uvs[base];
+            for (int i=0; i<=subdiv; ++i) {
+                double u = (double)i/subdiv, uu = -1.0 + 2.0*u;
+                for (int j=0; j<=subdiv; ++j) {
+                    double v = (double)j/subdiv, vv = -1.0 + 2.0*v;
+                    double x, y, z;
+                    if (axis==0)      { x = dir; y = uu; z = vv; }
+                    else if (axis==1) { y = dir; x = uu; z = vv; }
+                    else              { z = dir; x = uu; y = vv; }
+                    double len = std::sqrt(x*x + y*y + z*z);
+                    *pv++ = Point3D(x/len*radius, y/len*radius, z/len*radius);
+                    *pt++ = Point2D(u, v);
+                }
             }
-        }
 
-        for (int i=0; i<subdiv; ++i) {
-            for (int j=0; j<subdiv; ++j) {
-                int v0 = base + i*(subdiv+1) + j;
-                int v1 = v0 + 1;
-                int v2 = v0 + (subdiv+1);
-                int v3 = v2 + 1;
-                mesh.add_face({v0,v1,v3});
-                mesh.add_face({v0,v3,v2});
+            int* out = &indices[f * faceIdx];
+            for (int i=0; i<subdiv; ++i) {
+                for (int j=0; j<subdiv; ++j) {
+                    int v0 = base + i*side + j, v1 = v0 + 1;
+                    int v2 = v0 + side,         v3 = v2 + 1;
+                    *out++ = v0; *out++ = v1; *out++ = v3;
+                    *out++ = v0; *out++ = v3; *out++ = v2;
+                }
             }
         }
-    };
-
-    buildFace(0,1);  buildFace(0,-1);
-    buildFace(1,1);  buildFace(1,-1);
-    buildFace(2,1);  buildFace(2,-1);
+    }, threads);
+}
 
+inline Mesh3D make_cube_sphere(int subdiv=8, double radius=1.0, int threads=0) {
+    Mesh3D mesh;
+    std::vector<int> idx;
+    make_cube_sphere_arrays(subdiv, radius, mesh.vertices, mesh.uv, idx, threads);
+    mesh.faces.resize(idx.size() / 3);
+    parallel_for(0, (int)mesh.faces.size(), [&](int f0, int f1) {
+        for (int f=f0; f<f1; ++f) mesh.faces[f].indices.assign(&idx[3*f], &idx[3*f] + 3);
+    }, threads, 4096);
     return mesh;
 }
 
@@ -223,6 +395,8 @@ inline Mesh3D transform_mesh(const Mesh3D& m, const Transformation3D& T) {
     return out;
 }
 
+// One independent 8-vertex cube per cell, touching faces included (see
+// make_cube_grid_merged for a solid grid)
 inline Mesh3D make_cube_grid(int M, int N,
                              double cubeW=1.0, double cubeH=1.0, double cubeD=1.0,
                              double spacing=0.0) {
@@ -259,7 +433,7 @@ inline Mesh3D make_cube_grid_custom(
     int M, int N,
     double cubeW=1.0, double cubeH=1.0, double cubeD=1.0,
     double spacing=0.0,
-    std::function<Transformation3D(int,int)> transformFn = nullptr)
+    std::function<Transformation3D(int,int)> transformFn = nullptr,
     std::function<Point3D(int,int)> colorFn = nullptr)
 {
     Mesh3D grid;
@@ -291,3 +465,39 @@ inline Mesh3D make_cube_grid_custom(
     return grid;
 }
 
+// Solid M x N grid of cube columns as one voxel mesh: column (i,j) stacks
+// heightFn(i,j) cubes from y = -cubeH/2, so a height of 1 everywhere covers
+// the same space as make_cube_grid(M, N) with no spacing. Only exposed
+// faces are emitted, coplanar neighbours of the same color are merged
+// (greedy_mesh_into) and vertices are shared. colorFn(i,j), if given,
+// colors a whole column; at most 255 distinct colors.
+inline Mesh3D make_cube_grid_merged(int M, int N, std::function<int(int,int)> heightFn,
+                                    double cubeW=1.0, double cubeH=1.0, double cubeD=1.0,
+                                    std::function<Point3D(int,int)> colorFn = nullptr) {
+    std::vector<int> heights((size_t)M * N);
+    int top = 0;
+    for (int i=0; i<M; ++i)
+        for (int j=0; j<N; ++j) top = std::max(top, heights[(size_t)j * M + i] = std::max(0, heightFn(i,j)));
+
+    VoxelGrid g(M, top, N);
+    std::vector<Point3D> palette;
+    if (colorFn) palette.push_back(Point3D(1,1,1));     // id 0: empty
+    for (int j=0; j<N; ++j) {
+        for (int i=0; i<M; ++i) {
+            uint8_t id = 1;
+            if (colorFn) {
+                Point3D c = colorFn(i,j);
+                size_t k = 1;
+                while (k < palette.size() && !(palette[k].x == c.x && palette[k].y == c.y && palette[k].z == c.z)) ++k;
+                if (k == palette.size()) {
+                    if (k > 255) throw std::runtime_error("make_cube_grid_merged: more than 255 colors");
+                    palette.push_back(c);
+                }
+                id = (uint8_t)k;
+            }
+            for (int y=0; y<heights[(size_t)j * M + i]; ++y) g.cells[g.index(i,y,j)] = id;
+        }
+    }
+    return greedy_mesh(g, Point3D(cubeW, cubeH, cubeD),
+                       Point3D(-0.5*cubeW, -0.5*cubeH, -0.5*cubeD), palette);
+}
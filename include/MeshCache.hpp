@@ -0,0 +1,285 @@
+#pragma once
+#include "Mesh3D.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MESHCACHE_MMAP 1
+#endif
+
+// Binary Mesh3D cache file.
+//
+//   header (128 bytes)
+//   x[n] y[n] z[n]                 float positions, one array per axis
+//   u[n] v[n]                      float UVs            (if the mesh has them)
+//   r[n] g[n] b[n]                 float colors         (if the mesh has them)
+//   faceStart[faces+1]             uint32 offsets into indices (not written
+//                                  when every face is a triangle)
+//   indices[...]                   uint32
+//
+// Every section starts on a 64-byte boundary, so a mapped file is used in
+// place: MappedMesh hands out pointers into the mapping and parses nothing.
+// The header carries a format version, a caller-chosen key (e.g. a hash of
+// the builder's parameters) and a checksum of everything after the header.
+namespace MeshCache {
+
+constexpr uint32_t kMagic   = 0x334D4C47;      // "GLM3"
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kHasUV = 1, kHasColor = 2, kTriangles = 4;
+
+struct Header {
+    uint32_t magic, version, flags, reserved;
+    uint64_t key;
+    uint64_t vertexCount, faceCount, indexCount;
+    uint64_t posOffset, uvOffset, colorOffset, faceOffset, indexOffset;
+    uint64_t fileSize;
+    uint64_t checksum;
+    uint64_t pad[3];
+};
+static_assert(sizeof(Header) == 128, "MeshCache::Header must stay 128 bytes");
+
+inline uint64_t align64(uint64_t n) { return (n + 63) & ~(uint64_t)63; }
+
+// 64-bit multiply-xorshift over 8-byte words (the size is a multiple of 8)
+inline uint64_t checksum(const uint8_t* p, size_t n) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ n;
+    for (size_t i=0; i+8<=n; i+=8) {
+        uint64_t w;
+        std::memcpy(&w, p + i, 8);
+        h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    return h;
+}
+
+// Write `mesh` to `path`; throws std::runtime_error on I/O failure
+inline void save(const Mesh3D& mesh, const std::string& path, uint64_t key = 0) {
+    const uint64_t n = mesh.vertices.size();
+    Header h{};
+    h.magic = kMagic;
+    h.version = kVersion;
+    h.key = key;
+    h.vertexCount = n;
+    h.faceCount = mesh.faces.size();
+    bool tris = true;
+    for (const auto& f : mesh.faces) { h.indexCount += f.indices.size(); tris &= f.indices.size() == 3; }
+    if (mesh.uv.size() == n && n) h.flags |= kHasUV;
+    if (mesh.colors.size() == n && n) h.flags |= kHasColor;
+    if (tris) h.flags |= kTriangles;
+
+    uint64_t at = sizeof(Header);
+    h.posOffset = at;                                        at = align64(at + 3 * n * sizeof(float));
+    h.uvOffset = (h.flags & kHasUV) ? at : 0;                if (h.uvOffset) at = align64(at + 2 * n * sizeof(float));
+    h.colorOffset = (h.flags & kHasColor) ? at : 0;          if (h.colorOffset) at = align64(at + 3 * n * sizeof(float));
+    h.faceOffset = tris ? 0 : at;                            if (!tris) at = align64(at + (h.faceCount + 1) * sizeof(uint32_t));
+    h.indexOffset = at;                                      at = align64(at + h.indexCount * sizeof(uint32_t));
+    h.fileSize = at;
+
+    std::vector<uint8_t> buf(at, 0);
+    float* pos = reinterpret_cast<float*>(&buf[h.posOffset]);
+    for (uint64_t i=0; i<n; ++i) {
+        pos[i] = (float)mesh.vertices[i].x;
+        pos[n + i] = (float)mesh.vertices[i].y;
+        pos[2*n + i] = (float)mesh.vertices[i].z;
+    }
+    if (h.uvOffset) {
+        float* uv = reinterpret_cast<float*>(&buf[h.uvOffset]);
+        for (uint64_t i=0; i<n; ++i) { uv[i] = (float)mesh.uv[i].x; uv[n + i] = (float)mesh.uv[i].y; }
+    }
+    if (h.colorOffset) {
+        float* c = reinterpret_cast<float*>(&buf[h.colorOffset]);
+        for (uint64_t i=0; i<n; ++i) {
+            c[i] = (float)mesh.colors[i].x; c[n + i] = (float)mesh.colors[i].y; c[2*n + i] = (float)mesh.colors[i].z;
+        }
+    }
+    uint32_t* start = h.faceOffset ? reinterpret_cast<uint32_t*>(&buf[h.faceOffset]) : nullptr;
+    uint32_t* idx = reinterpret_cast<uint32_t*>(&buf[h.indexOffset]);
+    uint32_t k = 0;
+    for (uint64_t f=0; f<h.faceCount; ++f) {
+        if (start) start[f] = k;
+        for (int v : mesh.faces[f].indices) idx[k++] = (uint32_t)v;
+    }
+    if (start) start[h.faceCount] = k;
+
+    h.checksum = checksum(buf.data() + sizeof(Header), buf.size() - sizeof(Header));
+    std::memcpy(buf.data(), &h, sizeof h);
+
+    // Write beside the target and rename, so a reader never sees half a file
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream ofs(tmp, std::ios::binary);
+        if (!ofs) throw std::runtime_error("MeshCache: cannot open file " + tmp);
+        ofs.write(reinterpret_cast<const char*>(buf.data()), (std::streamsize)buf.size());
+        if (!ofs) throw std::runtime_error("MeshCache: write failed " + tmp);
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("MeshCache: cannot rename to " + path);
+}
+
+// A cache file mapped read-only. Arrays point straight into the mapping
+// and stay valid while the object lives.
+class MappedMesh {
+public:
+    MappedMesh() = default;
+    MappedMesh(const MappedMesh&) = delete;
+    MappedMesh& operator=(const MappedMesh&) = delete;
+    ~MappedMesh() { close(); }
+
+    // False if the file is missing, not this format or version, written
+    // for another key (unless key is 0), malformed (a section outside the
+    // file, face offsets or vertex indices out of range) or (with verify)
+    // fails its checksum. The structure is checked with or without verify.
+    bool open(const std::string& path, uint64_t key = 0, bool verify = true) {
+        close();
+        if (!map(path)) return false;
+        if (size < sizeof(Header)) { close(); return false; }
+        std::memcpy(&h, base, sizeof h);
+        bool ok = h.magic == kMagic && h.version == kVersion && h.fileSize == size
+               && (key == 0 || h.key == key) && valid();
+        if (ok && verify) ok = checksum(base + sizeof(Header), size - sizeof(Header)) == h.checksum;
+        if (!ok) close();
+        return ok;
+    }
+
+    bool is_open() const { return base != nullptr; }
+    const Header& header() const { return h; }
+    size_t vertex_count() const { return (size_t)h.vertexCount; }
+    size_t face_count() const { return (size_t)h.faceCount; }
+    size_t index_count() const { return (size_t)h.indexCount; }
+
+    const float* x() const { return f32(h.posOffset); }
+    const float* y() const { return f32(h.posOffset) + h.vertexCount; }
+    const float* z() const { return f32(h.posOffset) + 2 * h.vertexCount; }
+    const float* u() const { return h.uvOffset ? f32(h.uvOffset) : nullptr; }
+    const float* v() const { return h.uvOffset ? f32(h.uvOffset) + h.vertexCount : nullptr; }
+    const float* color(int channel) const {
+        return h.colorOffset ? f32(h.colorOffset) + channel * h.vertexCount : nullptr;
+    }
+    const uint32_t* indices() const { return u32(h.indexOffset); }
+    // Face f uses indices()[face_begin(f) .. face_begin(f+1))
+    size_t face_begin(size_t f) const { return h.faceOffset ? u32(h.faceOffset)[f] : 3 * f; }
+
+    Mesh3D to_mesh() const {
+        Mesh3D m;
+        const size_t n = vertex_count();
+        m.vertices.resize(n);
+        const float *px = x(), *py = y(), *pz = z();
+        for (size_t i=0; i<n; ++i) m.vertices[i] = Point3D(px[i], py[i], pz[i]);
+        if (h.uvOffset) {
+            m.uv.resize(n);
+            for (size_t i=0; i<n; ++i) m.uv[i] = Point2D(u()[i], v()[i]);
+        }
+        if (h.colorOffset) {
+            m.colors.resize(n);
+            const float *r = color(0), *g = color(1), *b = color(2);
+            for (size_t i=0; i<n; ++i) m.colors[i] = Point3D(r[i], g[i], b[i]);
+        }
+        m.faces.resize(face_count());
+        const uint32_t* idx = indices();
+        for (size_t f=0; f<m.faces.size(); ++f)
+            m.faces[f].indices.assign(idx + face_begin(f), idx + face_begin(f + 1));
+        return m;
+    }
+
+    void close() {
+#ifdef MESHCACHE_MMAP
+        if (base) munmap(const_cast<uint8_t*>(base), size);
+#endif
+        base = nullptr;
+        size = 0;
+        fallback.clear();
+    }
+
+private:
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    Header h{};
+    std::vector<uint64_t> fallback;     // file contents where mmap is unavailable
+
+    // count elements of elemSize bytes at off lie inside the file, after
+    // the header and on a 64-byte boundary (no overflow for any header)
+    bool section(uint64_t off, uint64_t count, uint64_t elemSize) const {
+        return off >= sizeof(Header) && off % 64 == 0 && off <= size
+            && count <= (size - off) / elemSize;
+    }
+
+    bool valid() const {
+        const uint64_t n = h.vertexCount;
+        const bool tris = (h.flags & kTriangles) != 0;
+        if (!section(h.posOffset, n, 3 * sizeof(float))) return false;
+        if (((h.flags & kHasUV) != 0) != (h.uvOffset != 0)) return false;
+        if (h.uvOffset && !section(h.uvOffset, n, 2 * sizeof(float))) return false;
+        if (((h.flags & kHasColor) != 0) != (h.colorOffset != 0)) return false;
+        if (h.colorOffset && !section(h.colorOffset, n, 3 * sizeof(float))) return false;
+        if (!section(h.indexOffset, h.indexCount, sizeof(uint32_t))) return false;
+        if (tris) {
+            if (h.faceOffset != 0 || h.faceCount > h.indexCount / 3 || h.indexCount != 3 * h.faceCount) return false;
+        } else {
+            if (h.faceOffset == 0 || h.faceCount >= size || !section(h.faceOffset, h.faceCount + 1, sizeof(uint32_t)))
+                return false;
+            // Offsets run from 0 to indexCount without going back
+            const uint32_t* start = u32(h.faceOffset);
+            if (start[0] != 0 || start[h.faceCount] != h.indexCount) return false;
+            for (uint64_t f=0; f<h.faceCount; ++f)
+                if (start[f] > start[f + 1]) return false;
+        }
+        const uint32_t* idx = u32(h.indexOffset);
+        for (uint64_t i=0; i<h.indexCount; ++i)
+            if (idx[i] >= n) return false;
+        return true;
+    }
+
+    const float* f32(uint64_t off) const { return reinterpret_cast<const float*>(base + off); }
+    const uint32_t* u32(uint64_t off) const { return reinterpret_cast<const uint32_t*>(base + off); }
+
+    bool map(const std::string& path) {
+#ifdef MESHCACHE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) { ::close(fd); return false; }
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        base = static_cast<const uint8_t*>(p);
+        size = (size_t)st.st_size;
+        return true;
+#else
+        std::ifstream ifs(path, std::ios::binary | std::ios::ate);
+        if (!ifs) return false;
+        size_t n = (size_t)ifs.tellg();
+        fallback.assign((n + 7) / 8, 0);
+        ifs.seekg(0);
+        if (!ifs.read(reinterpret_cast<char*>(fallback.data()), (std::streamsize)n)) return false;
+        // Only used from the fallback branch of close(): nothing to unmap
+        base = reinterpret_cast<const uint8_t*>(fallback.data());
+        size = n;
+        return true;
+#endif
+    }
+};
+
+// The cached mesh for `key` if `path` holds one, otherwise build() it and
+// cache the result. `key` should change with anything that changes the
+// mesh (builder parameters, format of the inputs).
+template<typename Build>
+Mesh3D load_or_build(const std::string& path, uint64_t key, Build&& build) {
+    {
+        MappedMesh mm;
+        if (mm.open(path, key)) return mm.to_mesh();
+    }
+    Mesh3D m = build();
+    save(m, path, key);
+    return m;
+}
+
+} // namespace MeshCache
@@ -0,0 +1,705 @@
+#pragma once
+#include "Mesh3D.hpp"
+#include "ParallelFor.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cctype>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Importers for Wavefront OBJ and Stanford PLY (ascii and binary).
+//
+// Files are streamed in blocks of kBlock bytes per worker thread. Each
+// block is cut at line breaks into one range per worker, the ranges are
+// parsed in parallel (numbers with std::from_chars) and merged in file
+// order, so only one block of the file is held at a time.
+//
+// OBJ: v (x y z, optionally followed by r g b), vt and f are read; vn is
+// only counted, since Mesh3D has no normals, but corners with different
+// normals stay separate vertices so hard edges survive
+// compute_vertex_normals. Each distinct v/vt/vn corner becomes one
+// vertex, looked up in a hash table. Relative (negative) indices work and
+// N-gons are kept. Other statements (o, g, s, usemtl, ...) are ignored.
+//
+// PLY: element vertex (x y z; u v, s t or texture_u texture_v; red green
+// blue) and element face (vertex_indices or vertex_index list); other
+// elements and properties are skipped.
+//
+// Malformed input throws std::runtime_error("MeshImport: ...").
+namespace MeshImport {
+
+constexpr size_t kBlock = size_t(8) << 20;      // bytes per worker per block
+
+namespace detail {
+
+struct FileCloser { void operator()(FILE* f) const { std::fclose(f); } };
+using File = std::unique_ptr<FILE, FileCloser>;
+
+inline File open_file(const std::string& path) {
+    File f(std::fopen(path.c_str(), "rb"));
+    if (!f) throw std::runtime_error("MeshImport: cannot open file " + path);
+    return f;
+}
+
+inline int worker_count(int threads) {
+    return threads > 0 ? threads : (int)std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Reads a file from its current position in blocks of whole lines
+class LineBlocks {
+public:
+    LineBlocks(FILE* f, size_t blockSize) : f(f), blockSize(blockSize) {}
+
+    // The next block in [data, data+len); false at the end of the file
+    bool next(const char*& data, size_t& len) {
+        buf.erase(0, used);
+        used = 0;
+        size_t end = std::string::npos;
+        while (!eof) {
+            size_t old = buf.size();
+            buf.resize(old + blockSize);
+            size_t got = std::fread(&buf[old], 1, blockSize, f);
+            buf.resize(old + got);
+            eof = got < blockSize;
+            end = buf.rfind('\n');
+            if (end != std::string::npos) break;        // else a line longer than a block
+        }
+        if (buf.empty()) return false;
+        used = eof ? buf.size() : end + 1;
+        data = buf.data();
+        len = used;
+        return true;
+    }
+
+private:
+    FILE* f;
+    size_t blockSize;
+    std::string buf;
+    size_t used = 0;
+    bool eof = false;
+};
+
+// [begin,end) offsets of up to `parts` ranges of whole lines covering [0,n)
+inline std::vector<std::pair<size_t,size_t>> split_lines(const char* d, size_t n, int parts) {
+    std::vector<std::pair<size_t,size_t>> out;
+    size_t b = 0;
+    for (int k=0; k<parts && b<n; ++k) {
+        size_t e = k == parts-1 ? n : std::min(n, b + n / parts);
+        if (e < n) {
+            const void* nl = std::memchr(d + e, '\n', n - e);
+            e = nl ? (size_t)(static_cast<const char*>(nl) - d) + 1 : n;
+        }
+        out.push_back({ b, e });
+        b = e;
+    }
+    return out;
+}
+
+template<typename Fn>
+void for_each_line(const char* p, const char* e, Fn&& fn) {
+    while (p < e) {
+        const char* nl = static_cast<const char*>(std::memchr(p, '\n', e - p));
+        const char* le = nl ? nl : e;
+        if (le > p && le[-1] == '\r') fn(p, le - 1); else fn(p, le);
+        p = nl ? nl + 1 : e;
+    }
+}
+
+inline const char* skip_ws(const char* p, const char* e) {
+    while (p < e && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    return p;
+}
+
+// Parse one number after optional blanks, advancing p; false on failure
+template<typename T>
+bool number(const char*& p, const char* e, T& out) {
+    p = skip_ws(p, e);
+    if (p < e && *p == '+') ++p;
+    auto r = std::from_chars(p, e, out);
+    if (r.ec != std::errc()) return false;
+    p = r.ptr;
+    return true;
+}
+
+// ---- OBJ ----------------------------------------------------------------
+
+// Corner references as parsed: 0-based absolute indices, kNone, or indices
+// relative to the end of the range's own data, offset by -kRel
+constexpr long long kNone = LLONG_MIN;
+constexpr long long kRel  = 1LL << 40;
+
+struct ObjPart {
+    std::vector<double> pos;            // x y z per v
+    std::vector<float>  col;            // r g b per v, once some v had a color
+    bool colored = false;
+    std::vector<double> tex;            // u v per vt
+    long long normals = 0;              // vn count
+    std::vector<int> faceSize;
+    std::vector<long long> refs;        // v vt vn per corner
+    std::string error;
+
+    void clear() {
+        pos.clear(); col.clear(); colored = false; tex.clear(); normals = 0;
+        faceSize.clear(); refs.clear(); error.clear();
+    }
+};
+
+inline void parse_obj(const char* begin, const char* end, ObjPart& part) {
+    auto fail = [&](const char* p, const char* e) {
+        if (part.error.empty()) part.error = "MeshImport: bad OBJ line: " + std::string(p, std::min<size_t>(e - p, 60));
+    };
+    auto ref = [](long long i, long long count) { return i > 0 ? i - 1 : count + i - kRel; };
+
+    for_each_line(begin, end, [&](const char* line, const char* e) {
+        if (!part.error.empty()) return;
+        const char* p = skip_ws(line, e);
+        if (e - p < 2 || (p[1] != ' ' && p[1] != '\t' && p[0] != 'v')) return;
+        if (p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+            p += 2;
+            double x, y, z, c[3];
+            if (!number(p, e, x) || !number(p, e, y) || !number(p, e, z)) return fail(line, e);
+            int extra = 0;
+            while (extra < 3 && number(p, e, c[extra])) ++extra;
+            const size_t nv = part.pos.size() / 3;
+            part.pos.insert(part.pos.end(), { x, y, z });
+            if (extra == 3 && !part.colored) { part.col.assign(3 * nv, 1.0f); part.colored = true; }
+            if (part.colored) {
+                if (extra == 3) part.col.insert(part.col.end(), { (float)c[0], (float)c[1], (float)c[2] });
+                else part.col.insert(part.col.end(), { 1.0f, 1.0f, 1.0f });
+            }
+        } else if (p[0] == 'v' && p[1] == 't') {
+            p += 2;
+            double u, v = 0.0;
+            if (!number(p, e, u)) return fail(line, e);
+            number(p, e, v);
+            part.tex.insert(part.tex.end(), { u, v });
+        } else if (p[0] == 'v' && p[1] == 'n') {
+            ++part.normals;
+        } else if (p[0] == 'f') {
+            p += 1;
+            const long long nv = part.pos.size() / 3, nt = part.tex.size() / 2;
+            int n = 0;
+            for (p = skip_ws(p, e); p < e; p = skip_ws(p, e)) {
+                long long v, t = kNone, vn = kNone, i;
+                if (!number(p, e, v) || v == 0) return fail(line, e);
+                if (p < e && *p == '/') {
+                    ++p;
+                    if (p < e && *p != '/') {
+                        if (!number(p, e, i) || i == 0) return fail(line, e);
+                        t = ref(i, nt);
+                    }
+                    if (p < e && *p == '/') {
+                        ++p;
+                        if (!number(p, e, i) || i == 0) return fail(line, e);
+                        vn = ref(i, part.normals);
+                    }
+                }
+                if (p < e && *p != ' ' && *p != '\t') return fail(line, e);
+                part.refs.insert(part.refs.end(), { ref(v, nv), t, vn });
+                ++n;
+            }
+            part.faceSize.push_back(n);
+        }
+    });
+}
+
+// Open-addressing map from a v/vt/vn corner to its vertex
+class CornerTable {
+public:
+    template<typename Make>
+    int find_or_add(int v, int t, int n, Make&& make) {
+        if (2 * (count + 1) > slots.size()) grow();
+        for (size_t h = hash(v, t, n) & mask; ; h = (h + 1) & mask) {
+            Slot& s = slots[h];
+            if (s.v < 0) { s = Slot{ v, t, n, make() }; ++count; return s.id; }
+            if (s.v == v && s.t == t && s.n == n) return s.id;
+        }
+    }
+
+private:
+    struct Slot { int v = -1, t = 0, n = 0, id = 0; };
+    std::vector<Slot> slots;
+    size_t count = 0, mask = 0;
+
+    static size_t hash(int v, int t, int n) {
+        uint64_t x = (uint32_t)v * 0x9E3779B97F4A7C15ull ^ (uint32_t)t * 0xC2B2AE3D27D4EB4Full
+                   ^ (uint32_t)n * 0x165667B19E3779F9ull;
+        return (size_t)(x ^ (x >> 29));
+    }
+    void grow() {
+        std::vector<Slot> old(std::max<size_t>(1024, 2 * slots.size()));
+        old.swap(slots);
+        mask = slots.size() - 1;
+        for (const Slot& s : old) {
+            if (s.v < 0) continue;
+            size_t h = hash(s.v, s.t, s.n) & mask;
+            while (slots[h].v >= 0) h = (h + 1) & mask;
+            slots[h] = s;
+        }
+    }
+};
+
+// Appends parsed ranges in file order and builds the mesh
+class ObjMerge {
+public:
+    void add(const ObjPart& part) {
+        const long long vb = (long long)P.size() / 3, tb = (long long)T.size() / 2, nb = N;
+        if (part.colored && !colored) { C.assign(P.size(), 1.0f); colored = true; }
+        if (colored) {
+            if (!part.colored) C.resize(C.size() + part.pos.size(), 1.0f);
+            else C.insert(C.end(), part.col.begin(), part.col.end());
+        }
+        P.insert(P.end(), part.pos.begin(), part.pos.end());
+        T.insert(T.end(), part.tex.begin(), part.tex.end());
+        N += part.normals;
+        if (P.size() / 3 > (size_t)INT_MAX) throw std::runtime_error("MeshImport: too many vertices");
+        direct.resize(P.size() / 3, -1);
+
+        auto resolve = [](long long r, long long base, long long count) -> int {
+            if (r == kNone) return -1;
+            long long i = r < 0 ? r + kRel + base : r;
+            if (i < 0 || i >= count) throw std::runtime_error("MeshImport: OBJ index out of range");
+            return (int)i;
+        };
+        const long long nv = (long long)P.size() / 3, nt = (long long)T.size() / 2;
+        const long long* r = part.refs.data();
+        for (int n : part.faceSize) {
+            if (n < 3) { r += 3 * n; continue; }
+            Face f;
+            f.indices.resize(n);
+            for (int k=0; k<n; ++k, r += 3) {
+                int v = resolve(r[0], vb, nv), t = resolve(r[1], tb, nt), vn = resolve(r[2], nb, N);
+                // The first corner made at each v is found without hashing;
+                // only further ones (UV or normal seams) go to the table
+                int& d = direct[v];
+                if (d < 0) d = vertex(v, t, vn);
+                if (srcT[d] == t && srcN[d] == vn) f.indices[k] = d;
+                else f.indices[k] = table.find_or_add(v, t, vn, [&] { return vertex(v, t, vn); });
+            }
+            mesh.faces.push_back(std::move(f));
+        }
+    }
+
+    Mesh3D finish() {
+        if (!anyUV) mesh.uv.clear();
+        if (colored) {
+            mesh.colors.resize(src.size());
+            for (size_t i=0; i<src.size(); ++i)
+                mesh.colors[i] = Point3D(C[3*src[i]], C[3*src[i] + 1], C[3*src[i] + 2]);
+        }
+        return std::move(mesh);
+    }
+
+private:
+    std::vector<double> P, T;
+    std::vector<float> C;
+    long long N = 0;
+    std::vector<int> direct;            // first vertex made at each v
+    CornerTable table;                  // the others
+    std::vector<int> src, srcT, srcN;   // v, vt, vn of each vertex
+    bool anyUV = false, colored = false;
+    Mesh3D mesh;
+
+    int vertex(int v, int t, int vn) {
+        mesh.vertices.emplace_back(P[3*v], P[3*v + 1], P[3*v + 2]);
+        mesh.uv.push_back(t >= 0 ? Point2D(T[2*t], T[2*t + 1]) : Point2D(0, 0));
+        anyUV |= t >= 0;
+        src.push_back(v);
+        srcT.push_back(t);
+        srcN.push_back(vn);
+        return (int)mesh.vertices.size() - 1;
+    }
+};
+
+// ---- PLY ----------------------------------------------------------------
+
+enum class PlyType { Int8, UInt8, Int16, UInt16, Int32, UInt32, Float32, Float64 };
+
+inline PlyType ply_type(const std::string& s) {
+    if (s == "char"   || s == "int8")    return PlyType::Int8;
+    if (s == "uchar"  || s == "uint8")   return PlyType::UInt8;
+    if (s == "short"  || s == "int16")   return PlyType::Int16;
+    if (s == "ushort" || s == "uint16")  return PlyType::UInt16;
+    if (s == "int"    || s == "int32")   return PlyType::Int32;
+    if (s == "uint"   || s == "uint32")  return PlyType::UInt32;
+    if (s == "float"  || s == "float32") return PlyType::Float32;
+    if (s == "double" || s == "float64") return PlyType::Float64;
+    throw std::runtime_error("MeshImport: unknown PLY type " + s);
+}
+
+inline size_t ply_size(PlyType t) {
+    switch (t) {
+        case PlyType::Int8: case PlyType::UInt8: return 1;
+        case PlyType::Int16: case PlyType::UInt16: return 2;
+        case PlyType::Int32: case PlyType::UInt32: case PlyType::Float32: return 4;
+        default: return 8;
+    }
+}
+
+template<typename T>
+T ply_load(const char* p, bool swap) {
+    char b[sizeof(T)];
+    std::memcpy(b, p, sizeof(T));
+    if (swap) std::reverse(b, b + sizeof(T));
+    T v;
+    std::memcpy(&v, b, sizeof(T));
+    return v;
+}
+
+inline double ply_read(const char* p, PlyType t, bool swap) {
+    switch (t) {
+        case PlyType::Int8:    return (int8_t)*p;
+        case PlyType::UInt8:   return (uint8_t)*p;
+        case PlyType::Int16:   return ply_load<int16_t>(p, swap);
+        case PlyType::UInt16:  return ply_load<uint16_t>(p, swap);
+        case PlyType::Int32:   return ply_load<int32_t>(p, swap);
+        case PlyType::UInt32:  return ply_load<uint32_t>(p, swap);
+        case PlyType::Float32: return ply_load<float>(p, swap);
+        default:               return ply_load<double>(p, swap);
+    }
+}
+
+struct PlyProperty {
+    std::string name;
+    PlyType type;
+    bool list = false;
+    PlyType countType = PlyType::UInt8;
+};
+
+struct PlyElement {
+    std::string name;
+    size_t count = 0;
+    std::vector<PlyProperty> props;
+
+    bool fixed() const { return std::none_of(props.begin(), props.end(), [](const PlyProperty& p) { return p.list; }); }
+    size_t stride() const {
+        size_t s = 0;
+        for (const auto& p : props) s += ply_size(p.type);
+        return s;
+    }
+};
+
+// Which vertex properties feed the mesh: slot 0-2 position, 3-4 uv, 5-7 color
+struct PlyVertexLayout {
+    std::vector<int> slot;              // per property, -1 if unused
+    std::vector<double> scale;          // per property: 1/255 etc. for integer colors
+    bool hasUV = false, hasColor = false;
+
+    explicit PlyVertexLayout(const PlyElement& el) {
+        static const char* names[][3] = {
+            { "x", 0, 0 }, { "y", 0, 0 }, { "z", 0, 0 },
+            { "u", "s", "texture_u" }, { "v", "t", "texture_v" },
+            { "red", "r", "diffuse_red" }, { "green", "g", "diffuse_green" }, { "blue", "b", "diffuse_blue" } };
+        int found = 0;
+        for (const auto& p : el.props) {
+            int s = -1;
+            for (int k=0; k<8 && s<0; ++k)
+                for (const char* n : names[k])
+                    if (n && !p.list && p.name == n && !(found & (1 << k))) { s = k; break; }
+            if (s >= 0) found |= 1 << s;
+            slot.push_back(s);
+            double sc = 1.0;
+            if (s >= 5) {
+                if (p.type == PlyType::UInt8 || p.type == PlyType::Int8) sc = 1.0 / 255.0;
+                else if (p.type == PlyType::UInt16 || p.type == PlyType::Int16) sc = 1.0 / 65535.0;
+            }
+            scale.push_back(sc);
+        }
+        if ((found & 7) != 7) throw std::runtime_error("MeshImport: PLY vertex without x, y, z");
+        hasUV = (found & 0x18) == 0x18;
+        hasColor = (found & 0xE0) == 0xE0;
+    }
+
+    void store(Mesh3D& m, size_t i, const double* v) const {
+        m.vertices[i] = Point3D(v[0], v[1], v[2]);
+        if (hasUV) m.uv[i] = Point2D(v[3], v[4]);
+        if (hasColor) m.colors[i] = Point3D(v[5], v[6], v[7]);
+    }
+};
+
+inline bool is_face_list(const PlyProperty& p) {
+    return p.list && (p.name == "vertex_indices" || p.name == "vertex_index");
+}
+
+// Buffered reads of n bytes at a time from a binary stream
+class ByteReader {
+public:
+    explicit ByteReader(FILE* f) : f(f) {}
+    const char* take(size_t n) {
+        if (buf.size() - pos < n) {
+            buf.erase(0, pos);
+            pos = 0;
+            size_t want = std::max(n - buf.size(), kBlock);
+            size_t old = buf.size();
+            buf.resize(old + want);
+            buf.resize(old + std::fread(&buf[old], 1, want, f));
+            if (buf.size() < n) throw std::runtime_error("MeshImport: PLY file is truncated");
+        }
+        const char* p = buf.data() + pos;
+        pos += n;
+        return p;
+    }
+private:
+    FILE* f;
+    std::string buf;
+    size_t pos = 0;
+};
+
+struct PlyFacePart {
+    std::vector<int> faceSize;
+    std::vector<long long> index;
+    std::string error;
+};
+
+} // namespace detail
+
+// Read an OBJ file; threads <= 0 uses every hardware thread
+inline Mesh3D load_obj(const std::string& path, int threads = 0) {
+    auto f = detail::open_file(path);
+    const int workers = detail::worker_count(threads);
+    detail::LineBlocks blocks(f.get(), kBlock * workers);
+    detail::ObjMerge merge;
+    std::vector<detail::ObjPart> parts(workers);
+    const char* data;
+    size_t len;
+    while (blocks.next(data, len)) {
+        auto ranges = detail::split_lines(data, len, workers);
+        parallel_for(0, (int)ranges.size(), [&](int b, int e) {
+            for (int i=b; i<e; ++i) {
+                parts[i].clear();
+                detail::parse_obj(data + ranges[i].first, data + ranges[i].second, parts[i]);
+            }
+        }, workers);
+        for (size_t i=0; i<ranges.size(); ++i) {
+            if (!parts[i].error.empty()) throw std::runtime_error(parts[i].error);
+            merge.add(parts[i]);
+        }
+    }
+    return merge.finish();
+}
+
+// Read an ascii or binary PLY file; threads <= 0 uses every hardware thread
+inline Mesh3D load_ply(const std::string& path, int threads = 0) {
+    using namespace detail;
+    auto f = open_file(path);
+    const int workers = worker_count(threads);
+
+    // Header
+    auto getline = [&](std::string& line) {
+        line.clear();
+        for (int c; (c = std::fgetc(f.get())) != EOF && c != '\n'; ) if (c != '\r') line += (char)c;
+        return !std::feof(f.get()) || !line.empty();
+    };
+    std::string line;
+    if (!getline(line) || line != "ply") throw std::runtime_error("MeshImport: not a PLY file " + path);
+    enum { Ascii, Little, Big } format = Ascii;
+    std::vector<PlyElement> elements;
+    while (true) {
+        if (!getline(line)) throw std::runtime_error("MeshImport: PLY header has no end_header");
+        std::vector<std::string> w;
+        for (size_t i=0; i<line.size(); ) {
+            size_t j = line.find_first_of(" \t", i);
+            if (j == std::string::npos) j = line.size();
+            if (j > i) w.push_back(line.substr(i, j - i));
+            i = j + 1;
+        }
+        if (w.empty() || w[0] == "comment" || w[0] == "obj_info") continue;
+        if (w[0] == "end_header") break;
+        if (w[0] == "format" && w.size() >= 2) {
+            if (w[1] == "ascii") format = Ascii;
+            else if (w[1] == "binary_little_endian") format = Little;
+            else if (w[1] == "binary_big_endian") format = Big;
+            else throw std::runtime_error("MeshImport: unknown PLY format " + w[1]);
+        } else if (w[0] == "element" && w.size() == 3) {
+            PlyElement el;
+            el.name = w[1];
+            el.count = std::stoull(w[2]);
+            elements.push_back(el);
+        } else if (w[0] == "property" && !elements.empty()) {
+            PlyProperty p;
+            if (w.size() == 5 && w[1] == "list") {
+                p.list = true;
+                p.countType = ply_type(w[2]);
+                p.type = ply_type(w[3]);
+                p.name = w[4];
+            } else if (w.size() == 3) {
+                p.type = ply_type(w[1]);
+                p.name = w[2];
+            } else {
+                throw std::runtime_error("MeshImport: bad PLY property: " + line);
+            }
+            elements.back().props.push_back(p);
+        } else {
+            throw std::runtime_error("MeshImport: bad PLY header line: " + line);
+        }
+    }
+
+    Mesh3D mesh;
+    size_t nv = 0;
+    const PlyElement* vertexEl = nullptr;
+    for (const auto& el : elements) if (el.name == "vertex") { vertexEl = &el; nv = el.count; }
+    if (!vertexEl) throw std::runtime_error("MeshImport: PLY file has no vertex element");
+    if (nv > (size_t)INT_MAX) throw std::runtime_error("MeshImport: too many vertices");
+    const PlyVertexLayout layout(*vertexEl);
+    mesh.vertices.resize(nv);
+    if (layout.hasUV) mesh.uv.resize(nv);
+    if (layout.hasColor) mesh.colors.resize(nv);
+
+    auto add_faces = [&](const PlyFacePart& part) {
+        if (!part.error.empty()) throw std::runtime_error(part.error);
+        const long long* ix = part.index.data();
+        for (int n : part.faceSize) {
+            Face fc;
+            fc.indices.resize(n);
+            for (int k=0; k<n; ++k) {
+                if (ix[k] < 0 || ix[k] >= (long long)nv) throw std::runtime_error("MeshImport: PLY index out of range");
+                fc.indices[k] = (int)ix[k];
+            }
+            ix += n;
+            if (n >= 3) mesh.faces.push_back(std::move(fc));
+        }
+    };
+
+    if (format == Ascii) {
+        // Line k of the body belongs to the element whose range holds k
+        std::vector<size_t> first(elements.size() + 1, 0);
+        for (size_t i=0; i<elements.size(); ++i) first[i + 1] = first[i] + elements[i].count;
+
+        LineBlocks blocks(f.get(), kBlock * workers);
+        std::vector<PlyFacePart> parts(workers);
+        size_t lineNo = 0;
+        const char* data;
+        size_t len;
+        while (blocks.next(data, len)) {
+            auto ranges = split_lines(data, len, workers);
+            std::vector<size_t> start(ranges.size() + 1, lineNo);
+            for (size_t i=0; i<ranges.size(); ++i) {
+                const char* b = data + ranges[i].first;
+                const char* e = data + ranges[i].second;
+                size_t n = std::count(b, e, '\n') + (e[-1] != '\n');
+                start[i + 1] = start[i] + n;
+            }
+            parallel_for(0, (int)ranges.size(), [&](int b, int e) {
+                std::vector<double> vals(8, 0.0);
+                for (int i=b; i<e; ++i) {
+                    PlyFacePart& part = parts[i];
+                    part.faceSize.clear(); part.index.clear(); part.error.clear();
+                    size_t k = start[i];
+                    for_each_line(data + ranges[i].first, data + ranges[i].second, [&](const char* p, const char* le) {
+                        const size_t row = k++;
+                        if (!part.error.empty() || row >= first.back()) return;
+                        size_t el = std::upper_bound(first.begin(), first.end(), row) - first.begin() - 1;
+                        const PlyElement& E = elements[el];
+                        const bool isVertex = &E == vertexEl, isFace = E.name == "face";
+                        if (!isVertex && !isFace) return;
+                        int corners = -1;
+                        for (size_t j=0; j<E.props.size(); ++j) {
+                            const PlyProperty& pr = E.props[j];
+                            double v;
+                            if (!number(p, le, v)) { part.error = "MeshImport: bad PLY line " + std::to_string(row + 1); return; }
+                            if (!pr.list) {
+                                if (isVertex && layout.slot[j] >= 0) vals[layout.slot[j]] = v * layout.scale[j];
+                                continue;
+                            }
+                            const bool take = isFace && corners < 0 && is_face_list(pr);
+                            for (long long c=0, n=(long long)v; c<n; ++c) {
+                                double x;
+                                if (!number(p, le, x)) { part.error = "MeshImport: bad PLY line " + std::to_string(row + 1); return; }
+                                if (take) part.index.push_back((long long)x);
+                            }
+                            if (take) corners = (int)v;
+                        }
+                        if (isVertex) layout.store(mesh, row - first[el], vals.data());
+                        else if (corners >= 0) part.faceSize.push_back(corners);
+                    });
+                }
+            }, workers);
+            for (size_t i=0; i<ranges.size(); ++i) add_faces(parts[i]);
+            lineNo = start.back();
+        }
+        if (lineNo < first.back()) throw std::runtime_error("MeshImport: PLY file is truncated");
+        return mesh;
+    }
+
+    // Binary
+    const bool swap = (format == Big) == (ply_load<uint16_t>("\x01\x00", false) == 1);
+    ByteReader in(f.get());
+    for (const auto& E : elements) {
+        const bool isVertex = &E == vertexEl;
+        if (E.fixed()) {
+            // Fixed-size records: decode batches in parallel
+            const size_t stride = E.stride();
+            std::vector<size_t> offset;
+            for (size_t j=0, s=0; j<E.props.size(); s += ply_size(E.props[j++].type)) offset.push_back(s);
+            const size_t batch = std::max<size_t>(1, kBlock * workers / std::max<size_t>(1, stride));
+            for (size_t done=0; done<E.count; ) {
+                const size_t n = std::min(batch, E.count - done);
+                const char* base = in.take(n * stride);
+                if (isVertex) {
+                    parallel_for(0, (int)n, [&](int b, int e) {
+                        double vals[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+                        for (int i=b; i<e; ++i) {
+                            const char* rec = base + (size_t)i * stride;
+                            for (size_t j=0; j<E.props.size(); ++j)
+                                if (layout.slot[j] >= 0)
+                                    vals[layout.slot[j]] = ply_read(rec + offset[j], E.props[j].type, swap) * layout.scale[j];
+                            layout.store(mesh, done + i, vals);
+                        }
+                    }, workers, 4096);
+                }
+                done += n;
+            }
+            continue;
+        }
+        // Records with lists are read one at a time
+        const bool isFace = E.name == "face";
+        double vals[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+        if (isFace) mesh.faces.reserve(mesh.faces.size() + E.count);
+        for (size_t r=0; r<E.count; ++r) {
+            Face fc;
+            bool got = false;
+            for (size_t j=0; j<E.props.size(); ++j) {
+                const PlyProperty& p = E.props[j];
+                if (!p.list) {
+                    double v = ply_read(in.take(ply_size(p.type)), p.type, swap);
+                    if (isVertex && layout.slot[j] >= 0) vals[layout.slot[j]] = v * layout.scale[j];
+                    continue;
+                }
+                const long long n = (long long)ply_read(in.take(ply_size(p.countType)), p.countType, swap);
+                if (n < 0) throw std::runtime_error("MeshImport: bad PLY list length");
+                const size_t sz = ply_size(p.type);
+                const char* items = in.take(n * sz);
+                if (isFace && !got && is_face_list(p)) {
+                    fc.indices.resize(n);
+                    for (long long c=0; c<n; ++c) {
+                        long long ix = (long long)ply_read(items + c * sz, p.type, swap);
+                        if (ix < 0 || ix >= (long long)nv) throw std::runtime_error("MeshImport: PLY index out of range");
+                        fc.indices[c] = (int)ix;
+                    }
+                    got = true;
+                }
+            }
+            if (isVertex) layout.store(mesh, r, vals);
+            else if (fc.indices.size() >= 3) mesh.faces.push_back(std::move(fc));
+        }
+    }
+    return mesh;
+}
+
+// load_obj or load_ply by the file's extension
+inline Mesh3D load_mesh(const std::string& path, int threads = 0) {
+    std::string ext = path.substr(path.find_last_of('.') == std::string::npos ? path.size() : path.find_last_of('.'));
+    for (char& c : ext) c = (char)std::tolower((unsigned char)c);
+    if (ext == ".obj") return load_obj(path, threads);
+    if (ext == ".ply") return load_ply(path, threads);
+    throw std::runtime_error("MeshImport: unknown mesh format " + path);
+}
+
+} // namespace MeshImport
@@ -0,0 +1,126 @@
+#pragma once
+#include "MeshBuilders.hpp"
+#include "View3DParameters.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Resolutions of one shape, finest first. `error` is the widest gap
+// between the mesh and the true surface, as a fraction of `radius`.
+struct LODChain {
+    struct Level {
+        Mesh3D mesh;
+        double error = 0.0;
+        size_t triangles = 0;
+    };
+    std::vector<Level> levels;
+    double radius = 1.0;            // bounding radius around the origin
+
+    void add(Mesh3D mesh) {
+        Level l;
+        l.mesh = std::move(mesh);
+        for (const auto& f : l.mesh.faces) {
+            if (f.indices.size() < 3) continue;
+            l.triangles += f.indices.size() - 2;
+            // Sag of the face: radius minus the distance of its plane from the centre
+            Point3D n = l.mesh.face_normal(f);
+            double len = std::sqrt(n.x*n.x + n.y*n.y + n.z*n.z);
+            if (len == 0.0) continue;
+            Point3D c(0,0,0);
+            for (int vi : f.indices) c = c + l.mesh.vertices[vi];
+            c = c * (1.0 / f.indices.size());
+            double d = std::fabs(n.x*c.x + n.y*c.y + n.z*c.z) / len;
+            l.error = std::max(l.error, (radius - d) / radius);
+        }
+        levels.push_back(std::move(l));
+    }
+};
+
+// `count` UV spheres, halving rows and columns from the finest
+inline LODChain make_uv_sphere_lods(int rows=32, int cols=48, double radius=1.0, int count=5) {
+    LODChain chain;
+    chain.radius = radius;
+    for (int k=0; k<count; ++k) {
+        int r = std::max(2, rows >> k), c = std::max(3, cols >> k);
+        chain.add(make_uv_sphere(r, c, radius));
+        if (r == 2 && c == 3) break;
+    }
+    return chain;
+}
+
+// Icospheres from `level` subdivisions down to the bare icosahedron
+inline LODChain make_icosphere_lods(int level=5, double radius=1.0) {
+    LODChain chain;
+    chain.radius = radius;
+    for (int k=level; k>=0; --k) chain.add(make_icosphere(k, radius));
+    return chain;
+}
+
+// Cube-spheres from `subdiv` down to 1, halving
+inline LODChain make_cube_sphere_lods(int subdiv=32, double radius=1.0) {
+    LODChain chain;
+    chain.radius = radius;
+    for (int s=std::max(1, subdiv); ; s /= 2) {
+        chain.add(make_cube_sphere(s, radius));
+        if (s == 1) break;
+    }
+    return chain;
+}
+
+// Picks a chain level per instance from its projected radius: the coarsest
+// level whose error stays within `tolerancePx` pixels on screen. Each
+// instance keeps its last level in `state`, and only drops to a coarser
+// one once it is `hysteresis` (a fraction) below that level's threshold,
+// so objects hovering at a threshold do not pop back and forth. Triangles
+// of the selected levels are counted until reset_stats().
+class LODSelector {
+public:
+    double tolerancePx;
+    double hysteresis;
+    size_t triangles = 0;           // selected since reset_stats()
+    std::vector<int> perLevel;      // instances per level since reset_stats()
+
+    LODSelector(const View3DParameters& params, int viewportHeight,
+                double tolerancePx = 0.5, double hysteresis = 0.15)
+        : tolerancePx(tolerancePx), hysteresis(hysteresis),
+          view(params.make_view().view_matrix()), nearZ(params.nearZ),
+          pxPerUnit(0.5 * viewportHeight / std::tan(0.5 * params.fov)) {}
+
+    // Radius in pixels of a sphere at `center` (world space); 0 behind
+    // the camera
+    double screen_radius(const Point3D& center, double radius) const {
+        double z = view.apply(center).z;
+        if (z <= nearZ) return z + radius > nearZ ? 1e30 : 0.0;
+        return radius * pxPerUnit / z;
+    }
+
+    // chain instance at `center`, scaled by `scale`; state < 0 on first use
+    int select(const LODChain& chain, const Point3D& center, double scale, int& state) {
+        const int last = (int)chain.levels.size() - 1;
+        if (last < 0) return -1;
+        double px = screen_radius(center, chain.radius * scale);
+        int want = coarsest(chain, px, 1.0);
+        if (state >= 0 && state <= last && want > state)
+            want = std::max(state, coarsest(chain, px, 1.0 - hysteresis));
+        state = want;
+        triangles += chain.levels[want].triangles;
+        if ((int)perLevel.size() <= want) perLevel.resize(want + 1, 0);
+        ++perLevel[want];
+        return want;
+    }
+
+    void reset_stats() { triangles = 0; perLevel.clear(); }
+
+private:
+    Transformation3D view;
+    double nearZ;
+    double pxPerUnit;               // pixels per unit of size at depth 1
+
+    // Coarsest level whose on-screen error is within factor * tolerance
+    int coarsest(const LODChain& chain, double px, double factor) const {
+        int best = 0;
+        for (int k=1; k<(int)chain.levels.size(); ++k)
+            if (px * chain.levels[k].error <= factor * tolerancePx) best = k;
+        return best;
+    }
+};
@@ -0,0 +1,269 @@
+#pragma once
+#include "Mesh3D.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+// Index and vertex order passes for Mesh3D:
+//
+//   weld_vertices          merge coincident vertices (spatial hash)
+//   optimize_vertex_cache  reorder faces for post-transform cache reuse
+//   optimize_vertex_fetch  renumber vertices in first-use order
+//
+// Each pass rewrites the mesh in place (invalidating its triangulation)
+// and returns vertex counts and ACMR before and after.
+
+// Average cache miss ratio: vertices transformed per triangle when the
+// triangles of mesh.triangulation() go through a FIFO cache of
+// `cacheSize` entries. 3 is no reuse at all; about 0.6 is the practical
+// floor for a closed triangle mesh.
+inline double acmr(const Mesh3D& mesh, int cacheSize = 16) {
+    const Triangulation& T = mesh.triangulation();
+    if (T.tris.empty()) return 0.0;
+    std::vector<uint32_t> stamp(mesh.vertices.size(), 0);   // when each vertex entered the cache
+    uint32_t clock = 0;                                      // misses so far
+    for (const auto& t : T.tris)
+        for (int v : t)
+            if (stamp[v] == 0 || clock - stamp[v] >= (uint32_t)cacheSize) stamp[v] = ++clock;
+    return (double)clock / T.tris.size();
+}
+
+struct MeshOptimizeReport {
+    const char* stage = "";
+    size_t verticesBefore = 0, verticesAfter = 0;
+    double acmrBefore = 0.0, acmrAfter = 0.0;
+};
+
+inline std::ostream& operator<<(std::ostream& os, const MeshOptimizeReport& r) {
+    return os << r.stage << ": vertices " << r.verticesBefore << " -> " << r.verticesAfter
+              << ", ACMR " << r.acmrBefore << " -> " << r.acmrAfter;
+}
+
+namespace mesh_optimize_detail {
+
+// Keep the vertices faces use, in the order of `order` (old indices);
+// remaps faces, uv and colors
+inline void reorder_vertices(Mesh3D& m, const std::vector<int>& order) {
+    std::vector<int> remap(m.vertices.size(), -1);
+    for (size_t i=0; i<order.size(); ++i) remap[order[i]] = (int)i;
+    const bool hasUV = m.uv.size() == m.vertices.size();
+    const bool hasColor = m.colors.size() == m.vertices.size();
+    std::vector<Point3D> vertices(order.size()), colors(hasColor ? order.size() : 0);
+    std::vector<Point2D> uv(hasUV ? order.size() : 0);
+    for (size_t i=0; i<order.size(); ++i) {
+        vertices[i] = m.vertices[order[i]];
+        if (hasUV) uv[i] = m.uv[order[i]];
+        if (hasColor) colors[i] = m.colors[order[i]];
+    }
+    m.vertices.swap(vertices);
+    if (hasUV) m.uv.swap(uv);
+    if (hasColor) m.colors.swap(colors);
+    for (auto& f : m.faces)
+        for (int& v : f.indices) v = remap[v];
+    m.invalidate_triangulation();
+}
+
+} // namespace mesh_optimize_detail
+
+// Merge vertices closer than `tolerance` whose UVs and colors agree within
+// `attributeTolerance`, so UV and color seams stay split. Positions are
+// binned into cells of size `tolerance` and each vertex is compared with
+// the representatives in its 27 neighbouring cells; the first vertex of a
+// group represents it. Corners that end up repeated within a face are
+// removed, faces left with fewer than 3 corners dropped, and unused
+// vertices discarded.
+inline MeshOptimizeReport weld_vertices(Mesh3D& mesh, double tolerance = 1e-9,
+                                        double attributeTolerance = 1e-6) {
+    MeshOptimizeReport r;
+    r.stage = "weld";
+    r.verticesBefore = mesh.vertices.size();
+    r.acmrBefore = acmr(mesh);
+
+    const int n = (int)mesh.vertices.size();
+    const bool hasUV = mesh.uv.size() == mesh.vertices.size();
+    const bool hasColor = mesh.colors.size() == mesh.vertices.size();
+    const double cell = tolerance > 0.0 ? tolerance : 1e-12;
+    const double tol2 = tolerance * tolerance;
+
+    auto cell_of = [&](double x) { return (int64_t)std::floor(x / cell); };
+    auto key = [](int64_t x, int64_t y, int64_t z) {
+        uint64_t h = (uint64_t)x * 0x9E3779B97F4A7C15ull ^ (uint64_t)y * 0xC2B2AE3D27D4EB4Full
+                   ^ (uint64_t)z * 0x165667B19E3779F9ull;
+        return h ^ (h >> 31);
+    };
+    auto same_attributes = [&](int a, int b) {
+        if (hasUV && (std::fabs(mesh.uv[a].x - mesh.uv[b].x) > attributeTolerance ||
+                      std::fabs(mesh.uv[a].y - mesh.uv[b].y) > attributeTolerance)) return false;
+        if (hasColor && (std::fabs(mesh.colors[a].x - mesh.colors[b].x) > attributeTolerance ||
+                         std::fabs(mesh.colors[a].y - mesh.colors[b].y) > attributeTolerance ||
+                         std::fabs(mesh.colors[a].z - mesh.colors[b].z) > attributeTolerance)) return false;
+        return true;
+    };
+
+    // Representatives per cell as linked lists: head[cell] -> next[v] -> ...
+    std::unordered_map<uint64_t, int> head;
+    head.reserve(n);
+    std::vector<int> next(n, -1), rep(n);
+    for (int v=0; v<n; ++v) {
+        const Point3D& p = mesh.vertices[v];
+        const int64_t cx = cell_of(p.x), cy = cell_of(p.y), cz = cell_of(p.z);
+        int found = -1;
+        for (int dz=-1; dz<=1 && found<0; ++dz)
+            for (int dy=-1; dy<=1 && found<0; ++dy)
+                for (int dx=-1; dx<=1 && found<0; ++dx) {
+                    auto it = head.find(key(cx + dx, cy + dy, cz + dz));
+                    if (it == head.end()) continue;
+                    for (int c = it->second; c >= 0 && found < 0; c = next[c]) {
+                        const Point3D d = mesh.vertices[c] - p;
+                        if (d.x*d.x + d.y*d.y + d.z*d.z <= tol2 && same_attributes(c, v)) found = c;
+                    }
+                }
+        if (found >= 0) { rep[v] = found; continue; }
+        rep[v] = v;
+        auto ins = head.emplace(key(cx, cy, cz), v);
+        if (!ins.second) { next[v] = ins.first->second; ins.first->second = v; }
+    }
+
+    // Remap faces, dropping repeated corners and degenerate faces
+    std::vector<Face> faces;
+    faces.reserve(mesh.faces.size());
+    for (auto& f : mesh.faces) {
+        std::vector<int> idx;
+        idx.reserve(f.indices.size());
+        for (int v : f.indices) {
+            int w = rep[v];
+            if (idx.empty() || idx.back() != w) idx.push_back(w);
+        }
+        while (idx.size() > 1 && idx.front() == idx.back()) idx.pop_back();
+        if (idx.size() >= 3) faces.push_back(Face{ std::move(idx) });
+    }
+    mesh.faces.swap(faces);
+
+    // Keep used vertices in their original order
+    std::vector<char> used(n, 0);
+    for (const auto& f : mesh.faces)
+        for (int v : f.indices) used[v] = 1;
+    std::vector<int> order;
+    for (int v=0; v<n; ++v) if (used[v]) order.push_back(v);
+    mesh_optimize_detail::reorder_vertices(mesh, order);
+
+    r.verticesAfter = mesh.vertices.size();
+    r.acmrAfter = acmr(mesh);
+    return r;
+}
+
+// Reorder faces for post-transform vertex cache reuse (Forsyth's
+// linear-speed algorithm, applied to whole faces so N-gons are kept).
+// Vertices are scored by their position in a simulated LRU cache of
+// `cacheSize` entries and by how many of their faces are still
+// unemitted; the next face is the best-scoring one touching the cache,
+// or the next unemitted face in input order when none does.
+inline MeshOptimizeReport optimize_vertex_cache(Mesh3D& mesh, int cacheSize = 32) {
+    MeshOptimizeReport r;
+    r.stage = "vertex cache";
+    r.verticesBefore = r.verticesAfter = mesh.vertices.size();
+    r.acmrBefore = acmr(mesh);
+
+    const int nv = (int)mesh.vertices.size(), nf = (int)mesh.faces.size();
+    cacheSize = std::max(cacheSize, 4);
+
+    // Faces around each vertex (CSR)
+    std::vector<int> start(nv + 1, 0), remaining(nv, 0);
+    for (const auto& f : mesh.faces)
+        for (int v : f.indices) ++remaining[v];
+    for (int v=0; v<nv; ++v) start[v + 1] = start[v] + remaining[v];
+    std::vector<int> around(start[nv]), fill(start.begin(), start.end() - 1);
+    for (int f=0; f<nf; ++f)
+        for (int v : mesh.faces[f].indices) around[fill[v]++] = f;
+
+    std::vector<int> cachePos(nv, -1);
+    auto vertex_score = [&](int v) {
+        if (remaining[v] == 0) return -1.0;
+        double s = 0.0;
+        const int p = cachePos[v];
+        if (p >= 0) s = p < 3 ? 0.75 : std::pow(1.0 - (p - 3) / double(cacheSize - 3), 1.5);
+        return s + 2.0 / std::sqrt((double)remaining[v]);
+    };
+    std::vector<double> vScore(nv), fScore(nf, 0.0);
+    for (int v=0; v<nv; ++v) vScore[v] = vertex_score(v);
+    for (int f=0; f<nf; ++f)
+        for (int v : mesh.faces[f].indices) fScore[f] += vScore[v];
+
+    std::vector<char> emitted(nf, 0);
+    std::vector<int> cache, nextCache, order;
+    order.reserve(nf);
+    int best = -1, scan = 0;
+    for (int step=0; step<nf; ++step) {
+        if (best < 0) {
+            // Nothing in the cache has faces left: next face in input order
+            while (emitted[scan]) ++scan;
+            best = scan;
+        }
+        const int f = best;
+        emitted[f] = 1;
+        order.push_back(f);
+        for (int v : mesh.faces[f].indices) {
+            --remaining[v];
+            for (int k=start[v], e=start[v + 1]; k<e; ++k)     // drop f from v's list
+                if (around[k] == f) { std::swap(around[k], around[start[v] + remaining[v]]); break; }
+        }
+
+        // New cache: the face's vertices first, then the old entries
+        nextCache.clear();
+        for (int v : mesh.faces[f].indices)
+            if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end()) nextCache.push_back(v);
+        for (int v : cache)
+            if (std::find(nextCache.begin(), nextCache.end(), v) == nextCache.end()) nextCache.push_back(v);
+        for (size_t i=0; i<nextCache.size(); ++i) cachePos[nextCache[i]] = i < (size_t)cacheSize ? (int)i : -1;
+
+        // Rescore touched vertices and their faces, pick the best in cache
+        best = -1;
+        double bestScore = -1.0;
+        for (int v : nextCache) {
+            const double s = vertex_score(v);
+            const double d = s - vScore[v];
+            vScore[v] = s;
+            for (int k=start[v], e=start[v] + remaining[v]; k<e; ++k) fScore[around[k]] += d;
+        }
+        for (size_t i=0; i<nextCache.size() && i<(size_t)cacheSize; ++i) {
+            const int v = nextCache[i];
+            for (int k=start[v], e=start[v] + remaining[v]; k<e; ++k)
+                if (fScore[around[k]] > bestScore) { bestScore = fScore[around[k]]; best = around[k]; }
+        }
+        if (nextCache.size() > (size_t)cacheSize) nextCache.resize(cacheSize);
+        cache.swap(nextCache);
+    }
+
+    std::vector<Face> faces(nf);
+    for (int i=0; i<nf; ++i) faces[i] = std::move(mesh.faces[order[i]]);
+    mesh.faces.swap(faces);
+    mesh.invalidate_triangulation();
+
+    r.acmrAfter = acmr(mesh);
+    return r;
+}
+
+// Renumber vertices in the order the faces first use them, so a walk over
+// the faces reads vertices (and uv/colors) nearly sequentially. Unused
+// vertices are dropped. ACMR is unchanged.
+inline MeshOptimizeReport optimize_vertex_fetch(Mesh3D& mesh) {
+    MeshOptimizeReport r;
+    r.stage = "vertex fetch";
+    r.verticesBefore = mesh.vertices.size();
+    r.acmrBefore = acmr(mesh);
+
+    std::vector<char> seen(mesh.vertices.size(), 0);
+    std::vector<int> order;
+    order.reserve(mesh.vertices.size());
+    for (const auto& f : mesh.faces)
+        for (int v : f.indices)
+            if (!seen[v]) { seen[v] = 1; order.push_back(v); }
+    mesh_optimize_detail::reorder_vertices(mesh, order);
+
+    r.verticesAfter = mesh.vertices.size();
+    r.acmrAfter = acmr(mesh);
+    return r;
+}
@@ -10,6 +10,9 @@
 #include "Projection3D.hpp"
 #include "Drawing2D.hpp"
 #include "Shading.hpp"       // lambert01(), phong01(), to_u8()
+#include "TiledLighting.hpp"
+#include "DepthRaster.hpp"
+#include "ShadowMap.hpp"
 
 // Rendering modes
 enum class RenderMode {
@@ -45,9 +48,8 @@ public:
         for (const auto& face : mesh.faces) {
             if (face.indices.size()<3) continue;
         
-            Polygon3D poly = mesh.to_polygon(face);
-            Point3D n = poly.normal();        // view-space face normal
-            if (n.z >= 0) continue;           // backface cull
+            Point3D n = mesh.face_normal(face);   // view-space face normal
+            if (n.z >= 0) continue;               // backface cull
 
             std::vector<Point2D> pts2d;
             std::vector<Point3D> vpos;
@@ -72,6 +74,8 @@ public:
     // Render a mesh already in VIEW space (i.e., model->view applied).
     // vertexNormals must be view-space too (use Mesh3D::compute_vertex_normals() after view xform).
     // perspectiveCorrect: if true, do approximate perspective-correct interpolation using 1/z as w.
+    // Lighting comes from `lights`; when that list is empty a single white
+    // directional light along `lightDir` is used, as before.
     void render(const Mesh3D& mesh,
                 const std::vector<Point3D>& vertexNormals,
                 RenderMode mode = RenderMode::Gouraud,
@@ -81,13 +85,25 @@ public:
     {
         Drawing2D draw(rb);
         const Material& mat = mesh.material;
-        const Texture2D* useTex = tex ? tex : mesh.texture.get();
+        const Texture2D* useTex = tex ? tex : mat.diffuseTex.get();
 
         // Default shading knobs
         const bool     perspectiveCorrect = true;
         const uint8_t  base = 230;
         const double   kd = 0.7, ks = 0.3, shininess = 24.0;
 
+        prepare_lights();
+
+        // A depth prepass (render_depth) just ran on this buffer: re-test with
+        // <= so the prepass winner shades, and bin lights per screen tile.
+        depthLE  = depthPrepassed;
+        useTiles = tiledLighting && depthPrepassed;
+        depthPrepassed = false;
+        if (useTiles) tileGrid.build(rb, lightSoA, projection);
+
+        shadowIdx = (shadowMap && shadowMap->lightIndex < (int)lightSoA.size())
+                  ? shadowMap->lightIndex : -1;
+
         // Viewport mapping: NDC [-1,1] -> pixel coords
         auto viewport = [&](const Point2D& p) {
             double x = (p.x + 1.0) * 0.5 * rb.width;
@@ -95,111 +111,298 @@ public:
             return Point2D(x, y);
         };
 
-        // Triangulate a face (fan)
-        auto triangulate = [&](const Face& f) -> std::vector<std::array<int,3>> {
-            std::vector<std::array<int,3>> tris;
-            if (f.indices.size() < 3) return tris;
-            for (size_t i = 1; i + 1 < f.indices.size(); ++i) {
-                tris.push_back({ f.indices[0], f.indices[i], f.indices[i+1] });
-            }
-            return tris;
+        // uv/colors are optional on Mesh3D
+        auto uvAt = [&](int vi) {
+            return vi < (int)mesh.uv.size() ? mesh.uv[vi] : Point2D(0,0);
+        };
+        auto colorAt = [&](int vi) {
+            return vi < (int)mesh.colors.size() ? mesh.colors[vi] : mat.baseColor;
         };
 
-        // Per-face loop -> fan triangulation
-        for (const auto& face : mesh.faces) {
-            auto tris = triangulate(face);
-            if (tris.empty()) continue;
+        // Triangles come from the mesh's cached triangulation; face normals
+        // follow the (view-space) positions, so they are refreshed per call
+        const Triangulation& T = mesh.triangulation();
+        mesh.face_normals(faceNormals);
 
-            // Face normal and backface culling in VIEW space
-            Polygon3D poly = mesh.to_polygon(face);
-            Point3D faceN  = poly.normal();      // view-space
+        for (size_t t = 0; t < T.tris.size(); ++t) {
+            // Backface culling in VIEW space
+            const Point3D& faceN = faceNormals[T.face[t]];
             if (faceN.z >= 0) continue;          // away from camera
+            const std::array<int,3>& tri = T.tris[t];
+            // Collect per-vertex view-space data
+            std::array<Point3D,3> P = {
+                mesh.vertices[tri[0]],
+                mesh.vertices[tri[1]],
+                mesh.vertices[tri[2]]
+            };
+            std::array<Point3D,3> N = {
+                vertexNormals[tri[0]],
+                vertexNormals[tri[1]],
+                vertexNormals[tri[2]]
+            };
+            std::array<Point2D,3> UV = { uvAt(tri[0]), uvAt(tri[1]), uvAt(tri[2]) };
+
+            // Project to NDC and viewport-mapped screen coords
+            std::array<Point2D,3> S;
+            std::array<double,3>   zView, invW;
+            
+            for (int i=0;i<3;++i) {
+                Point2D ndc = projection.project(P[i]);  // our Projection3D returns NDC-like coords
+                S[i] = viewport(ndc);
+                zView[i] = P[i].z;
+                // Approximate perspective correction with 1/z
+                // Clamp to avoid inf if z ~ 0 (behind near plane we shouldn't draw anyway)
+                double z = std::max(1e-6, std::abs(P[i].z));
+                invW[i] = perspectiveCorrect ? (1.0 / z) : 1.0;
+            }
 
-            for (const auto& tri : tris) {
-                // Collect per-vertex view-space data
-                std::array<Point3D,3> P = {
-                    mesh.vertices[tri[0]],
-                    mesh.vertices[tri[1]],
-                    mesh.vertices[tri[2]]
-                };
-                std::array<Point3D,3> N = {
-                    vertexNormals[tri[0]],
-                    vertexNormals[tri[1]],
-                    vertexNormals[tri[2]]
-                };
-                std::array<Point2D,3> UV = { 
-                    mesh.uv[tri[0]],
-                    mesh.uv[tri[1]],
-                    mmesh.uv[tri[2]] };
-
-                // Project to NDC and viewport-mapped screen coords
-                std::array<Point2D,3> S;
-                std::array<double,3>   zView, invW;
-                
-                for (int i=0;i<3;++i) {
-                    Point2D ndc = projection.project(P[i]);  // our Projection3D returns NDC-like coords
-                    S[i] = viewport(ndc);
-                    zView[i] = P[i].z;
-                    // Approximate perspective correction with 1/z
-                    // Clamp to avoid inf if z ~ 0 (behind near plane we shouldn't draw anyway)
-                    double z = std::max(1e-6, std::abs(P[i].z));
-                    invW[i] = perspectiveCorrect ? (1.0 / z) : 1.0;
-                }
+            // Backface cull in screen space too (area sign). The viewport
+            // flips Y, so a face with view normal z<0 has positive area here;
+            // the old `area >= 0` test rejected every face the check above kept.
+            double area = edgeFunction(S[0], S[1], S[2]);
+            if (area <= 0) continue; // edge-on or facing away
+
+            std::array<Point3D,3> C = { colorAt(tri[0]), colorAt(tri[1]), colorAt(tri[2]) };
+
+            // Only lights whose range reaches this triangle are evaluated below
+            if (!(useTiles && mode == RenderMode::Phong)) cull_triangle_lights(P);
+
+            // Rasterize the triangle according to the selected mode
+            switch (mode) {
+                case RenderMode::Flat:
+                    draw_triangle_flat(S, P, faceN, zView, invW, base, useTex);
+                    break;
+                case RenderMode::Gouraud:
+                    draw_triangle_gouraud(S, P, N, zView, invW, UV, C, base, useTex);
+                    break;
+                case RenderMode::Phong:
+                    draw_triangle_phong(S, P, N, zView, invW, UV, C, 
+                                        base, kd, ks, shininess, useTex);
+                    break;
+            }
 
-                // Backface cull in screen space too (area sign), optional
-                double area = edgeFunction(S[0], S[1], S[2]);
-                if (area >= 0) continue; // CW vs CCW depending on convention; skip if away
-
-                std::array<Point3D,3> C = { mesh.colors[tri[0]],
-                            mesh.colors[tri[1]],
-                            mesh.colors[tri[2]] };
-                
-                // Rasterize the triangle according to the selected mode
-                switch (mode) {
-                    case RenderMode::Flat:
-                        draw_triangle_flat(S, P, faceN, zView, base, useTex);
-                        break;
-                    case RenderMode::Gouraud:
-                        draw_triangle_gouraud(S, P, N, zView, UV, C, base, useTex);
-                        break;
-                    case RenderMode::Phong:
-                        draw_triangle_phong(S, P, N, zView, invW, UV, C, 
-                                            base, kd, ks, shininess, useTex);
-                        break;
-                }
+            if (drawWire) wire(draw, S, 255);
+        }
 
-                if (drawWire) {
-                    draw.line(S[0], S[1], 255);
-                    draw.line(S[1], S[2], 255);
-                    draw.line(S[2], S[0], 255);
-                }
+        // MSAA: shaded (and wireframe) samples -> pixels
+        if (rb.msaa() && autoResolve) rb.resolve();
+    }
+
+    // Triangle edges of every front face, as render(..., drawWire=true)
+    // draws them. With MSAA the edges go into the samples, so call this
+    // before rb.resolve() when autoResolve is off.
+    void draw_wireframe(const Mesh3D& mesh, uint8_t value = 255) {
+        Drawing2D draw(rb);
+        auto viewport = [&](const Point2D& p) {
+            return Point2D((p.x + 1.0) * 0.5 * rb.width, (1.0 - (p.y + 1.0) * 0.5) * rb.height);
+        };
+        const Triangulation& T = mesh.triangulation();
+        mesh.face_normals(faceNormals);
+        for (size_t t = 0; t < T.tris.size(); ++t) {
+            if (faceNormals[T.face[t]].z >= 0) continue;
+            const std::array<int,3>& idx = T.tris[t];
+            std::array<Point2D,3> S = {
+                viewport(projection.project(mesh.vertices[idx[0]])),
+                viewport(projection.project(mesh.vertices[idx[1]])),
+                viewport(projection.project(mesh.vertices[idx[2]]))
+            };
+            if (edgeFunction(S[0], S[1], S[2]) <= 0) continue;
+            wire(draw, S, value);
+        }
+    }
+
+    // Depth-only prepass: fills rb.depth with the nearest surface using the
+    // same triangle setup and coverage rule as render(), but no shading.
+    // The next render() on this buffer then shades each pixel at most once
+    // and, with tiledLighting, bins lights against the resulting depth.
+    void render_depth(const Mesh3D& mesh) {
+        if (!rb.has_depth()) return;
+        auto viewport = [&](const Point2D& p) {
+            return Point2D((p.x + 1.0) * 0.5 * rb.width, (1.0 - (p.y + 1.0) * 0.5) * rb.height);
+        };
+        const Triangulation& T = mesh.triangulation();
+        mesh.face_normals(faceNormals);
+        for (size_t t = 0; t < T.tris.size(); ++t) {
+            if (faceNormals[T.face[t]].z >= 0) continue;
+            const std::array<int,3>& tri = T.tris[t];
+            std::array<Point2D,3> S;
+            std::array<double,3>  zView, invW;
+            for (int i=0;i<3;++i) {
+                const Point3D& P = mesh.vertices[tri[i]];
+                S[i] = viewport(projection.project(P));
+                zView[i] = P.z;
+                invW[i] = 1.0 / std::max(1e-6, std::abs(P.z));
             }
+            if (edgeFunction(S[0], S[1], S[2]) <= 0) continue;
+            if (rb.msaa())
+                DepthRaster::triangle_samples(rb.sampleDepth.data(), rb.width, rb.height, rb.samples,
+                                              RasterBuffer<uint8_t>::sample_pattern(rb.samples),
+                                              S, zView, invW);
+            else
+                DepthRaster::triangle(rb.depth.data(), rb.width, rb.height, S, zView, invW);
         }
+        rb.resolve_depth();   // MSAA: tile binning reads the per-pixel depth
+        depthPrepassed = true;
     }
 
+    // Light list (view space). Empty -> single white light along lightDir.
+    std::vector<Light> lights;
+
+    // Forward+: after render_depth(), bin lights into screen tiles and let
+    // the Phong loop read only its tile's list.
+    bool          tiledLighting = false;
+    TileLightGrid tileGrid;
+
+    // Optional shadow map for one directional light (see ShadowMap.hpp);
+    // must already be rendered and bound to this camera via set_camera().
+    const ShadowMap* shadowMap = nullptr;
 
+    // MSAA (rb.enable_msaa(n)): coverage and depth are tested per sample,
+    // shading runs once per pixel per triangle. render() resolves into
+    // rb.data at the end; turn this off to draw several meshes into the
+    // samples first, then call rb.resolve() (and draw_wireframe()) yourself.
+    bool autoResolve = true;
 
 private:
+    bool depthPrepassed = false;   // set by render_depth(), consumed by render()
+    bool depthLE  = false;         // current render() follows a prepass
+    bool useTiles = false;         // current render() uses tileGrid
+    int  shadowIdx = -1;           // lightSoA index darkened by shadowMap, -1 = none
+
+    inline bool depth_test(int x, int y, double z) {
+        return depthLE ? rb.test_and_set_depth_le(x,y,z) : rb.test_and_set_depth(x,y,z);
+    }
+
+    // Perspective-correct view depth (1/z weights), shared by every mode and
+    // the prepass so their depths agree
+    static inline double pixel_depth(double w0, double w1, double w2,
+                                     const std::array<double,3>& zView,
+                                     const std::array<double,3>& invW) {
+        return DepthRaster::perspective_depth(w0, w1, w2, zView, invW);
+    }
+
+    std::vector<Point3D> faceNormals;  // per face of the mesh being drawn, reused across calls
+
+    LightSoA         lightSoA;       // packed copy of `lights`, rebuilt per render()
+    std::vector<int> triLights;      // indices into lightSoA touching the current triangle
+
+    void prepare_lights() {
+        if (lights.empty()) lightSoA.build({ Light::directional(lightDir) });
+        else                lightSoA.build(lights);
+        triLights.reserve(lightSoA.size());
+    }
+
+    // Range-cull against the triangle's view-space bounding sphere
+    void cull_triangle_lights(const std::array<Point3D,3>& P) {
+        Point3D c = (P[0] + P[1] + P[2]) / 3.0;
+        double r = std::max({ c.distance_to(P[0]), c.distance_to(P[1]), c.distance_to(P[2]) });
+        cull_lights_sphere(lightSoA, c, r, triLights);
+    }
+
+    inline Point3D light_sum(const Point3D& N, const Point3D& P, const Point3D& V,
+                             double kd, double ks, double shininess,
+                             double shadowVis = 1.0) const {
+        return shade_lights(lightSoA, triLights.data(), triLights.size(),
+                            N, P, V, kd, ks, shininess, shadowIdx, shadowVis);
+    }
+
+    inline double shadow_at(const Point3D& P, const Point3D& N) const {
+        return shadowIdx >= 0 ? shadowMap->visibility(P, N) : 1.0;
+    }
+
+    // Perspective-correct view-space position at a pixel
+    static inline Point3D pixel_position(double w0, double w1, double w2,
+                                         const std::array<Point3D,3>& P,
+                                         const std::array<double,3>& invW) {
+        double a0 = w0*invW[0], a1 = w1*invW[1], a2 = w2*invW[2];
+        double iw = a0 + a1 + a2;
+        if (iw <= 1e-12) { a0 = w0; a1 = w1; a2 = w2; iw = 1.0; }
+        return (P[0]*a0 + P[1]*a1 + P[2]*a2) / iw;
+    }
+
     // Signed area *2 (helper for winding/backface)
     static inline double edgeFunction(const Point2D& a, const Point2D& b, const Point2D& c) {
-        return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        return DepthRaster::edge_function(a, b, c);
     }
 
-    // Compute barycentric weights for pixel center (x+0.5,y+0.5)
-    static inline bool barycentric(const std::array<Point2D,3>& S, int px, int py,
-                                   double& w0, double& w1, double& w2)
-    {
-        double area = edgeFunction(S[0], S[1], S[2]);
-        if (area == 0.0) return false;
+    // Coverage and depth test for one pixel. Returns the mask of samples
+    // that pass (just bit 0 without MSAA) plus the barycentrics to shade
+    // with once for all of them: the pixel center, clamped onto the
+    // triangle when only edge samples are covered.
+    inline uint32_t cover(const DepthRaster::Edges& E, int x, int y,
+                          const std::array<double,3>& zView,
+                          const std::array<double,3>& invW,
+                          double& w0, double& w1, double& w2) {
+        w0 = w1 = w2 = 0.0;
+        if (!rb.msaa()) {
+            if (!E.weights(x + 0.5, y + 0.5, w0, w1, w2)) return 0;
+            return depth_test(x, y, pixel_depth(w0, w1, w2, zView, invW)) ? 1u : 0u;
+        }
+        const float* pat = RasterBuffer<uint8_t>::sample_pattern(rb.samples);
+        uint32_t mask = 0;
+        for (int s=0; s<rb.samples; ++s) {
+            double a,b,c;
+            if (!E.weights(x + pat[2*s], y + pat[2*s+1], a, b, c)) continue;
+            double z = pixel_depth(a, b, c, zView, invW);
+            bool pass = depthLE ? rb.test_and_set_sample_depth_le(x, y, s, z)
+                                : rb.test_and_set_sample_depth(x, y, s, z);
+            if (pass) mask |= 1u << s;
+        }
+        if (mask && !E.weights(x + 0.5, y + 0.5, w0, w1, w2)) {
+            w0 = std::max(0.0, w0); w1 = std::max(0.0, w1); w2 = std::max(0.0, w2);
+            double sum = w0 + w1 + w2;
+            w0 /= sum; w1 /= sum; w2 /= sum;
+        }
+        return mask;
+    }
 
-        double x = px + 0.5;
-        double y = py + 0.5;
+    // Edges of one screen triangle: Bresenham without MSAA; with it, a
+    // 1 px wide line into every sample within half a pixel of the edge, so
+    // the resolve antialiases it like the triangle silhouettes
+    void wire(Drawing2D& draw, const std::array<Point2D,3>& S, uint8_t value) {
+        for (int i=0; i<3; ++i) {
+            if (rb.msaa()) line_samples(S[i], S[(i+1)%3], value);
+            else           draw.line(S[i], S[(i+1)%3], value);
+        }
+    }
 
-        w0 = edgeFunction(S[1], S[2], Point2D(x,y)) / area;
-        w1 = edgeFunction(S[2], S[0], Point2D(x,y)) / area;
-        w2 = 1.0 - w0 - w1;
+    void line_samples(const Point2D& a, const Point2D& b, uint8_t value) {
+        const float* pat = RasterBuffer<uint8_t>::sample_pattern(rb.samples);
+        const double dx = b.x - a.x, dy = b.y - a.y, len2 = dx*dx + dy*dy;
+        const double inv = len2 > 0.0 ? 1.0 / len2 : 0.0;
+        // Walk the major axis one pixel at a time; on the minor axis, the
+        // pixels the segment crosses there plus one either side
+        const bool steep = std::abs(dy) > std::abs(dx);
+        const double ua = steep ? a.y : a.x, ub = steep ? b.y : b.x;
+        const double va = steep ? a.x : a.y, dv = steep ? dx : dy, du = steep ? dy : dx;
+        const int uMax = (steep ? rb.height : rb.width) - 1, vMax = (steep ? rb.width : rb.height) - 1;
+        const int u0 = std::max(0, (int)std::floor(std::min(ua, ub) - 0.5));
+        const int u1 = std::min(uMax, (int)std::floor(std::max(ua, ub) + 0.5));
+        auto vAt = [&](double u) {
+            double t = du != 0.0 ? std::min(1.0, std::max(0.0, (u - ua) / du)) : 0.0;
+            return va + t*dv;
+        };
+        for (int u=u0; u<=u1; ++u) {
+            double vA = vAt(u), vB = vAt(u + 1.0);
+            int v0 = std::max(0, (int)std::floor(std::min(vA, vB)) - 1);
+            int v1 = std::min(vMax, (int)std::floor(std::max(vA, vB)) + 1);
+            for (int v=v0; v<=v1; ++v) {
+                int x = steep ? v : u, y = steep ? u : v;
+                uint32_t mask = 0;
+                for (int s=0; s<rb.samples; ++s) {
+                    double px = x + pat[2*s] - a.x, py = y + pat[2*s+1] - a.y;
+                    double t = std::min(1.0, std::max(0.0, (px*dx + py*dy) * inv));
+                    double ex = px - t*dx, ey = py - t*dy;
+                    if (ex*ex + ey*ey <= 0.25) mask |= 1u << s;
+                }
+                if (mask) rb.set_samples(x, y, mask, value, value, value);
+            }
+        }
+    }
 
-        return (w0 >= 0.0 && w1 >= 0.0 && w2 >= 0.0);
+    inline void put(int x, int y, uint32_t mask, uint8_t R, uint8_t G, uint8_t B) {
+        if (rb.msaa()) rb.set_samples(x, y, mask, R, G, B);
+        else           rb.set_pixel(x, y, R, G, B);
     }
 
     // Triangle bounding box
@@ -207,34 +410,46 @@ private:
                                  int& minX, int& minY, int& maxX, int& maxY,
                                  int W, int H)
     {
-        minX = std::max(0, (int)std::floor(std::min({S[0].x, S[1].x, S[2].x})));
-        minY = std::max(0, (int)std::floor(std::min({S[0].y, S[1].y, S[2].y})));
-        maxX = std::min(W-1, (int)std::ceil (std::max({S[0].x, S[1].x, S[2].x})));
-        maxY = std::min(H-1, (int)std::ceil (std::max({S[0].y, S[1].y, S[2].y})));
+        DepthRaster::tri_bounds(S, minX, minY, maxX, maxY, W, H);
     }
 
-    // Flat shading (Lambert with face normal)
+    // Flat shading (Lambert with face normal, evaluated once at the centroid)
     void draw_triangle_flat(const std::array<Point2D,3>& S,
                             const std::array<Point3D,3>& P,  // view-space positions
                             const Point3D& faceN_view,
                             const std::array<double,3>& zView,
+                            const std::array<double,3>& invW,
                             uint8_t base,
                             const Texture2D* tex)
     {
         int minX, minY, maxX, maxY;
         triBounds(S, minX, minY, maxX, maxY, rb.width, rb.height);
-
-        // The same face normal everywhere
-        double I = lambert01(faceN_view, lightDir);
-        uint8_t gray = (uint8_t)(base * I);
+        DepthRaster::Edges E;
+        if (!E.setup(S)) return;
+
+        // The same face normal everywhere; with a shadow map the shadowed
+        // light's share (Ilit - Idark) is scaled per pixel
+        Point3D Pc = (P[0] + P[1] + P[2]) / 3.0;
+        Point3D Ilit  = light_sum(faceN_view, Pc, Pc * -1.0, 1.0, 0.0, 1.0);
+        Point3D Idark = (shadowIdx >= 0) ? light_sum(faceN_view, Pc, Pc * -1.0, 1.0, 0.0, 1.0, 0.0) : Ilit;
+        uint8_t R = clamp255(base * Ilit.x);
+        uint8_t G = clamp255(base * Ilit.y);
+        uint8_t B = clamp255(base * Ilit.z);
 
         for (int y=minY; y<=maxY; ++y) {
-            for (int x=minX; x<=maxX; ++x) {
+            int x0 = minX, x1 = maxX;
+            if (rb.msaa()) E.span(y, x0, x1, 0.0, 1.0); else E.span(y, x0, x1);
+            for (int x=x0; x<=x1; ++x) {
                 double w0,w1,w2;
-                if (!barycentric(S, x, y, w0, w1, w2)) continue;
-                double z = w0*P[0].z + w1*P[1].z + w2*P[2].z;
-                if (!rb.test_and_set_depth(x,y,z)) continue;
-                rb.set_pixel(x,y,gray,gray,gray);
+                uint32_t mask = cover(E, x, y, zView, invW, w0, w1, w2);
+                if (!mask) continue;
+                if (shadowIdx >= 0) {
+                    double vis = shadow_at(pixel_position(w0, w1, w2, P, invW), faceN_view);
+                    Point3D I = Idark + (Ilit - Idark) * vis;
+                    put(x,y, mask, clamp255(base * I.x), clamp255(base * I.y), clamp255(base * I.z));
+                    continue;
+                }
+                put(x,y, mask, R,G,B);
             }
         }
     }
@@ -244,34 +459,41 @@ private:
                                const std::array<Point3D,3>& P,
                                const std::array<Point3D,3>& N,
                                const std::array<double,3>& zView,
-                               const std::array<POint2D,3>& UV,
-                               uint8_t base
+                               const std::array<double,3>& invW,
+                               const std::array<Point2D,3>& UV,
+                               const std::array<Point3D,3>& C,
+                               uint8_t base,
                                const Texture2D* tex)
     {
         int minX, minY, maxX, maxY;
         triBounds(S, minX, minY, maxX, maxY, rb.width, rb.height);
-
-        // Per-vertex intensity (0..1)
-        std::array<double,3> Iv = {
-            lambert01(N[0], lightDir),
-            lambert01(N[1], lightDir),
-            lambert01(N[2], lightDir)
-        };
-
-  /*      // Per-vertex UVs
-        std::array<Point2D,3> UV = {
-            mesh.uv[tri[0]], mesh.uv[tri[1]], mesh.uv[tri[2]]
-        };  */
+        DepthRaster::Edges E;
+        if (!E.setup(S)) return;
+
+        // Per-vertex RGB diffuse (0..n lights summed); Id = same with the
+        // shadowed light removed, blended per pixel by shadow visibility
+        std::array<Point3D,3> Iv, Id;
+        for (int i=0;i<3;++i) {
+            Iv[i] = light_sum(N[i], P[i], P[i] * -1.0, 1.0, 0.0, 1.0);
+            Id[i] = (shadowIdx >= 0) ? light_sum(N[i], P[i], P[i] * -1.0, 1.0, 0.0, 1.0, 0.0) : Iv[i];
+        }
 
         for (int y=minY; y<=maxY; ++y) {
-            for (int x=minX; x<=maxX; ++x) {
+            int x0 = minX, x1 = maxX;
+            if (rb.msaa()) E.span(y, x0, x1, 0.0, 1.0); else E.span(y, x0, x1);
+            for (int x=x0; x<=x1; ++x) {
                 double w0,w1,w2;
-                if (!barycentric(S, x, y, w0, w1, w2)) continue;
-                double z = w0*zView[0] + w1*zView[1] + w2*zView[2];
-                if (!rb.test_and_set_depth(x,y,z)) continue;
+                uint32_t mask = cover(E, x, y, zView, invW, w0, w1, w2);
+                if (!mask) continue;
 
                 // Interpolated intensity
-                double I = w0*Iv[0] + w1*Iv[1] + w2*Iv[2];
+                Point3D I = Iv[0]*w0 + Iv[1]*w1 + Iv[2]*w2;
+                if (shadowIdx >= 0) {
+                    Point3D Idark = Id[0]*w0 + Id[1]*w1 + Id[2]*w2;
+                    double vis = shadow_at(pixel_position(w0, w1, w2, P, invW),
+                                           N[0]*w0 + N[1]*w1 + N[2]*w2);
+                    I = Idark + (I - Idark) * vis;
+                }
 
                 uint8_t R,G,B;
                 if (tex) {
@@ -280,18 +502,18 @@ private:
                         w0*UV[0].y + w1*UV[1].y + w2*UV[2].y
                     );
                     tex->sample_bilinear(uvPix.x, uvPix.y, R,G,B);
-                    R = (uint8_t)(R * I);
-                    G = (uint8_t)(G * I);
-                    B = (uint8_t)(B * I);
+                    R = clamp255(R * I.x);
+                    G = clamp255(G * I.y);
+                    B = clamp255(B * I.z);
                 } else {
                     Point3D Cpix(w0*C[0].x + w1*C[1].x + w2*C[2].x,
                              w0*C[0].y + w1*C[1].y + w2*C[2].y,
                              w0*C[0].z + w1*C[1].z + w2*C[2].z);
-                    R = (uint8_t)(255 * clamp01(Cpix.x * I));
-                    G = (uint8_t)(255 * clamp01(Cpix.y * I));
-                    B = (uint8_t)(255 * clamp01(Cpix.z * I));
+                    R = (uint8_t)(255 * clamp01(Cpix.x * I.x));
+                    G = (uint8_t)(255 * clamp01(Cpix.y * I.y));
+                    B = (uint8_t)(255 * clamp01(Cpix.z * I.z));
                 }
-                rb.set_pixel(x,y, R, G, B);
+                put(x,y, mask, R, G, B);
             }
         }
     }
@@ -303,16 +525,27 @@ private:
                              const std::array<double,3>& zView,
                              const std::array<double,3>& invW,   // 1/z if perspectiveCorrect, else {1,1,1}
                              const std::array<Point2D,3>& UV,
+                             const std::array<Point3D,3>& C,
                              uint8_t base, double kd, double ks, double shininess,
                              const Texture2D* tex)
     {
         int minX, minY, maxX, maxY;
         triBounds(S, minX, minY, maxX, maxY, rb.width, rb.height);
+        DepthRaster::Edges E;
+        if (!E.setup(S)) return;
+
+        // Light list: the pixel's screen tile (forward+) or the triangle's
+        const int* lightIdx = triLights.data();
+        size_t     lightCount = triLights.size();
+        int        curTile = -1;
 
         for (int y=minY; y<=maxY; ++y) {
-            for (int x=minX; x<=maxX; ++x) {
+            int x0 = minX, x1 = maxX;
+            if (rb.msaa()) E.span(y, x0, x1, 0.0, 1.0); else E.span(y, x0, x1);
+            for (int x=x0; x<=x1; ++x) {
                 double w0,w1,w2;
-                if (!barycentric(S, x, y, w0, w1, w2)) continue;
+                uint32_t mask = cover(E, x, y, zView, invW, w0, w1, w2);
+                if (!mask) continue;
 
                 // Perspective-ish correction: interpolate with 1/z weights
                 double iw = w0*invW[0] + w1*invW[1] + w2*invW[2];
@@ -328,32 +561,34 @@ private:
                     a0*N[0].x + a1*N[1].x + a2*N[2].x,
                     a0*N[0].y + a1*N[1].y + a2*N[2].y,
                     a0*N[0].z + a1*N[1].z + a2*N[2].z);
-                
-                double z = a0*zView[0] + a1*zView[1] + a2*zView[2];
-                if (!rb.test_and_set_depth(x,y,z)) continue;
-                
+
                 // View direction in view space: camera at origin → -P
                 Point3D Vdir(-Ppix.x, -Ppix.y, -Ppix.z);
-                
-                double I = phong01(Npix, lightDir, Vdir, kd, ks, shininess);
+
+                if (useTiles) {
+                    int t = tileGrid.tile_index(x, y);
+                    if (t != curTile) { curTile = t; lightIdx = tileGrid.tile_lights(t, lightCount); }
+                }
+                Point3D I = shade_lights(lightSoA, lightIdx, lightCount, Npix, Ppix, Vdir, kd, ks, shininess,
+                                         shadowIdx, shadow_at(Ppix, Npix));
                 uint8_t R,G,B;
                 if (tex) {  // Texture attached
                     Point2D uvPix(a0*UV[0].x + a1*UV[1].x + a2*UV[2].x,
                                   a0*UV[0].y + a1*UV[1].y + a2*UV[2].y);
                     tex->sample_bilinear(uvPix.x, uvPix.y, R,G,B);
-                    R = (uint8_t)(R * I); 
-                    G = (uint8_t)(G * I); 
-                    B = (uint8_t)(B * I);
+                    R = clamp255(R * I.x); 
+                    G = clamp255(G * I.y); 
+                    B = clamp255(B * I.z);
                 } else {  // Color path
                     Point3D Cpix(
                         a0*C[0].x + a1*C[1].x + a2*C[2].x,
                         a0*C[0].y + a1*C[1].y + a2*C[2].y,
                         a0*C[0].z + a1*C[1].z + a2*C[2].z); 
-                    R=(uint8_t)(255 * clamp01(Cpix.x * I));
-                    G=(uint8_t)(255 * clamp01(Cpix.y * I));
-                    B=(uint8_t)(255 * clamp01(Cpix.z * I));
+                    R=(uint8_t)(255 * clamp01(Cpix.x * I.x));
+                    G=(uint8_t)(255 * clamp01(Cpix.y * I.y));
+                    B=(uint8_t)(255 * clamp01(Cpix.z * I.z));
                 }
-                rb.set_pixel(x, y, R, G, B);
+                put(x, y, mask, R, G, B);
             }
         }
     }
@@ -0,0 +1,286 @@
+#pragma once
+#include "Mesh3D.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+// Quadric-error edge-collapse decimation (Garland & Heckbert).
+//
+// Faces are triangulated as fans. Vertices at the same position are welded
+// for the topology; a position whose vertices carry different UVs or colors
+// lies on a seam and is never moved, so seams survive exactly. Each
+// collapse moves one vertex onto a neighbour (half-edge collapse), so the
+// vertices that remain keep their own attributes and no new ones are made.
+// Border edges add a steep quadric across themselves and stay in place.
+// Candidate edges sit in a binary heap keyed by quadric error and are
+// updated lazily: a popped entry is re-costed, and goes back in if its
+// edge got dearer since it was pushed, so a collapse only pushes the edges
+// the surviving vertex gained. A collapse is refused if it would flip a
+// face or make an edge non-manifold.
+//
+// Stops at `targetFaces` triangles or when the cheapest collapse costs
+// more than `maxError`: the RMS distance (area-weighted, in mesh units)
+// from the moved vertex to the planes its quadric has gathered. `error`,
+// if given, receives the largest such cost accepted. This is an RMS
+// figure over vertices and does not bound the maximum deviation: a large
+// face left between vertices that all sit on the original surface can
+// still sag away from it (on a 1% icosphere: RMS 0.0005, gap 0.027).
+inline Mesh3D simplify_mesh(const Mesh3D& mesh, size_t targetFaces,
+                            double maxError = HUGE_VAL, double* error = nullptr) {
+    using Tri = std::array<int,3>;
+    const int nv = (int)mesh.vertices.size();
+    const bool hasUV = mesh.uv.size() == mesh.vertices.size();
+    const bool hasColor = mesh.colors.size() == mesh.vertices.size();
+
+    // Weld by position: pos[v] is the position id of vertex v
+    std::vector<int> pos(nv), rep;                  // rep: first vertex at each position
+    std::vector<char> seam;
+    {
+        struct Key { double x, y, z; bool operator==(const Key& o) const { return x==o.x && y==o.y && z==o.z; } };
+        struct Hash {
+            size_t operator()(const Key& k) const {
+                uint64_t h = 1469598103934665603ull, w[3];
+                std::memcpy(w, &k, sizeof w);
+                for (uint64_t x : w) h = (h ^ x) * 1099511628211ull;
+                return (size_t)(h ^ (h >> 29));
+            }
+        };
+        std::unordered_map<Key,int,Hash> ids;
+        ids.reserve(nv);
+        for (int v=0; v<nv; ++v) {
+            const Point3D& p = mesh.vertices[v];
+            auto it = ids.emplace(Key{ p.x, p.y, p.z }, (int)rep.size());
+            if (it.second) { rep.push_back(v); seam.push_back(0); }
+            int id = it.first->second;
+            pos[v] = id;
+            int r = rep[id];
+            if (r != v && ((hasUV && (mesh.uv[r].x != mesh.uv[v].x || mesh.uv[r].y != mesh.uv[v].y)) ||
+                           (hasColor && (mesh.colors[r].x != mesh.colors[v].x || mesh.colors[r].y != mesh.colors[v].y ||
+                                         mesh.colors[r].z != mesh.colors[v].z))))
+                seam[id] = 1;
+        }
+    }
+    const int np = (int)rep.size();
+    // Vertices that only duplicate their position's attributes collapse onto rep
+    auto corner = [&](int v) { return seam[pos[v]] ? v : rep[pos[v]]; };
+
+    std::vector<Tri> tris;
+    tris.reserve(mesh.faces.size());
+    for (const auto& f : mesh.faces)
+        for (size_t i=1; i+1<f.indices.size(); ++i) {
+            Tri t = { corner(f.indices[0]), corner(f.indices[i]), corner(f.indices[i+1]) };
+            if (pos[t[0]] != pos[t[1]] && pos[t[1]] != pos[t[2]] && pos[t[2]] != pos[t[0]]) tris.push_back(t);
+        }
+
+    // Quadrics: A (symmetric 3x3), b, c of Q(p) = p'Ap + 2b'p + c over
+    // area-weighted planes; eval() is the weighted mean squared distance
+    struct Quadric {
+        double a[11] = {};              // xx xy xz yy yz zz bx by bz c, weight
+        void add_plane(double nx, double ny, double nz, double d, double w) {
+            a[0]+=w*nx*nx; a[1]+=w*nx*ny; a[2]+=w*nx*nz; a[3]+=w*ny*ny; a[4]+=w*ny*nz; a[5]+=w*nz*nz;
+            a[6]+=w*nx*d;  a[7]+=w*ny*d;  a[8]+=w*nz*d;  a[9]+=w*d*d;  a[10]+=w;
+        }
+        void add(const Quadric& q) { for (int i=0; i<11; ++i) a[i] += q.a[i]; }
+        double eval(const Point3D& p) const {
+            double e = a[0]*p.x*p.x + 2*a[1]*p.x*p.y + 2*a[2]*p.x*p.z + a[3]*p.y*p.y + 2*a[4]*p.y*p.z
+                     + a[5]*p.z*p.z + 2*(a[6]*p.x + a[7]*p.y + a[8]*p.z) + a[9];
+            return a[10] > 0.0 ? e / a[10] : 0.0;
+        }
+    };
+    auto P = [&](int id) -> const Point3D& { return mesh.vertices[rep[id]]; };
+    std::vector<Quadric> Q(np);
+    for (const Tri& t : tris) {
+        const Point3D &p0 = P(pos[t[0]]), &p1 = P(pos[t[1]]), &p2 = P(pos[t[2]]);
+        Point3D n = (p1 - p0).cross(p2 - p0);
+        double len = n.length();
+        if (len == 0.0) continue;
+        double nx = n.x/len, ny = n.y/len, nz = n.z/len, d = -(nx*p0.x + ny*p0.y + nz*p0.z);
+        for (int k=0; k<3; ++k) Q[pos[t[k]]].add_plane(nx, ny, nz, d, 0.5 * len);
+    }
+
+    // Faces around each position
+    std::vector<std::vector<int>> around(np);
+    for (int f=0; f<(int)tris.size(); ++f)
+        for (int k=0; k<3; ++k) around[pos[tris[f][k]]].push_back(f);
+    std::vector<char> faceDead(tris.size(), 0), posDead(np, 0);
+
+    // Neighbours q > p of position p, each with the number of faces on edge
+    // pq and the last of them
+    struct Link { int q, faces, face; };
+    std::vector<Link> links;
+    auto link = [&](int p) {
+        links.clear();
+        for (int f : around[p])
+            for (int k=0; k<3; ++k) {
+                int q = pos[tris[f][k]];
+                if (q > p) links.push_back({ q, 1, f });
+            }
+        std::sort(links.begin(), links.end(), [](const Link& x, const Link& y) { return x.q < y.q; });
+        size_t m = 0;
+        for (size_t i=0; i<links.size(); ++i) {
+            if (m && links[m-1].q == links[i].q) { ++links[m-1].faces; links[m-1].face = links[i].face; }
+            else links[m++] = links[i];
+        }
+        links.resize(m);
+    };
+
+    // Border edges (one face): a heavy plane through the edge, across the face
+    for (int p=0; p<np; ++p) {
+        link(p);
+        for (const Link& l : links) {
+            if (l.faces != 1) continue;
+            const Tri& t = tris[l.face];
+            int c = pos[t[0]] != p && pos[t[0]] != l.q ? pos[t[0]] : pos[t[1]] != p && pos[t[1]] != l.q ? pos[t[1]] : pos[t[2]];
+            const Point3D &pa = P(p), &pb = P(l.q), &pc = P(c);
+            Point3D e = pb - pa, n = e.cross(pc - pa).cross(e);
+            double len = n.length();
+            if (len == 0.0) continue;
+            double nx = n.x/len, ny = n.y/len, nz = n.z/len, d = -(nx*pa.x + ny*pa.y + nz*pa.z);
+            double w = 1000.0 * e.dot(e);
+            Q[p].add_plane(nx, ny, nz, d, w);
+            Q[l.q].add_plane(nx, ny, nz, d, w);
+        }
+    }
+
+    struct Candidate {
+        float cost;
+        int from, to;
+        bool operator<(const Candidate& o) const { return cost > o.cost; }    // min-heap
+    };
+    // Cheaper direction of edge ab; false when both ends are on seams
+    auto candidate = [&](int a, int b, Candidate& out) {
+        Quadric q = Q[a];
+        q.add(Q[b]);
+        double toB = seam[a] ? HUGE_VAL : q.eval(P(b));
+        double toA = seam[b] ? HUGE_VAL : q.eval(P(a));
+        if (toB == HUGE_VAL && toA == HUGE_VAL) return false;
+        out = toB <= toA ? Candidate{ (float)std::max(0.0, toB), a, b }
+                         : Candidate{ (float)std::max(0.0, toA), b, a };
+        return true;
+    };
+    std::vector<Candidate> store;
+    store.reserve(tris.size() * 3 / 2 + 16);
+    for (int p=0; p<np; ++p) {
+        link(p);
+        for (const Link& l : links) {
+            Candidate c;
+            if (candidate(p, l.q, c)) store.push_back(c);
+        }
+    }
+    std::priority_queue<Candidate> heap(std::less<Candidate>(), std::move(store));
+
+    size_t alive = tris.size();
+    const double maxCost = maxError == HUGE_VAL ? HUGE_VAL : maxError * maxError;
+    double worst = 0.0;
+    std::vector<int> ringA, ringB;
+
+    while (alive > targetFaces && !heap.empty()) {
+        Candidate c = heap.top();
+        heap.pop();
+        if (c.cost > maxCost) break;
+        if (posDead[c.from] || posDead[c.to]) continue;
+        // Re-cost: an entry whose edge got dearer since it was pushed goes back in
+        Candidate now;
+        if (!candidate(c.from, c.to, now)) continue;
+        if (now.cost > c.cost) { heap.push(now); continue; }
+        const int a = now.from, b = now.to;
+
+        // Shared faces, the corner of b they use, and the link condition
+        auto& fa = around[a];
+        fa.erase(std::remove_if(fa.begin(), fa.end(), [&](int f) { return faceDead[f]; }), fa.end());
+        int bCorner = -1, shared = 0;
+        bool ok = true;
+        ringA.clear(); ringB.clear();
+        for (int f : fa) {
+            const Tri& t = tris[f];
+            int kb = -1;
+            for (int k=0; k<3; ++k) {
+                if (pos[t[k]] == b) kb = k;
+                if (pos[t[k]] != a) ringA.push_back(pos[t[k]]);
+            }
+            if (kb < 0) continue;
+            ++shared;
+            if (bCorner >= 0 && bCorner != t[kb]) ok = false;       // a seam of b runs between them
+            bCorner = t[kb];
+        }
+        if (!ok || shared == 0) continue;
+        for (int f : around[b]) {
+            if (faceDead[f]) continue;
+            for (int k=0; k<3; ++k) if (pos[tris[f][k]] != b) ringB.push_back(pos[tris[f][k]]);
+        }
+        std::sort(ringA.begin(), ringA.end()); ringA.erase(std::unique(ringA.begin(), ringA.end()), ringA.end());
+        std::sort(ringB.begin(), ringB.end()); ringB.erase(std::unique(ringB.begin(), ringB.end()), ringB.end());
+        int common = 0;
+        for (size_t i=0, j=0; i<ringA.size() && j<ringB.size(); ) {
+            if (ringA[i] < ringB[j]) ++i;
+            else if (ringB[j] < ringA[i]) ++j;
+            else { ++common; ++i; ++j; }
+        }
+        if (common != shared) continue;
+
+        // No face around a may flip or collapse to a sliver
+        const Point3D& pb = P(b);
+        for (int f : fa) {
+            const Tri& t = tris[f];
+            int ka = pos[t[0]] == a ? 0 : pos[t[1]] == a ? 1 : 2;
+            if (pos[t[(ka+1)%3]] == b || pos[t[(ka+2)%3]] == b) continue;
+            const Point3D& p1 = P(pos[t[(ka+1)%3]]);
+            const Point3D& p2 = P(pos[t[(ka+2)%3]]);
+            Point3D before = (p1 - P(a)).cross(p2 - P(a));
+            Point3D after  = (p1 - pb).cross(p2 - pb);
+            double la = after.length(), lb = before.length();
+            if (la == 0.0 || after.dot(before) < 0.2 * la * lb) { ok = false; break; }
+        }
+        if (!ok) continue;
+
+        // Collapse a onto b
+        for (int f : fa) {
+            Tri& t = tris[f];
+            bool hasB = false;
+            for (int k=0; k<3; ++k) hasB |= pos[t[k]] == b;
+            if (hasB) { faceDead[f] = 1; --alive; continue; }
+            for (int k=0; k<3; ++k) if (pos[t[k]] == a) t[k] = bCorner;
+            around[b].push_back(f);
+        }
+        fa.clear();
+        fa.shrink_to_fit();
+        posDead[a] = 1;
+        Q[b].add(Q[a]);
+        worst = std::max(worst, (double)now.cost);
+
+        // Edges b keeps are re-costed when they surface; a's other edges are new
+        for (int n : ringA) {
+            if (n == b || std::binary_search(ringB.begin(), ringB.end(), n)) continue;
+            Candidate nc;
+            if (candidate(b, n, nc)) heap.push(nc);
+        }
+    }
+    if (error) *error = std::sqrt(worst);
+
+    // Compact: surviving faces, the vertices they use, their attributes
+    Mesh3D out;
+    out.material = mesh.material;
+    std::vector<int> remap(nv, -1);
+    for (size_t f=0; f<tris.size(); ++f) {
+        if (faceDead[f]) continue;
+        Face face;
+        face.indices.resize(3);
+        for (int k=0; k<3; ++k) {
+            int v = tris[f][k];
+            if (remap[v] < 0) {
+                remap[v] = (int)out.vertices.size();
+                out.vertices.push_back(mesh.vertices[v]);
+                if (hasUV) out.uv.push_back(mesh.uv[v]);
+                if (hasColor) out.colors.push_back(mesh.colors[v]);
+            }
+            face.indices[k] = remap[v];
+        }
+        out.faces.push_back(std::move(face));
+    }
+    return out;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// Split [begin,end) into one contiguous chunk per worker and run
+// fn(chunkBegin, chunkEnd) on each. threads <= 0 uses every hardware thread.
+// Ranges shorter than 2*minChunk, or a single thread, run inline on the
+// caller with no thread spawned.
+template<typename Fn>
+void parallel_for(int begin, int end, Fn&& fn, int threads = 0, int minChunk = 1) {
+    if (end <= begin) return;
+    if (threads <= 0) threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    int n = end - begin;
+    threads = std::max(1, std::min(threads, n / std::max(1, minChunk)));
+    if (threads == 1) { fn(begin, end); return; }
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    int chunk = (n + threads - 1) / threads;
+    for (int t=1; t<threads; ++t) {
+        int b = begin + t*chunk, e = std::min(end, b + chunk);
+        if (b >= e) break;
+        pool.emplace_back([&fn, b, e] { fn(b, e); });
+    }
+    fn(begin, std::min(end, begin + chunk));
+    for (auto& th : pool) th.join();
+}
@@ -0,0 +1,284 @@
+#pragma once
+#include "Point2D.hpp"
+#include "RasterBuffer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+enum class LineJoin { Miter, Bevel, Round };
+enum class LineCap  { Butt, Square, Round };
+
+// Anti-aliased path rasterizer using signed-area accumulation (the scheme
+// font rasterizers use). Each edge deposits, into a float buffer, the exact
+// area it sweeps in every cell it crosses plus the coverage change it
+// causes to the cell's right; a prefix sum along each row then gives
+// per-pixel coverage. No supersampling, and the cost is linear in edge
+// length + touched pixels.
+//
+//   PathRasterizer path;
+//   path.begin(rb.width, rb.height);
+//   path.add_polygon(pts);                    // any number of contours
+//   path.add_stroke(line, 3.0, LineJoin::Round, LineCap::Round);
+//   path.fill(rb, 255, 200, 0);               // composite, then reset
+//
+// Coverage is min(1, |winding|), i.e. the non-zero rule. Polygons keep the
+// caller's winding, so an oppositely wound inner contour cuts a hole.
+// Stroke pieces (segment quads, joins, caps) are emitted as separate
+// same-orientation contours, so their overlaps union instead of cancelling.
+// Buffers are sized by begin() and reused: after warm-up nothing is
+// allocated.
+class PathRasterizer {
+public:
+    double miterLimit   = 4.0;   // miter length / half width before falling back to bevel
+    double roundTolerance = 0.1; // max pixel error of round joins/caps
+
+    // One contour, in the caller's winding
+    void add_polygon(const std::vector<Point2D>& pts) {
+        const size_t n = pts.size();
+        if (n < 3) return;
+        for (size_t i=0, j=n-1; i<n; j=i++) line(pts[j], pts[i]);
+    }
+
+    // Stroke a polyline of `width` pixels
+    void add_stroke(const std::vector<Point2D>& pts, double width,
+                    LineJoin join = LineJoin::Miter, LineCap cap = LineCap::Butt,
+                    bool closed = false) {
+        const double hw = 0.5 * width;
+        if (hw <= 0.0 || pts.empty()) return;
+
+        // Drop repeated points so every segment has a direction
+        clean.clear();
+        for (const auto& p : pts)
+            if (clean.empty() || p.distance_to(clean.back()) > 1e-9) clean.push_back(p);
+        if (closed && clean.size() > 2 && clean.front().distance_to(clean.back()) <= 1e-9) clean.pop_back();
+        const size_t n = clean.size();
+        if (n == 1) {
+            if (cap == LineCap::Round)  add_circle(clean[0], hw);
+            if (cap == LineCap::Square) add_quad(clean[0], Point2D(1,0), -hw, hw, hw);
+            return;
+        }
+
+        const size_t segs = closed ? n : n - 1;
+        for (size_t i=0; i<segs; ++i) {
+            const Point2D& a = clean[i];
+            const Point2D& b = clean[(i+1) % n];
+            Point2D d = (b - a).normalized();
+            double len = a.distance_to(b);
+            double ext0 = 0.0, ext1 = 0.0;
+            if (!closed && cap == LineCap::Square) {
+                if (i == 0)        ext0 = hw;
+                if (i == segs - 1) ext1 = hw;
+            }
+            add_quad(a, d, -ext0, len + ext1, hw);
+        }
+
+        // Joins at interior vertices (all vertices when closed)
+        for (size_t i = closed ? 0 : 1; i < (closed ? n : n - 1); ++i) {
+            const Point2D& p  = clean[i];
+            const Point2D& pa = clean[(i + n - 1) % n];
+            const Point2D& pb = clean[(i + 1) % n];
+            add_join(p, (p - pa).normalized(), (pb - p).normalized(), hw, join);
+        }
+
+        if (!closed && cap == LineCap::Round) {
+            add_circle(clean.front(), hw);
+            add_circle(clean.back(), hw);
+        }
+    }
+
+    // Size the accumulation buffer for a width x height target. Cheap when
+    // the size is unchanged, so call it before every path.
+    void begin(int width, int height) {
+        if (width == W && height == H) return;
+        W = width; H = height; S = W + 2;
+        accum.assign((size_t)S * H, 0.0f);
+        rowMin.assign(H, S);
+        rowMax.assign(H, -1);
+        yMin = H; yMax = -1;
+    }
+
+    // Composite the accumulated coverage over rb (source-over with `alpha`,
+    // inside rb.clip) and reset for the next path. rb must match the
+    // begin() size.
+    void fill(RasterBuffer<uint8_t>& rb, uint8_t r, uint8_t g, uint8_t b, double alpha = 1.0) {
+        composite(rb, r, g, b, alpha);
+    }
+    void fill(RasterBuffer<uint8_t>& rb, uint8_t gray, double alpha = 1.0) {
+        composite(rb, gray, gray, gray, alpha);
+    }
+
+private:
+    int W = 0, H = 0, S = 0;            // S = accumulation stride (W+2)
+    std::vector<float> accum;
+    std::vector<int>   rowMin, rowMax;  // touched cell range per row
+    int yMin = 0, yMax = -1;            // touched rows
+    std::vector<Point2D> clean, tmp;
+
+    // A stroke piece: same orientation for every piece so overlaps add up
+    void add_piece(const Point2D* p, size_t n) {
+        if (n < 3) return;
+        double area = 0.0;
+        for (size_t i=0, j=n-1; i<n; j=i++) area += (p[j].x - p[i].x) * (p[j].y + p[i].y);
+        if (area >= 0.0) for (size_t i=0, j=n-1; i<n; j=i++) line(p[j], p[i]);
+        else             for (size_t i=0, j=n-1; i<n; j=i++) line(p[i], p[j]);
+    }
+
+    // Rectangle along direction d from a + d*t0 to a + d*t1, half width hw
+    void add_quad(const Point2D& a, const Point2D& d, double t0, double t1, double hw) {
+        Point2D nrm(-d.y * hw, d.x * hw);
+        Point2D s = a + d * t0, e = a + d * t1;
+        Point2D q[4] = { s + nrm, e + nrm, e - nrm, s - nrm };
+        add_piece(q, 4);
+    }
+
+    void add_circle(const Point2D& c, double r) {
+        double ratio = std::max(-1.0, std::min(1.0, 1.0 - roundTolerance / std::max(r, 1e-9)));
+        int n = (int)std::ceil(M_PI / std::max(1e-3, std::acos(ratio)));
+        n = std::max(8, std::min(256, n));
+        tmp.resize(n);
+        for (int k=0; k<n; ++k) {
+            double t = 2.0 * M_PI * k / n;
+            tmp[k] = Point2D(c.x + r * std::cos(t), c.y + r * std::sin(t));
+        }
+        add_piece(tmp.data(), tmp.size());
+    }
+
+    void add_join(const Point2D& p, const Point2D& d0, const Point2D& d1, double hw, LineJoin join) {
+        double cross = d0.x * d1.y - d0.y * d1.x;
+        if (std::abs(cross) < 1e-9 && d0.x*d1.x + d0.y*d1.y > 0.0) return;   // straight on
+        if (join == LineJoin::Round) { add_circle(p, hw); return; }
+
+        // Outer side is opposite the turn
+        double s = (cross > 0.0) ? -1.0 : 1.0;
+        Point2D n0(-d0.y * hw * s, d0.x * hw * s);
+        Point2D n1(-d1.y * hw * s, d1.x * hw * s);
+        Point2D a = p + n0, b = p + n1;
+
+        if (join == LineJoin::Miter) {
+            Point2D mid = (n0 + n1);
+            double ml = mid.length();
+            if (ml > 1e-12) {
+                double cosHalf = (mid.x * n0.x + mid.y * n0.y) / (ml * hw);
+                if (cosHalf > 1e-9 && 1.0 / cosHalf <= miterLimit) {
+                    Point2D m = p + mid * (hw / (cosHalf * ml));
+                    Point2D q[4] = { p, a, m, b };
+                    add_piece(q, 4);
+                    return;
+                }
+            }
+        }
+        Point2D q[3] = { p, a, b };
+        add_piece(q, 3);
+    }
+
+    // Clip in x to [0,W] (parts left of the target collapse onto x=0, which
+    // keeps their winding for everything to the right), then accumulate
+    void line(const Point2D& p0, const Point2D& p1) {
+        if (p0.y == p1.y || W == 0) return;
+        double ts[4];
+        int n = 0;
+        ts[n++] = 0.0;
+        for (double xc : { 0.0, (double)W }) {
+            if ((p0.x < xc) != (p1.x < xc) && p0.x != xc && p1.x != xc)
+                ts[n++] = (xc - p0.x) / (p1.x - p0.x);
+        }
+        if (n == 3 && ts[1] > ts[2]) std::swap(ts[1], ts[2]);
+        ts[n++] = 1.0;
+        auto at = [&](double t) {
+            double x = (t == 1.0) ? p1.x : p0.x + t * (p1.x - p0.x);
+            double y = (t == 1.0) ? p1.y : p0.y + t * (p1.y - p0.y);
+            return Point2D(std::min(std::max(x, 0.0), (double)W), y);
+        };
+        for (int i=0; i+1<n; ++i) accumulate(at(ts[i]), at(ts[i+1]));
+    }
+
+    void touch(int y, int x0, int x1) {
+        rowMin[y] = std::min(rowMin[y], x0);
+        rowMax[y] = std::max(rowMax[y], x1);
+    }
+
+    void accumulate(Point2D p0, Point2D p1) {
+        if (p0.y == p1.y) return;
+        float dir = 1.0f;
+        if (p0.y > p1.y) { std::swap(p0, p1); dir = -1.0f; }
+        if (p1.y <= 0.0 || p0.y >= H) return;
+
+        const double dxdy = (p1.x - p0.x) / (p1.y - p0.y);
+        double x = p0.x;
+        if (p0.y < 0.0) x -= p0.y * dxdy;
+        int yStart = std::max(0, (int)std::floor(p0.y));
+        int yEnd   = std::min(H, (int)std::ceil(p1.y));
+        yMin = std::min(yMin, yStart);
+        yMax = std::max(yMax, yEnd - 1);
+
+        for (int y = yStart; y < yEnd; ++y) {
+            float* row = &accum[(size_t)y * S];
+            double dy = std::min((double)y + 1.0, p1.y) - std::max((double)y, p0.y);
+            double xnext = x + dxdy * dy;
+            double d = dy * dir;
+            double x0 = std::max(0.0, std::min(x, xnext));
+            double x1 = std::min((double)W, std::max(x, xnext));
+            double x0floor = std::floor(x0);
+            int x0i = (int)x0floor;
+            double x1ceil = std::ceil(x1);
+            int x1i = (int)x1ceil;
+
+            if (x1i <= x0i + 1) {
+                // Within one cell: split by the mean x
+                double xmf = 0.5 * (x + xnext) - x0floor;
+                row[x0i]     += (float)(d - d * xmf);
+                row[x0i + 1] += (float)(d * xmf);
+                touch(y, x0i, x0i + 1);
+            } else {
+                double s = 1.0 / (x1 - x0);
+                double x0f = x0 - x0floor;
+                double a0 = 0.5 * s * (1.0 - x0f) * (1.0 - x0f);
+                double x1f = x1 - x1ceil + 1.0;
+                double am = 0.5 * s * x1f * x1f;
+                row[x0i] += (float)(d * a0);
+                if (x1i == x0i + 2) {
+                    row[x0i + 1] += (float)(d * (1.0 - a0 - am));
+                } else {
+                    double a1 = s * (1.5 - x0f);
+                    row[x0i + 1] += (float)(d * (a1 - a0));
+                    for (int xi = x0i + 2; xi < x1i - 1; ++xi) row[xi] += (float)(d * s);
+                    double a2 = a1 + (x1i - x0i - 3) * s;
+                    row[x1i - 1] += (float)(d * (1.0 - a2 - am));
+                }
+                row[x1i] += (float)(d * am);
+                touch(y, x0i, x1i);
+            }
+            x = xnext;
+        }
+    }
+
+    void composite(RasterBuffer<uint8_t>& rb, uint8_t r, uint8_t g, uint8_t b, double alpha) {
+        if (rb.width != W || rb.height != H)
+            throw std::runtime_error("PathRasterizer: target size differs from begin()");
+        const int C = rb.channels;
+        const float a = (float)std::max(0.0, std::min(1.0, alpha));
+        const float src[4] = { (float)r, (float)g, (float)b, 255.0f };
+        const float gray = (r + g + b) / 3.0f;
+        for (int y = std::max(0, yMin); y <= std::min(H - 1, yMax); ++y) {
+            if (rowMax[y] < 0) continue;
+            float* row = &accum[(size_t)y * S];
+            int x0 = rowMin[y], x1 = std::min(rowMax[y], rb.clip.x1 - 1);
+            float acc = 0.0f;
+            if (y < rb.clip.y0 || y >= rb.clip.y1) x1 = -1;      // outside the clip: just reset
+            for (; x0 < rb.clip.x0 && x0 <= x1; ++x0) acc += row[x0];
+            uint8_t* px = rb.data.data() + ((size_t)y * W + x0) * C;
+            for (int x = x0; x <= x1; ++x, px += C) {
+                acc += row[x];
+                float cov = std::min(1.0f, std::abs(acc)) * a;
+                if (cov <= 0.0f) continue;
+                if (C == 1) px[0] = (uint8_t)(px[0] + (gray - px[0]) * cov + 0.5f);
+                else for (int c = 0; c < C; ++c) px[c] = (uint8_t)(px[c] + (src[c] - px[c]) * cov + 0.5f);
+            }
+            std::fill(row + rowMin[y], row + rowMax[y] + 1, 0.0f);
+            rowMin[y] = S; rowMax[y] = -1;
+        }
+        yMin = H; yMax = -1;
+    }
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include <algorithm>
+#include <climits>
+
+// Pixels [x0,x1) x [y0,y1)
+struct PixelRect {
+    int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+
+    bool empty() const { return x0 >= x1 || y0 >= y1; }
+    long long area() const { return empty() ? 0 : (long long)(x1 - x0) * (y1 - y0); }
+
+    bool intersects(const PixelRect& o) const {
+        return !empty() && !o.empty() && x0 < o.x1 && o.x0 < x1 && y0 < o.y1 && o.y0 < y1;
+    }
+    PixelRect intersected(const PixelRect& o) const {
+        return { std::max(x0, o.x0), std::max(y0, o.y0), std::min(x1, o.x1), std::min(y1, o.y1) };
+    }
+    // Bounding box of both; an empty rect adds nothing
+    PixelRect united(const PixelRect& o) const {
+        if (empty()) return o;
+        if (o.empty()) return *this;
+        return { std::min(x0, o.x0), std::min(y0, o.y0), std::max(x1, o.x1), std::max(y1, o.y1) };
+    }
+
+    // For objects that cannot say where they draw
+    static PixelRect everything() { return { INT_MIN / 2, INT_MIN / 2, INT_MAX / 2, INT_MAX / 2 }; }
+};
@@ -6,6 +6,10 @@
 #include <type_traits>
 #include <cstdint>
 #include <cctype> 
+#include <cmath>
+#include <algorithm>
+
+#include "PixelRect.hpp"
 
 #ifdef USE_STB_IMAGE_WRITE
 #include "stb_image_write.h"
@@ -17,10 +21,12 @@ public:
     int width, height, channels; // channels = 1 (gray) or 3 (RGB) or 4 (RGBA)
     std::vector<PixelT> data;
     std::vector<double> depth; // Z-buffer
+    PixelRect clip;            // drawing (set_pixel, spans, lines...) stays inside
 
     RasterBuffer(int w, int h, int c=1, PixelT clear=0, bool enableDepth=false)
         : width(w), height(h), channels(c), data(w*h*c, clear),
-          depth(enableDepth ? std::vector<double>(w*h, 1e9) : std::vector<double>()) {
+          depth(enableDepth ? std::vector<double>(w*h, 1e9) : std::vector<double>()),
+          clip{ 0, 0, w, h } {
         if (w<=0 || h<=0 || (c!=1 && c!=3 && c!=4)) {
             throw std::runtime_error("RasterBuffer: invalid dimensions or channels");
         }
@@ -29,12 +35,21 @@ public:
     inline bool has_depth() const { return !depth.empty(); }
     inline void clear_depth(double val=1e9) {
         if (has_depth()) std::fill(depth.begin(), depth.end(), val);
+        clear_sample_depth(val);
     }
 
     inline bool in_bounds(int x,int y) const {
         return (x>=0 && x<width && y>=0 && y<height);
     }
 
+    // Restrict drawing to r (intersected with the buffer), e.g. to repaint
+    // one damaged rectangle. Reads and post passes ignore the clip.
+    void set_clip(const PixelRect& r) { clip = r.intersected({ 0, 0, width, height }); }
+    void reset_clip() { clip = { 0, 0, width, height }; }
+    inline bool in_clip(int x, int y) const {
+        return x >= clip.x0 && x < clip.x1 && y >= clip.y0 && y < clip.y1;
+    }
+
     inline bool test_and_set_depth(int x, int y, double z) {
         if (!has_depth() || !in_bounds(x,y)) return true;
         size_t idx = (size_t)y*width + x;
@@ -42,6 +57,108 @@ public:
         return false; // occluded
     }
 
+    // Depth test for a shading pass that follows a depth-only prepass: the
+    // surface that won the prepass passes again (within a relative epsilon),
+    // anything behind it is rejected.
+    inline bool test_and_set_depth_le(int x, int y, double z) {
+        if (!has_depth() || !in_bounds(x,y)) return true;
+        size_t idx = (size_t)y*width + x;
+        double d = depth[idx];
+        if (z <= d + 1e-9*std::abs(d) + 1e-12) { if (z < d) depth[idx] = z; return true; }
+        return false; // occluded
+    }
+
+    // --- MSAA: `samples` color+depth samples per pixel ---
+    // Samples of one pixel are contiguous: sample s of pixel i lives at
+    // sampleDepth[i*samples+s] and sampleData[(i*samples+s)*channels].
+    // Renderers write samples; resolve() box-filters them into `data` and
+    // the nearest sample depth into `depth`.
+    int samples = 1;                  // 1 = MSAA off
+    std::vector<PixelT> sampleData;
+    std::vector<double> sampleDepth;
+
+    inline bool msaa() const { return samples > 1; }
+
+    // n in {1,2,4,8}; samples start as copies of the current pixels
+    void enable_msaa(int n) {
+        if (n != 1 && n != 2 && n != 4 && n != 8)
+            throw std::runtime_error("RasterBuffer: MSAA sample count must be 1, 2, 4 or 8");
+        samples = n;
+        if (n == 1) { sampleData.clear(); sampleDepth.clear(); return; }
+        const size_t px = (size_t)width*height;
+        sampleData.resize(px*n*channels);
+        for (size_t i=0;i<px;++i)
+            for (int s=0;s<n;++s)
+                std::copy_n(&data[i*channels], channels, &sampleData[(i*n+s)*channels]);
+        sampleDepth.assign(has_depth() ? px*n : 0, 1e9);
+    }
+
+    // Sample positions inside the pixel, (dx,dy) pairs in [0,1); the
+    // standard rotated-grid patterns so edges at any angle get N levels
+    static const float* sample_pattern(int n) {
+        static const float p1[] = { 0.5f,0.5f };
+        static const float p2[] = { 0.75f,0.75f, 0.25f,0.25f };
+        static const float p4[] = { 0.375f,0.125f, 0.875f,0.375f, 0.125f,0.625f, 0.625f,0.875f };
+        static const float p8[] = { 0.5625f,0.3125f, 0.4375f,0.6875f, 0.8125f,0.5625f, 0.3125f,0.1875f,
+                                    0.1875f,0.8125f, 0.0625f,0.4375f, 0.6875f,0.9375f, 0.9375f,0.0625f };
+        switch (n) { case 2: return p2; case 4: return p4; case 8: return p8; default: return p1; }
+    }
+
+    inline void clear_samples(PixelT val) {
+        std::fill(sampleData.begin(), sampleData.end(), val);
+    }
+    inline void clear_sample_depth(double val=1e9) {
+        std::fill(sampleDepth.begin(), sampleDepth.end(), val);
+    }
+
+    // Same contract as test_and_set_depth / _le, per sample
+    inline bool test_and_set_sample_depth(int x, int y, int s, double z) {
+        if (sampleDepth.empty() || !in_bounds(x,y)) return true;
+        double& d = sampleDepth[((size_t)y*width + x)*samples + s];
+        if (z < d) { d = z; return true; }
+        return false;
+    }
+    inline bool test_and_set_sample_depth_le(int x, int y, int s, double z) {
+        if (sampleDepth.empty() || !in_bounds(x,y)) return true;
+        double& d = sampleDepth[((size_t)y*width + x)*samples + s];
+        if (z <= d + 1e-9*std::abs(d) + 1e-12) { if (z < d) d = z; return true; }
+        return false;
+    }
+
+    // Write one shaded color to every sample in `mask` (bit s = sample s)
+    void set_samples(int x, int y, uint32_t mask, PixelT r, PixelT g, PixelT b, PixelT a=255) {
+        if (!in_clip(x,y)) return;
+        PixelT v[4] = { r, g, b, a };
+        if (channels==1) v[0] = (PixelT)((r+g+b)/3);
+        PixelT* p = &sampleData[((size_t)y*width + x)*samples*channels];
+        for (int s=0; s<samples; ++s, p+=channels)
+            if (mask & (1u<<s)) std::copy_n(v, channels, p);
+    }
+
+    // Box-filter samples into `data`, nearest sample depth into `depth`
+    void resolve() {
+        if (!msaa()) return;
+        const size_t px = (size_t)width*height;
+        const double inv = 1.0 / samples;
+        for (size_t i=0;i<px;++i) {
+            const PixelT* p = &sampleData[i*samples*channels];
+            for (int c=0;c<channels;++c) {
+                double acc = 0.0;
+                for (int s=0;s<samples;++s) acc += p[s*channels + c];
+                data[i*channels + c] = std::is_integral<PixelT>::value
+                                     ? (PixelT)(acc*inv + 0.5) : (PixelT)(acc*inv);
+            }
+        }
+        resolve_depth();
+    }
+
+    void resolve_depth() {
+        if (!msaa() || sampleDepth.empty() || !has_depth()) return;
+        const size_t px = (size_t)width*height;
+        for (size_t i=0;i<px;++i)
+            depth[i] = *std::min_element(&sampleDepth[i*samples], &sampleDepth[i*samples] + samples);
+    }
+
     void save_png(const std::string& filename) const {
     #ifndef USE_STB_IMAGE_WRITE
         throw std::runtime_error("RasterBuffer: stb_image_write not enabled");
@@ -65,7 +182,7 @@ public:
 
     // --- Set pixel (grayscale, RGB, RGBA) ---
     void set_pixel(int x,int y, PixelT gray) {
-        if (!in_bounds(x,y)) return;
+        if (!in_clip(x,y)) return;
         size_t idx = ((size_t)y*width + x)*channels;
         if (channels==1) {
             data[idx] = gray;
@@ -75,7 +192,7 @@ public:
     }
 
     void set_pixel(int x,int y, PixelT r, PixelT g, PixelT b, PixelT a=255) {
-        if (!in_bounds(x,y)) return;
+        if (!in_clip(x,y)) return;
         size_t idx = ((size_t)y*width + x)*channels;
         if (channels==3) {
             data[idx+0]=r; data[idx+1]=g; data[idx+2]=b;
@@ -87,6 +204,66 @@ public:
         }
     }
 
+    // --- Spans: pixels [x0,x1) of row y ---
+    // Clipped (to `clip`) once per span, then written without per-pixel bounds checks.
+    // Depth-tested spans take z linear in x, z(x) = z0 + (x - x0)*dz with
+    // x0 the unclipped start, and follow test_and_set_depth (no Z-buffer =
+    // every pixel passes).
+
+    inline bool clip_span(int y, int& x0, int& x1) const {
+        if (y < clip.y0 || y >= clip.y1) return false;
+        x0 = std::max(x0, clip.x0);
+        x1 = std::min(x1, clip.x1);
+        return x0 < x1;
+    }
+
+    void fill_span(int y, int x0, int x1, PixelT gray) {
+        if (!clip_span(y, x0, x1)) return;
+        PixelT* p = &data[((size_t)y*width + x0)*channels];
+        std::fill(p, p + (size_t)(x1 - x0)*channels, gray);
+    }
+
+    void fill_span(int y, int x0, int x1, PixelT r, PixelT g, PixelT b, PixelT a=255) {
+        if (channels == 1) { fill_span(y, x0, x1, (PixelT)((r+g+b)/3)); return; }
+        if (!clip_span(y, x0, x1)) return;
+        PixelT* p = &data[((size_t)y*width + x0)*channels];
+        const PixelT v[4] = { r, g, b, a };
+        for (int x=x0; x<x1; ++x, p+=channels) std::copy_n(v, channels, p);
+    }
+
+    void fill_span_depth(int y, int x0, int x1, double z0, double dz, PixelT gray) {
+        fill_span_depth_fn(y, x0, x1, z0, dz, [gray](int) { return gray; });
+    }
+
+    // Gray value interpolated like z: i(x) = i0 + (x - x0)*di, clamped to
+    // 0..255 for integer pixels
+    void fill_span_shaded(int y, int x0, int x1, double z0, double dz, double i0, double di) {
+        const int xs = x0;
+        fill_span_depth_fn(y, x0, x1, z0, dz, [=](int x) {
+            double v = i0 + (x - xs)*di;
+            if (std::is_integral<PixelT>::value) v = std::min(255.0, std::max(0.0, v));
+            return (PixelT)v;
+        });
+    }
+
+    // shade(x) -> PixelT gray, evaluated only for pixels that pass the depth test
+    template<typename Fn>
+    void fill_span_depth_fn(int y, int x0, int x1, double z0, double dz, Fn&& shade) {
+        const int xs = x0;
+        if (!clip_span(y, x0, x1)) return;
+        const size_t row = (size_t)y*width;
+        PixelT* p = &data[(row + x0)*channels];
+        if (!has_depth()) {
+            for (int x=x0; x<x1; ++x, p+=channels) std::fill_n(p, channels, shade(x));
+            return;
+        }
+        double* d = &depth[row + x0];
+        for (int x=x0; x<x1; ++x, p+=channels, ++d) {
+            double z = z0 + (x - xs)*dz;
+            if (z < *d) { *d = z; std::fill_n(p, channels, shade(x)); }
+        }
+    }
+
     inline void get_pixel(int x, int y, PixelT& r, PixelT& g, PixelT& b, PixelT& a) const {
         r=g=b=0; a=255;
         if (!in_bounds(x,y)) return;
@@ -120,6 +297,29 @@ public:
         }
     }
 
+    // Only `region` (clipped to the buffer), e.g. the damage of a redraw
+    void save_ppm(const std::string& filename, const PixelRect& region) const {
+        PixelRect r = region.intersected({ 0, 0, width, height });
+        if (r.empty()) throw std::runtime_error("RasterBuffer: empty region");
+        std::ofstream ofs(filename, std::ios::binary);
+        if (!ofs) throw std::runtime_error("RasterBuffer: cannot open file");
+
+        const int w = r.x1 - r.x0;
+        ofs << (channels==1 ? "P5\n" : "P6\n") << w << " " << (r.y1 - r.y0) << "\n255\n";
+        std::vector<char> row((size_t)w * (channels==1 ? 1 : 3));
+        for (int y=r.y0; y<r.y1; ++y) {
+            const PixelT* p = &data[((size_t)y*width + r.x0)*channels];
+            if (channels==1) {
+                for (int x=0; x<w; ++x) row[x] = (char)p[x];
+            } else {
+                for (int x=0; x<w; ++x, p+=channels) {
+                    row[x*3+0] = (char)p[0]; row[x*3+1] = (char)p[1]; row[x*3+2] = (char)p[2];
+                }
+            }
+            ofs.write(row.data(), row.size());
+        }
+    }
+
     // Utility: lowercase a string
 inline std::string toLower(const std::string& s) {
     std::string out = s;
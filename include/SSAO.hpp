@@ -0,0 +1,304 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "RasterBuffer.hpp"
+#include "Projection3D.hpp"
+#include "ParallelFor.hpp"
+
+// Screen-space ambient occlusion as a post pass over RasterBuffer::depth.
+//
+// Run it once per frame after every MeshRenderer2D::render() call that
+// contributes to the buffer:
+//
+//   renderer.render(mesh, vnorm, RenderMode::Phong);
+//   ssao.apply(rb, proj);
+//
+// Occlusion is computed on a grid `downsample` times coarser than the
+// buffer, point-sampling the depth so no position is averaged across a
+// silhouette. View-space positions are rebuilt from depth and the
+// projection, normals from depth differences. Occlusion comes from four 1D
+// horizon sweeps per texel, both ways along its row and column: in each
+// direction the highest neighbour above the tangent plane within `radius`
+// (weighted by distance) occludes. A depth-aware (bilateral) blur, split
+// into row and column passes, removes the banding, and a depth-aware
+// bilinear upsample brings the term back to full resolution. Row passes run
+// on bands of rows per thread; column passes on bands of `tileSize`
+// columns, so the rows they touch stay in cache.
+//
+// With budgetMsPerMP > 0 the step count adapts from frame to frame to stay
+// under that many milliseconds per (full-resolution) megapixel, with room
+// to spare for jitter.
+class SSAOPass {
+public:
+    static constexpr int kMaxSteps = 32;
+
+    double radius       = 0.6;    // view-space sampling radius
+    double strength     = 3.0;
+    double bias         = 0.1;    // ignore samples this close to the tangent plane (fraction of radius)
+    int    steps        = 6;      // samples per direction per axis (at most kMaxSteps)
+    int    minSteps     = 2;
+    int    maxSteps     = 12;
+    int    downsample   = 2;      // AO grid is 1/downsample of the buffer per axis
+    int    blurRadius   = 3;      // in AO-grid pixels
+    double depthSigma   = 0.02;   // relative depth difference tolerated by blur and upsample
+    double budgetMsPerMP = 0.0;   // 0 = fixed `steps`
+    int    threads      = 0;      // 0 = hardware concurrency
+    int    tileSize     = 64;     // column band width for vertical passes
+    double emptyDepth   = 1e9;    // RasterBuffer's clear value
+
+    double lastMs      = 0.0;     // wall time of the last apply()
+    double lastMsPerMP = 0.0;
+
+    std::vector<float> ao;        // last AO term per pixel, 1 = unoccluded
+
+    // Step count the budget controller picks after a frame that took
+    // msPerMP. It aims at 3/4 of the budget so frame-to-frame jitter stays
+    // under it: steps drop in proportion once past 0.85, and one is added
+    // only if the frame scaled by (steps+1)/steps would still be under the
+    // aim. apply() adopts it when budgetMsPerMP > 0.
+    int planned_steps(double msPerMP) const {
+        if (budgetMsPerMP <= 0.0) return steps;
+        const double aim = 0.75 * budgetMsPerMP;
+        if (msPerMP > 0.85 * budgetMsPerMP && steps > minSteps)
+            return std::max(minSteps, (int)(steps * aim / msPerMP));
+        if (msPerMP * (steps + 1) < aim * steps && steps < maxSteps)
+            return steps + 1;
+        return steps;
+    }
+
+    template<typename PixelT>
+    void apply(RasterBuffer<PixelT>& rb, const Projection3D& proj) {
+        if (!rb.has_depth()) return;
+        auto t0 = std::chrono::steady_clock::now();
+
+        W = rb.width; H = rb.height;
+        ds = std::max(1, downsample);
+        w = (W + ds - 1) / ds; h = (H + ds - 1) / ds;
+        const size_t n = (size_t)W*H, m = (size_t)w*h;
+        depth = rb.depth.data();
+        pos.resize(m); nrm.resize(m);
+        lowValid.resize(m);
+        lowAo.resize(m); tmp.resize(m);
+        ao.resize(n);
+
+        perspective = (proj.type == ProjectionType::PERSPECTIVE);
+        focal = perspective ? 1.0 / std::tan(proj.fov / 2.0) : 1.0;
+
+        lowRows([&](int y0, int y1) { reconstruct(y0, y1); });
+        lowRows([&](int y0, int y1) { normals(y0, y1); });
+        // sampling radius in AO texels at view depth 1 (perspective) or anywhere (orthographic)
+        const float rPxAt1 = (float)(radius * focal * 0.5 * H / ds);
+        lowRows([&](int y0, int y1) { for (int y=y0;y<y1;++y) for (int x=0;x<w;++x) occlusion(x, y, rPxAt1, lowAo); });
+
+        gaussian.resize(blurRadius + 1);
+        for (int k=0;k<=blurRadius;++k) {
+            double s = std::max(1.0, blurRadius * 0.5);
+            gaussian[k] = (float)std::exp(-(k*k) / (2.0*s*s));
+        }
+        lowRows([&](int y0, int y1) { for (int y=y0;y<y1;++y) for (int x=0;x<w;++x) blur(x, y, true, lowAo, tmp); });
+        lowCols([&](int x0, int x1) { for (int y=0;y<h;++y) for (int x=x0;x<x1;++x) blur(x, y, false, tmp, lowAo); });
+
+        parallel_for(0, H, [&](int y0, int y1) {
+            for (int y=y0;y<y1;++y) {
+                if (ds > 1) upsample_row(y);
+                else for (int x=0;x<W;++x) ao[(size_t)y*W + x] = depth[(size_t)y*W + x] < emptyDepth ? lowAo[(size_t)y*W + x] : 1.0f;
+                for (int x=0;x<W;++x) {
+                    size_t i = (size_t)y*W + x;
+                    float a = ao[i];
+                    if (a >= 1.0f) continue;              // open or empty
+                    size_t p = i*rb.channels;
+                    int cc = (rb.channels == 4) ? 3 : rb.channels;   // leave alpha alone
+                    for (int c=0;c<cc;++c) rb.data[p+c] = (PixelT)(rb.data[p+c] * a);
+                }
+            }
+        }, threads, 16);
+
+        auto t1 = std::chrono::steady_clock::now();
+        lastMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        lastMsPerMP = lastMs / (n / 1e6);
+        if (budgetMsPerMP > 0.0) steps = planned_steps(lastMsPerMP);
+    }
+
+private:
+    int W = 0, H = 0;             // buffer
+    int w = 0, h = 0, ds = 1;     // AO grid
+    const double* depth = nullptr;
+    bool   perspective = true;
+    double focal = 1.0;
+    struct Vec3f { float x, y, z; };
+    std::vector<Vec3f> pos, nrm;  // view-space position/normal per AO texel
+    std::vector<uint8_t> lowValid;
+    std::vector<float> lowAo, tmp, gaussian;
+
+    inline bool valid(size_t i) const { return lowValid[i] != 0; }
+
+    template<typename Fn> void lowRows(Fn&& fn) { parallel_for(0, h, fn, threads, 16); }
+    template<typename Fn> void lowCols(Fn&& fn) {
+        int tiles = (w + tileSize - 1) / tileSize;
+        parallel_for(0, tiles, [&](int t0, int t1) {
+            fn(t0*tileSize, std::min(w, t1*tileSize));
+        }, threads, 1);
+    }
+
+    // AO texel (x,y) takes the depth of buffer pixel (x*ds, y*ds); position
+    // is the inverse of Projection3D::project + the renderer's viewport
+    void reconstruct(int y0, int y1) {
+        for (int y=y0;y<y1;++y) {
+            const int by = y*ds;
+            double ndcY = 1.0 - 2.0*(by + 0.5)/H;
+            for (int x=0;x<w;++x) {
+                const int bx = x*ds;
+                size_t i = (size_t)y*w + x;
+                double z = depth[(size_t)by*W + bx];
+                lowValid[i] = z < emptyDepth;
+                if (!lowValid[i]) z = emptyDepth;
+                double ndcX = 2.0*(bx + 0.5)/W - 1.0;
+                double s = perspective ? z / focal : 1.0;
+                pos[i] = { (float)(ndcX * s), (float)(ndcY * s), (float)z };
+            }
+        }
+    }
+
+    // Normal from the flatter of the two one-sided depth differences per
+    // axis, so silhouettes don't smear normals across depth jumps
+    void normals(int y0, int y1) {
+        auto diff = [&](size_t i, size_t a, size_t b, bool hasA, bool hasB,
+                        float& dx, float& dy, float& dz) {
+            bool useA = hasA && valid(a);
+            bool useB = hasB && valid(b);
+            if (useA && useB) {
+                if (std::abs(pos[a].z-pos[i].z) < std::abs(pos[b].z-pos[i].z)) useB = false; else useA = false;
+            }
+            if (useA)      { dx = pos[i].x-pos[a].x; dy = pos[i].y-pos[a].y; dz = pos[i].z-pos[a].z; }
+            else if (useB) { dx = pos[b].x-pos[i].x; dy = pos[b].y-pos[i].y; dz = pos[b].z-pos[i].z; }
+            else           { dx = dy = dz = 0.0f; }
+        };
+        for (int y=y0;y<y1;++y) {
+            for (int x=0;x<w;++x) {
+                size_t i = (size_t)y*w + x;
+                nrm[i] = { 0.0f, 0.0f, 0.0f };
+                if (!valid(i)) continue;
+                float ax, ay, az, bx, by, bz;
+                diff(i, i-1, i+1, x>0, x+1<w, ax, ay, az);
+                diff(i, i-w, i+w, y>0, y+1<h, bx, by, bz);
+                float cx = ay*bz - az*by, cy = az*bx - ax*bz, cz = ax*by - ay*bx;
+                // face the camera (at the origin)
+                if (cx*pos[i].x + cy*pos[i].y + cz*pos[i].z > 0) { cx = -cx; cy = -cy; cz = -cz; }
+                float len = std::sqrt(cx*cx + cy*cy + cz*cz);
+                if (len > 0) nrm[i] = { cx/len, cy/len, cz/len };
+            }
+        }
+    }
+
+    // Four 1D horizon sweeps, both ways along the row and the column: per
+    // direction the strongest occluder, its height above the tangent plane
+    // over `radius` (less bias) times a distance falloff; `out` gets
+    // 1 - strength * their mean. No square roots or divides per sample.
+    // Empty texels sit at emptyDepth, far outside the radius, so they need
+    // no test of their own.
+    void occlusion(int x, int y, float rPxAt1, std::vector<float>& out) {
+        size_t i = (size_t)y*w + x;
+        out[i] = 1.0f;
+        if (!valid(i)) return;
+        const Vec3f P = pos[i], N = nrm[i];
+        const float rPx = perspective ? rPxAt1 / std::max(1e-6f, P.z) : rPxAt1;
+        const int ns = std::max(1, std::min(steps, kMaxSteps));
+        const float stride = std::max(1.0f, rPx / ns);
+        const float invR = (float)(1.0 / radius), invR2 = invR*invR, b = (float)bias;
+        // Texel offsets of the samples, shared by the four directions
+        int offs[kMaxSteps + 1];
+        for (int s=1; s<=ns; ++s) offs[s] = (int)(s * stride + 0.5f);
+        auto dir = [&](int n, ptrdiff_t step) {
+            float best = 0.0f;
+            for (int s=1; s<=n; ++s) {
+                const Vec3f& Q = pos[i + offs[s]*step];
+                float vx = Q.x-P.x, vy = Q.y-P.y, vz = Q.z-P.z;
+                float d2 = vx*vx + vy*vy + vz*vz;
+                float c = (N.x*vx + N.y*vy + N.z*vz) * invR - b;
+                best = std::max(best, c * std::max(0.0f, 1.0f - d2 * invR2));
+            }
+            return best;
+        };
+        // Samples that stay inside [0, limit) going back and forward from at
+        auto sweep = [&](int at, int limit, ptrdiff_t step) {
+            int back = ns, fwd = ns;
+            while (back > 0 && at - offs[back] < 0) --back;
+            while (fwd > 0 && at + offs[fwd] >= limit) --fwd;
+            return dir(back, -step) + dir(fwd, step);
+        };
+        float occ = 0.25f * (sweep(x, w, 1) + sweep(y, h, (ptrdiff_t)w));
+        out[i] = std::max(0.0f, 1.0f - (float)strength * occ);
+    }
+
+    // Bilateral: Gaussian in pixels times a relative depth similarity term,
+    // (1 - t^2/4)^2 for t depth tolerances apart (0 from two on). Empty
+    // texels sit at emptyDepth, so they get weight 0 without a test.
+    // along the row when horizontal, else along the column
+    void blur(int x, int y, bool horizontal, const std::vector<float>& in, std::vector<float>& out) {
+        size_t i = (size_t)y*w + x;
+        if (!valid(i)) { out[i] = 1.0f; return; }
+        const float z = pos[i].z;
+        const float inv = 1.0f / std::max(1e-9f, (float)depthSigma * std::abs(z));
+        const int at = horizontal ? x : y, limit = horizontal ? w : h;
+        const int k0 = std::max(-blurRadius, -at), k1 = std::min(blurRadius, limit - 1 - at);
+        const ptrdiff_t step = horizontal ? 1 : (ptrdiff_t)w;
+        float acc = 0.0f, wsum = 0.0f;
+        for (int k=k0; k<=k1; ++k) {
+            size_t q = i + k*step;
+            float t = (pos[q].z - z) * inv;
+            float s = std::max(0.0f, 1.0f - 0.25f*t*t);
+            float wt = gaussian[std::abs(k)] * s * s;
+            acc += wt * in[q];
+            wsum += wt;
+        }
+        out[i] = acc / wsum;            // the centre texel has weight 1
+    }
+
+    // Row y of `ao` from the AO grid: bilinear over the four surrounding
+    // texels. Where the pixel's depth falls outside theirs (a silhouette
+    // runs through the cell) each texel is also weighted by depth
+    // similarity, so occlusion doesn't bleed across the edge.
+    void upsample_row(int y) {
+        const float invDs = 1.0f / ds, sigma = (float)depthSigma;
+        const int gy0 = std::min(y / ds, h-1), gy1 = std::min(gy0 + 1, h-1);
+        const float ty = (y - gy0*ds) * invDs;
+        const Vec3f* z0 = &pos[(size_t)gy0*w];
+        const Vec3f* z1 = &pos[(size_t)gy1*w];
+        const float* a0 = &lowAo[(size_t)gy0*w];
+        const float* a1 = &lowAo[(size_t)gy1*w];
+        const double* drow = depth + (size_t)y*W;
+        float* out = &ao[(size_t)y*W];
+        for (int x=0, gx0=0, sub=0; x<W; ++x, sub = (sub+1 == ds) ? 0 : sub+1, gx0 += (sub == 0)) {
+            const double zd = drow[x];
+            if (zd >= emptyDepth) { out[x] = 1.0f; continue; }
+            const int gx1 = std::min(gx0 + 1, w-1);
+            const float tx = sub * invDs;
+            const float z = (float)zd;
+            const float zq[4] = { z0[gx0].z, z0[gx1].z, z1[gx0].z, z1[gx1].z };
+            const float aq[4] = { a0[gx0], a0[gx1], a1[gx0], a1[gx1] };
+            const float bw[4] = { (1-tx)*(1-ty), tx*(1-ty), (1-tx)*ty, tx*ty };
+            const float tol = sigma * z;
+            float lo = std::min(std::min(zq[0], zq[1]), std::min(zq[2], zq[3]));
+            float hi = std::max(std::max(zq[0], zq[1]), std::max(zq[2], zq[3]));
+            if (z >= lo - tol && z <= hi + tol && hi - lo <= 4.0f*tol) {
+                out[x] = bw[0]*aq[0] + bw[1]*aq[1] + bw[2]*aq[2] + bw[3]*aq[3];
+                continue;
+            }
+            const float inv = 1.0f / std::max(1e-9f, tol);
+            float acc = 0.0f, wsum = 0.0f, bestT = 1e30f, nearest = 1.0f;
+            for (int k=0;k<4;++k) {
+                float t = (zq[k] - z) * inv;
+                float wt = (bw[k] + 1e-3f) / (1.0f + t*t*t*t);
+                acc += wt * aq[k];
+                wsum += wt;
+                if (std::abs(t) < bestT) { bestT = std::abs(t); nearest = aq[k]; }
+            }
+            out[x] = wsum > 1e-4f ? acc / wsum : nearest;
+        }
+    }
+
+};
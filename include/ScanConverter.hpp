@@ -0,0 +1,150 @@
+#pragma once
+#include "Point2D.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+enum class FillRule {
+    EvenOdd,    // inside where a ray crosses an odd number of edges
+    NonZero     // inside where the signed crossing count is non-zero
+};
+
+// Edge-table / active-edge-list polygon scan converter.
+//
+// Edges are sorted once by their first scanline; each row then only adds
+// the edges that start there, drops the ones that ended, evaluates x and
+// the K interpolated attributes at the row from the edge's upper end
+// point and re-sorts the (nearly sorted) active list by insertion. Cost is
+// linear in rows + edges + spans, and every vector is reused between calls.
+// Crossings are evaluated rather than stepped, so no error accumulates
+// down long edges and every row matches a from-scratch scan bit for bit.
+//
+// Row rule (unchanged from Drawing2D's original filler): an edge from
+// ya to yb crosses integer row y when ya < y <= yb, at
+// x = xa + (y - ya) * dx, truncated to int (floored with floorX).
+template<int K>
+class ScanConverter {
+public:
+    // attr(i, out) writes K attributes of vertex i.
+    // span(y, xl, xr, attrL, attrR) receives each interior span; attrL/attrR
+    // are the attributes at the two crossings. Rows outside [rowBegin,rowEnd)
+    // are skipped.
+    template<typename AttrFn, typename SpanFn>
+    void fill(const std::vector<Point2D>& pts, AttrFn&& attr, FillRule rule,
+              int rowBegin, int rowEnd, SpanFn&& span, bool floorX = false) {
+        build_edges(pts, attr);
+        if (edges.empty()) return;
+
+        int yFirst = std::max(rowBegin, edges.front().yStart);
+        int yLast  = edges.front().yEnd;
+        for (const Edge& e : edges) yLast = std::max(yLast, e.yEnd);
+        yLast = std::min(yLast, rowEnd - 1);
+
+        active.clear();
+        size_t next = 0;
+        for (int y = yFirst; y <= yLast; ++y) {
+            // Retire finished edges, then admit the ones starting here
+            size_t keep = 0;
+            for (size_t i=0; i<active.size(); ++i)
+                if (edges[active[i]].yEnd >= y) active[keep++] = active[i];
+            active.resize(keep);
+            for (; next < edges.size() && edges[next].yStart <= y; ++next) {
+                if (edges[next].yEnd < y) continue;
+                active.push_back((int)next);
+            }
+            if (active.empty()) {
+                if (next == edges.size()) break;
+                continue;
+            }
+            for (int idx : active) at_row(edges[idx], y);
+
+            // Insertion sort: the order barely changes between rows
+            for (size_t i=1; i<active.size(); ++i) {
+                int v = active[i];
+                double x = edges[v].x;
+                size_t j = i;
+                while (j > 0 && edges[active[j-1]].x > x) { active[j] = active[j-1]; --j; }
+                active[j] = v;
+            }
+
+            if (floorX) emit_spans(y, rule, span, [](double x) { return (int)std::floor(x); });
+            else        emit_spans(y, rule, span, [](double x) { return (int)x; });
+        }
+    }
+
+private:
+    struct Edge {
+        int    yStart, yEnd;         // first/last row crossed
+        double xa, ya, dx;           // upper end point, dx per row
+        double x;                    // x at the current row
+        int    wind;                 // +1 downwards, -1 upwards
+        std::array<double,K> aa, da, a;
+    };
+
+    std::vector<Edge> edges;
+    std::vector<int>  active;        // indices into edges, sorted by x
+
+    template<typename AttrFn>
+    void build_edges(const std::vector<Point2D>& pts, AttrFn& attr) {
+        edges.clear();
+        const size_t n = pts.size();
+        if (n < 3) return;
+        std::array<double,K> ai{}, aj{};
+        for (size_t i=0, j=n-1; i<n; j=i++) {
+            const Point2D& pi = pts[i];
+            const Point2D& pj = pts[j];
+            if (pi.y == pj.y) continue;             // horizontal: never crossed
+            bool down = pi.y > pj.y;                // j -> i runs towards +y
+            const Point2D& top = down ? pj : pi;
+            const Point2D& bot = down ? pi : pj;
+            Edge e;
+            e.yStart = (int)std::floor(top.y) + 1;
+            e.yEnd   = (int)std::floor(bot.y);
+            if (e.yStart > e.yEnd) continue;
+            e.xa = top.x; e.ya = top.y;
+            double inv = 1.0 / (bot.y - top.y);
+            e.dx = (bot.x - top.x) * inv;
+            e.wind = down ? 1 : -1;
+            if (K > 0) {
+                attr((int)i, ai.data());
+                attr((int)j, aj.data());
+                const auto& at = down ? aj : ai;
+                const auto& ab = down ? ai : aj;
+                for (int k=0; k<K; ++k) { e.aa[k] = at[k]; e.da[k] = (ab[k] - at[k]) * inv; }
+            }
+            edges.push_back(e);
+        }
+        std::sort(edges.begin(), edges.end(),
+                  [](const Edge& a, const Edge& b) { return a.yStart < b.yStart; });
+    }
+
+    // x and attributes where the edge crosses row y
+    static void at_row(Edge& e, int y) {
+        double t = y - e.ya;
+        e.x = e.xa + t * e.dx;
+        for (int k=0; k<K; ++k) e.a[k] = e.aa[k] + t * e.da[k];
+    }
+
+    template<typename SpanFn, typename RoundFn>
+    void emit_spans(int y, FillRule rule, SpanFn& span, RoundFn toInt) {
+        if (rule == FillRule::EvenOdd) {
+            for (size_t k=0; k+1<active.size(); k+=2) {
+                const Edge& l = edges[active[k]];
+                const Edge& r = edges[active[k+1]];
+                span(y, toInt(l.x), toInt(r.x), l.a.data(), r.a.data());
+            }
+            return;
+        }
+        int winding = 0;
+        const Edge* left = nullptr;
+        for (int idx : active) {
+            const Edge& e = edges[idx];
+            int before = winding;
+            winding += e.wind;
+            if (before == 0 && winding != 0) left = &e;
+            else if (before != 0 && winding == 0)
+                span(y, toInt(left->x), toInt(e.x), left->a.data(), e.a.data());
+        }
+    }
+};
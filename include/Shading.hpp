@@ -2,6 +2,7 @@
 #include "Point3D.hpp"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <vector>
 
 // Clamp helpers
@@ -80,3 +81,146 @@ inline std::vector<double> gouraud01(const std::vector<Point3D>& verts,
     }
     return I;
 }
+
+// ---------------- Multi-light (directional / point / spot, RGB) ----------------
+
+enum class LightType : uint8_t {
+    Directional,   // infinitely far, no falloff
+    Point,         // omni light with finite range
+    Spot           // point light restricted to a cone
+};
+
+// All vectors are VIEW space, like the meshes handed to MeshRenderer2D.
+// `direction` follows the lightDir convention used above: for a directional
+// light it points from the surface TOWARDS the light. For a spot it is the
+// axis the cone points along (from the light into the scene).
+struct Light {
+    LightType type = LightType::Directional;
+    Point3D position  {0,0,0};
+    Point3D direction {0,0,-1};
+    Point3D color     {1,1,1};   // RGB intensity, may exceed 1
+    double  range     = 10.0;    // point/spot: contribution is exactly 0 beyond this
+    double  innerCone = 0.3;     // spot: full intensity inside (radians, half-angle)
+    double  outerCone = 0.5;     // spot: zero outside (radians, half-angle)
+
+    static Light directional(const Point3D& dir, const Point3D& col = Point3D(1,1,1)) {
+        Light L; L.type = LightType::Directional; L.direction = dir; L.color = col;
+        return L;
+    }
+    static Light point(const Point3D& pos, const Point3D& col, double range) {
+        Light L; L.type = LightType::Point; L.position = pos; L.color = col; L.range = range;
+        return L;
+    }
+    static Light spot(const Point3D& pos, const Point3D& dir, const Point3D& col,
+                      double range, double inner, double outer) {
+        Light L; L.type = LightType::Spot; L.position = pos; L.direction = dir;
+        L.color = col; L.range = range; L.innerCone = inner; L.outerCone = outer;
+        return L;
+    }
+};
+
+// Light parameters packed structure-of-arrays so the per-pixel loop walks
+// a handful of contiguous double streams instead of chasing Light structs.
+// Directions are pre-normalized and cone cosines precomputed once per frame.
+struct LightSoA {
+    std::vector<LightType> type;
+    std::vector<double> px, py, pz;     // position
+    std::vector<double> dx, dy, dz;     // normalized direction
+    std::vector<double> r, g, b;        // color
+    std::vector<double> range;
+    std::vector<double> invRange2;      // 1/range^2
+    std::vector<double> cosOuter;       // spot: cos(outer)
+    std::vector<double> invConeDelta;   // spot: 1/(cos(inner)-cos(outer))
+
+    size_t size() const { return type.size(); }
+
+    void build(const std::vector<Light>& lights) {
+        size_t n = lights.size();
+        type.resize(n);
+        px.resize(n); py.resize(n); pz.resize(n);
+        dx.resize(n); dy.resize(n); dz.resize(n);
+        r.resize(n);  g.resize(n);  b.resize(n);
+        range.resize(n); invRange2.resize(n);
+        cosOuter.resize(n); invConeDelta.resize(n);
+        for (size_t i=0;i<n;++i) {
+            const Light& L = lights[i];
+            Point3D d = L.direction.normalized();
+            type[i] = L.type;
+            px[i] = L.position.x; py[i] = L.position.y; pz[i] = L.position.z;
+            dx[i] = d.x; dy[i] = d.y; dz[i] = d.z;
+            r[i] = L.color.x; g[i] = L.color.y; b[i] = L.color.z;
+            range[i] = std::max(1e-6, L.range);
+            invRange2[i] = 1.0 / (range[i]*range[i]);
+            double ci = std::cos(L.innerCone), co = std::cos(L.outerCone);
+            cosOuter[i] = co;
+            invConeDelta[i] = 1.0 / std::max(1e-6, ci - co);
+        }
+    }
+};
+
+// Collect the lights whose range reaches a view-space bounding sphere.
+// Directional lights always pass. `out` is cleared and reused (no allocation
+// once it has grown to the scene's light count).
+inline void cull_lights_sphere(const LightSoA& L, const Point3D& center, double radius,
+                               std::vector<int>& out) {
+    out.clear();
+    for (size_t i=0;i<L.size();++i) {
+        if (L.type[i] == LightType::Directional) { out.push_back((int)i); continue; }
+        double ex = L.px[i]-center.x, ey = L.py[i]-center.y, ez = L.pz[i]-center.z;
+        double reach = L.range[i] + radius;
+        if (ex*ex + ey*ey + ez*ez < reach*reach) out.push_back((int)i);
+    }
+}
+
+// Sum of kd*diffuse + ks*specular over the listed lights, per RGB channel.
+// N and V need not be normalized; P is the view-space surface position.
+// Point/spot falloff is a windowed inverse square that reaches 0 at `range`,
+// which is what makes range culling exact. Light `shadowed` (if >= 0) is
+// scaled by `shadowVis`, the shadow-map visibility at P.
+inline Point3D shade_lights(const LightSoA& L, const int* idx, size_t count,
+                            const Point3D& Nin, const Point3D& P, const Point3D& Vin,
+                            double kd, double ks, double shininess,
+                            int shadowed = -1, double shadowVis = 1.0) {
+    Point3D n = Nin.normalized();
+    Point3D v = Vin.normalized();
+    double R=0, G=0, B=0;
+    for (size_t k=0;k<count;++k) {
+        int i = idx[k];
+        double lx, ly, lz, atten;
+        if (L.type[i] == LightType::Directional) {
+            lx = L.dx[i]; ly = L.dy[i]; lz = L.dz[i];
+            atten = 1.0;
+        } else {
+            lx = L.px[i]-P.x; ly = L.py[i]-P.y; lz = L.pz[i]-P.z;
+            double d2 = lx*lx + ly*ly + lz*lz;
+            double f = d2 * L.invRange2[i];
+            if (f >= 1.0) continue;
+            double inv = 1.0 / std::sqrt(std::max(d2, 1e-12));
+            lx *= inv; ly *= inv; lz *= inv;
+            double win = 1.0 - f*f;
+            atten = (win*win) / (1.0 + d2);
+            if (L.type[i] == LightType::Spot) {
+                // cone axis points away from the light; compare with -l
+                double cd = -(lx*L.dx[i] + ly*L.dy[i] + lz*L.dz[i]);
+                double s = clamp01((cd - L.cosOuter[i]) * L.invConeDelta[i]);
+                if (s <= 0.0) continue;
+                atten *= s*s;
+            }
+        }
+        if (i == shadowed) {
+            if (shadowVis <= 0.0) continue;
+            atten *= shadowVis;
+        }
+        double nDotL = n.x*lx + n.y*ly + n.z*lz;
+        if (nDotL <= 0.0) continue;
+        double I = kd * nDotL;
+        if (ks > 0.0) {
+            double rx = 2.0*nDotL*n.x - lx, ry = 2.0*nDotL*n.y - ly, rz = 2.0*nDotL*n.z - lz;
+            double rv = rx*v.x + ry*v.y + rz*v.z;
+            if (rv > 0.0) I += ks * std::pow(rv, shininess);
+        }
+        I *= atten;
+        R += I * L.r[i]; G += I * L.g[i]; B += I * L.b[i];
+    }
+    return Point3D(R, G, B);
+}
@@ -0,0 +1,174 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#include "Mesh3D.hpp"
+#include "RasterBuffer.hpp"
+#include "View3D.hpp"
+#include "View3DParameters.hpp"
+#include "DepthRaster.hpp"
+
+// One orthographic depth map rendered from the light's View3D.
+// Depth is light-space z (distance along the light's forward axis) stored
+// in a 1-channel float RasterBuffer; smaller = nearer the light.
+struct ShadowCascade {
+    View3D              lightView;
+    Transformation3D    worldToLight;          // lightView.view_matrix()
+    Transformation3D    viewToLight;           // camera view space -> light space (set_camera)
+    double              halfExtent = 1.0;      // ortho half-width in light space
+    double              splitFar   = 1e300;    // covers camera view depth up to here
+    RasterBuffer<float> depth;
+
+    explicit ShadowCascade(int res) : depth(res, res, 1, FLT_MAX) {}
+};
+
+// Directional-light shadow map, optionally split into cascades along the
+// camera's view depth so large terrains keep texel density near the eye.
+//
+//   ShadowMap sm(1024);
+//   sm.setup_cascades(params, sunDirWorld, 3);   // or setup_directional()
+//   sm.render(worldMesh);                        // depth-only pass(es)
+//   sm.set_camera(cam);
+//   renderer.shadowMap = &sm;                    // sampled in all modes
+class ShadowMap {
+public:
+    int    resolution;
+    int    lightIndex   = 0;     // which MeshRenderer2D::lights entry is shadowed
+    double bias         = 0.01;  // constant depth bias (light-space units)
+    double normalOffset = 1.5;   // push lookups along N by this many texels
+    int    pcfRadius    = 1;     // (2r+1)^2 taps
+
+    std::vector<ShadowCascade> cascades;
+
+    explicit ShadowMap(int resolution = 1024) : resolution(resolution) {}
+
+    // Single map covering a world-space bounding sphere.
+    // lightDirWorld points from the scene TOWARDS the light (lightDir convention).
+    void setup_directional(const Point3D& lightDirWorld, const Point3D& center, double radius) {
+        cascades.assign(1, ShadowCascade(resolution));
+        place(cascades[0], lightDirWorld, center, radius);
+    }
+
+    // `count` cascades over [nearZ, maxDistance] of the camera frustum, split
+    // with the practical scheme (lambda blends logarithmic and uniform).
+    void setup_cascades(const View3DParameters& cam, const Point3D& lightDirWorld,
+                        int count, double maxDistance = 0.0, double lambda = 0.7) {
+        count = std::max(1, count);
+        double n = cam.nearZ;
+        double f = (maxDistance > 0.0) ? std::min(maxDistance, cam.farZ) : cam.farZ;
+
+        Point3D fwd   = (cam.target - cam.eye).normalized();
+        Point3D right = fwd.cross(cam.up).normalized();
+        Point3D up    = right.cross(fwd);
+        double tanH   = std::tan(cam.fov * 0.5);
+
+        cascades.assign(count, ShadowCascade(resolution));
+        double prev = n;
+        for (int i=0; i<count; ++i) {
+            double s = (double)(i+1) / count;
+            double dLog = n * std::pow(f / n, s);
+            double dLin = n + (f - n) * s;
+            double d = lambda * dLog + (1.0 - lambda) * dLin;
+
+            // Bounding sphere of the frustum slice [prev, d]
+            std::array<Point3D,8> corners;
+            int k = 0;
+            for (double dist : { prev, d }) {
+                double hy = dist * tanH, hx = hy * cam.aspect;
+                for (int sy=-1; sy<=1; sy+=2)
+                    for (int sx=-1; sx<=1; sx+=2)
+                        corners[k++] = cam.eye + fwd*dist + right*(sx*hx) + up*(sy*hy);
+            }
+            Point3D c(0,0,0);
+            for (const auto& p : corners) c = c + p;
+            c = c / 8.0;
+            double r = 0.0;
+            for (const auto& p : corners) r = std::max(r, c.distance_to(p));
+
+            place(cascades[i], lightDirWorld, c, r);
+            cascades[i].splitFar = d;
+            prev = d;
+        }
+        cascades.back().splitFar = 1e300;
+    }
+
+    // Bind the camera whose view space MeshRenderer2D shades in
+    void set_camera(const View3D& cam) {
+        Transformation3D camInv = cam.view_matrix().inverse();
+        for (auto& c : cascades) c.viewToLight = c.worldToLight * camInv;
+    }
+
+    // Depth-only pass of a WORLD-space mesh into every cascade, over the
+    // same cached triangulation MeshRenderer2D draws, so concave faces
+    // cover the same area in both. Both windings are drawn so open or
+    // inconsistently wound meshes still cast.
+    void render(const Mesh3D& worldMesh) {
+        const Triangulation& T = worldMesh.triangulation();
+        for (auto& c : cascades) {
+            std::fill(c.depth.data.begin(), c.depth.data.end(), FLT_MAX);
+
+            const double s = 0.5 * resolution / c.halfExtent;
+            const double half = 0.5 * resolution;
+            lightScreen.resize(worldMesh.vertices.size());
+            lightZ.resize(worldMesh.vertices.size());
+            for (size_t i=0; i<worldMesh.vertices.size(); ++i) {
+                Point3D lp = c.worldToLight.apply(worldMesh.vertices[i]);
+                lightScreen[i] = Point2D(half + lp.x * s, half - lp.y * s);
+                lightZ[i] = lp.z;
+            }
+
+            for (const auto& t : T.tris) {
+                std::array<Point2D,3> S = { lightScreen[t[0]], lightScreen[t[1]], lightScreen[t[2]] };
+                std::array<double,3>  z = { lightZ[t[0]], lightZ[t[1]], lightZ[t[2]] };
+                DepthRaster::triangle_linear(c.depth.data.data(), resolution, resolution, S, z);
+            }
+        }
+    }
+
+    // Fraction of PCF taps that see the light, 1 = fully lit.
+    // P and N are camera VIEW space; N need not be normalized.
+    double visibility(const Point3D& viewPos, const Point3D& viewNormal) const {
+        if (cascades.empty()) return 1.0;
+        size_t ci = 0;
+        while (ci + 1 < cascades.size() && viewPos.z > cascades[ci].splitFar) ++ci;
+        const ShadowCascade& c = cascades[ci];
+
+        double texel = 2.0 * c.halfExtent / resolution;
+        Point3D lp = c.viewToLight.apply(viewPos + viewNormal.normalized() * (normalOffset * texel));
+
+        const double s = 0.5 * resolution / c.halfExtent;
+        int tx = (int)std::floor(0.5 * resolution + lp.x * s);
+        int ty = (int)std::floor(0.5 * resolution - lp.y * s);
+        double zRef = lp.z - bias;
+
+        int lit = 0, taps = 0;
+        for (int dy=-pcfRadius; dy<=pcfRadius; ++dy) {
+            int y = ty + dy;
+            for (int dx=-pcfRadius; dx<=pcfRadius; ++dx) {
+                int x = tx + dx;
+                ++taps;
+                if (x < 0 || y < 0 || x >= resolution || y >= resolution) { ++lit; continue; }
+                if (zRef <= c.depth.data[(size_t)y*resolution + x]) ++lit;
+            }
+        }
+        return (double)lit / taps;
+    }
+
+private:
+    std::vector<Point2D> lightScreen;  // per-vertex scratch, reused across renders
+    std::vector<double>  lightZ;
+
+    static void place(ShadowCascade& c, const Point3D& lightDirWorld,
+                      const Point3D& center, double radius) {
+        Point3D L = lightDirWorld.normalized();
+        Point3D up = (std::abs(L.y) > 0.99) ? Point3D(0,0,1) : Point3D(0,1,0);
+        // Eye sits on the sphere toward the light; ortho has no near clip,
+        // so casters beyond the eye still land in the map
+        c.lightView    = View3D(center + L * radius, center, up);
+        c.worldToLight = c.lightView.view_matrix();
+        c.halfExtent   = std::max(1e-9, radius);
+    }
+};
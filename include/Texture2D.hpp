@@ -4,6 +4,9 @@
 #include <fstream>
 #include <stdexcept>
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
 
 class Texture2D {
 public:
@@ -0,0 +1,193 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "RasterBuffer.hpp"
+#include "Projection3D.hpp"
+#include "Shading.hpp"       // LightSoA
+
+// Forward+ light binning.
+//
+// After a depth-only prepass the Z-buffer tells us, per screen tile, the
+// range of view-space depths that will actually be shaded. Each point/spot
+// light is projected to a conservative screen rectangle of tiles; within it
+// the light's sphere is tested against each tile's view-space box (the
+// tile's frustum slice between its min and max depth) and, if it reaches
+// the box, appended to the tile's index list. The Phong inner loop then
+// walks only its tile's list.
+//
+// Lists are stored CSR-style (offsets + one flat index array) and all
+// vectors are reused between frames, so rebuilding is allocation-free once
+// the grid has warmed up.
+class TileLightGrid {
+public:
+    int tileSize = 16;
+    int tilesX = 0, tilesY = 0;
+
+    std::vector<double> tileMinZ, tileMaxZ;  // depth bounds per tile
+    std::vector<int>    offsets;             // tilesX*tilesY+1 entries
+    std::vector<int>    indices;             // light indices, grouped by tile
+
+    explicit TileLightGrid(int tileSize = 16) : tileSize(tileSize) {}
+
+    template<typename PixelT>
+    void build(const RasterBuffer<PixelT>& rb, const LightSoA& lights,
+               const Projection3D& proj, double emptyDepth = 1e9) {
+        tilesX = (rb.width  + tileSize - 1) / tileSize;
+        tilesY = (rb.height + tileSize - 1) / tileSize;
+        const size_t nTiles = (size_t)tilesX * tilesY;
+
+        compute_depth_bounds(rb, emptyDepth);
+        compute_tile_rays(proj, rb.width, rb.height);
+
+        // Screen rectangle (in tiles) per light, computed once
+        rects.resize(lights.size());
+        for (size_t i=0;i<lights.size();++i) rects[i] = light_tile_rect(lights, i, proj);
+
+        // Pass 1: count, pass 2: fill
+        counts.assign(nTiles, 0);
+        for_each_pair(lights, [&](size_t tile, int) { ++counts[tile]; });
+
+        offsets.resize(nTiles + 1);
+        offsets[0] = 0;
+        for (size_t t=0;t<nTiles;++t) offsets[t+1] = offsets[t] + counts[t];
+        indices.resize(offsets[nTiles]);
+
+        std::copy(offsets.begin(), offsets.end()-1, counts.begin()); // reuse as cursors
+        for_each_pair(lights, [&](size_t tile, int li) { indices[counts[tile]++] = li; });
+    }
+
+    inline int tile_index(int x, int y) const {
+        return (y / tileSize) * tilesX + (x / tileSize);
+    }
+
+    inline const int* tile_lights(int tile, size_t& count) const {
+        count = (size_t)(offsets[tile+1] - offsets[tile]);
+        return indices.data() + offsets[tile];
+    }
+
+    // Average list length over tiles, handy for benchmarks
+    double mean_lights_per_tile() const {
+        size_t n = (size_t)tilesX * tilesY;
+        return n ? (double)indices.size() / n : 0.0;
+    }
+
+private:
+    struct TileRect { int x0, y0, x1, y1; double zMin, zMax; bool everywhere; };
+    std::vector<TileRect> rects;
+    std::vector<int>      counts;
+
+    // Tile borders in view space: x = rayX[tx]*z for perspective (rayX[tx]
+    // for orthographic), tilesX+1 entries; likewise rayY, top to bottom
+    std::vector<double> rayX, rayY;
+    bool   perspective = true;
+    int    screenW = 0, screenH = 0;
+    double pxPerRayX = 0, pxPerRayY = 0;   // screen pixels per unit of x/z, y/z
+
+    void compute_tile_rays(const Projection3D& proj, int W, int H) {
+        perspective = proj.type == ProjectionType::PERSPECTIVE;
+        screenW = W; screenH = H;
+        const double f = perspective ? 1.0 / std::tan(proj.fov / 2.0) : 1.0;   // Projection3D::project
+        pxPerRayX = 0.5 * W * f;
+        pxPerRayY = 0.5 * H * f;
+        rayX.resize(tilesX + 1);
+        rayY.resize(tilesY + 1);
+        for (int t=0; t<=tilesX; ++t) rayX[t] = (std::min(W, t*tileSize) - 0.5*W) / pxPerRayX;
+        for (int t=0; t<=tilesY; ++t) rayY[t] = (0.5*H - std::min(H, t*tileSize)) / pxPerRayY;
+    }
+
+    template<typename PixelT>
+    void compute_depth_bounds(const RasterBuffer<PixelT>& rb, double emptyDepth) {
+        const size_t nTiles = (size_t)tilesX * tilesY;
+        tileMinZ.assign(nTiles,  1e300);
+        tileMaxZ.assign(nTiles, -1e300);
+        if (!rb.has_depth()) return;
+
+        for (int y=0;y<rb.height;++y) {
+            const double* row = rb.depth.data() + (size_t)y*rb.width;
+            int ty = y / tileSize;
+            for (int tx=0; tx<tilesX; ++tx) {
+                int x0 = tx*tileSize, x1 = std::min(rb.width, x0+tileSize);
+                const size_t t = (size_t)ty*tilesX + tx;
+                double lo = tileMinZ[t], hi = tileMaxZ[t];
+                for (int x=x0;x<x1;++x) {
+                    double z = row[x];
+                    if (z >= emptyDepth) continue;
+                    lo = std::min(lo, z);
+                    hi = std::max(hi, z);
+                }
+                tileMinZ[t] = lo;
+                tileMaxZ[t] = hi;
+            }
+        }
+    }
+
+    // Conservative tile rectangle of a light's influence sphere: the screen
+    // bounds of its bounding box, whose x/z and y/z extremes lie on the
+    // near or far face (x/z is monotonic in z for fixed x)
+    TileRect light_tile_rect(const LightSoA& L, size_t i, const Projection3D& proj) const {
+        TileRect r { 0, 0, tilesX-1, tilesY-1, -1e300, 1e300, true };
+        if (L.type[i] == LightType::Directional) return r;
+
+        double cx=L.px[i], cy=L.py[i], cz=L.pz[i], rad=L.range[i];
+        r.zMin = cz - rad; r.zMax = cz + rad;
+        r.everywhere = false;
+        if (perspective && r.zMin <= proj.nearZ) return r; // straddles the eye
+
+        double x0 = cx - rad, x1 = cx + rad, y0 = cy - rad, y1 = cy + rad;
+        if (perspective) {
+            const double iN = 1.0 / r.zMin, iF = 1.0 / r.zMax;
+            x0 = std::min(x0*iN, x0*iF); x1 = std::max(x1*iN, x1*iF);
+            y0 = std::min(y0*iN, y0*iF); y1 = std::max(y1*iN, y1*iF);
+        }
+        // ray -> screen pixels; y flips
+        const double W = screenW, H = screenH;
+        double minX = 0.5*W + x0*pxPerRayX, maxX = 0.5*W + x1*pxPerRayX;
+        double minY = 0.5*H - y1*pxPerRayY, maxY = 0.5*H - y0*pxPerRayY;
+        if (maxX < 0 || maxY < 0 || minX >= W || minY >= H) {  // fully off-screen
+            r.x0 = r.y0 = 0; r.x1 = r.y1 = -1;
+            return r;
+        }
+        r.x0 = std::max(0, (int)minX / tileSize);
+        r.y0 = std::max(0, (int)minY / tileSize);
+        r.x1 = std::min(tilesX-1, (int)maxX / tileSize);
+        r.y1 = std::min(tilesY-1, (int)maxY / tileSize);
+        return r;
+    }
+
+    // Does light i's sphere reach tile t's view-space box between depths
+    // zLo and zHi?
+    bool sphere_reaches_tile(const LightSoA& L, size_t i, int tx, int ty, double zLo, double zHi) const {
+        const double cx=L.px[i], cy=L.py[i], cz=L.pz[i], rad=L.range[i];
+        double bx0 = rayX[tx], bx1 = rayX[tx+1], by0 = rayY[ty+1], by1 = rayY[ty];
+        if (perspective) {
+            bx0 = std::min(bx0*zLo, bx0*zHi); bx1 = std::max(bx1*zLo, bx1*zHi);
+            by0 = std::min(by0*zLo, by0*zHi); by1 = std::max(by1*zLo, by1*zHi);
+        }
+        const double dx = std::max({ bx0 - cx, 0.0, cx - bx1 });
+        const double dy = std::max({ by0 - cy, 0.0, cy - by1 });
+        const double dz = std::max({ zLo - cz, 0.0, cz - zHi });
+        return dx*dx + dy*dy + dz*dz < rad*rad;
+    }
+
+    // Visit every (tile, light) pair that survives the rectangle, depth and
+    // sphere-box tests. Tiles without any depth sample keep the rectangle
+    // test only, so a mesh drawn without a prepass still sees its lights.
+    template<typename Fn>
+    void for_each_pair(const LightSoA& L, Fn&& fn) const {
+        for (size_t i=0;i<L.size();++i) {
+            const TileRect& r = rects[i];
+            for (int ty=r.y0; ty<=r.y1; ++ty) {
+                for (int tx=r.x0; tx<=r.x1; ++tx) {
+                    size_t t = (size_t)ty*tilesX + tx;
+                    bool empty = tileMinZ[t] > tileMaxZ[t];
+                    if (!r.everywhere && !empty &&
+                        (r.zMax < tileMinZ[t] || r.zMin > tileMaxZ[t] ||
+                         !sphere_reaches_tile(L, i, tx, ty, tileMinZ[t], tileMaxZ[t]))) continue;
+                    fn(t, (int)i);
+                }
+            }
+        }
+    }
+};
@@ -24,6 +24,9 @@ public:
     // Composition
     Transformation3D operator*(const Transformation3D& other) const;
 
+    // General 4x4 inverse (Gauss-Jordan); identity if singular
+    Transformation3D inverse() const;
+
     // Output
     friend std::ostream& operator<<(std::ostream& os, const Transformation3D& t);
 };
@@ -0,0 +1,132 @@
+#pragma once
+#include "Mesh3D.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Dense nx*ny*nz block of voxels: 0 is empty, anything else a material id.
+// Cells outside the block read as empty.
+struct VoxelGrid {
+    int nx = 0, ny = 0, nz = 0;
+    std::vector<uint8_t> cells;     // x fastest, then z, then y
+
+    VoxelGrid() = default;
+    VoxelGrid(int x, int y, int z)
+        : nx(x), ny(y), nz(z), cells((size_t)x * y * z, 0) {}
+
+    size_t index(int x, int y, int z) const { return ((size_t)y * nz + z) * nx + x; }
+    bool inside(int x, int y, int z) const {
+        return x >= 0 && y >= 0 && z >= 0 && x < nx && y < ny && z < nz;
+    }
+    uint8_t get(int x, int y, int z) const { return inside(x,y,z) ? cells[index(x,y,z)] : 0; }
+    void set(int x, int y, int z, uint8_t m) { if (inside(x,y,z)) cells[index(x,y,z)] = m; }
+};
+
+// Greedy meshing of an n[0] x n[1] x n[2] voxel block into `mesh`.
+//
+// get(x,y,z) gives the material of a cell (0 = empty) and is also asked
+// about the one-cell border around the block, so a caller can hide faces
+// against neighbouring data (faces of those border cells are left to the
+// neighbour). Only faces between a solid and an empty cell are kept; on
+// each slice plane, runs of equal faces are grown into the
+// largest rectangles first along u then along v, and each rectangle becomes
+// two triangles. Vertices are shared between rectangles of the same plane,
+// facing and material, so compute_vertex_normals stays flat per side.
+// Cell (x,y,z) spans origin + [x,x+1]*cell.x etc.; with a non-empty
+// palette each vertex gets palette[material] as its color. Winding matches
+// make_cube.
+template<typename Get>
+void greedy_mesh_into(Mesh3D& mesh, const int n[3], Get&& get,
+                      const Point3D& cell, const Point3D& origin,
+                      const std::vector<Point3D>& palette = {}) {
+    const double size[3] = { cell.x, cell.y, cell.z };
+    const double org[3]  = { origin.x, origin.y, origin.z };
+    std::vector<uint8_t> mask;      // material of each exposed face on a slice
+    std::vector<int>     corner;    // vertex at each slice lattice point
+    std::vector<uint8_t> cornerMat;
+
+    for (int d=0; d<3; ++d) {
+        const int u = (d + 1) % 3, v = (d + 2) % 3;     // e_u x e_v = e_d
+        const int nu = n[u], nv = n[v];
+        mask.assign((size_t)nu * nv, 0);
+        corner.assign((size_t)(nu + 1) * (nv + 1), -1);
+        cornerMat.assign(corner.size(), 0);
+
+        for (int s=0; s<=n[d]; ++s) {
+            // Slice between layer s-1 and s; side 0 faces +d, side 1 faces -d
+            for (int side=0; side<2; ++side) {
+                if ((side == 0 && s == 0) || (side == 1 && s == n[d])) continue;   // faces of outside cells
+                bool any = false;
+                int c[3];
+                c[d] = s;
+                for (int j=0; j<nv; ++j) {
+                    c[v] = j;
+                    for (int i=0; i<nu; ++i) {
+                        c[u] = i;
+                        int below[3] = { c[0], c[1], c[2] };
+                        below[d] = s - 1;
+                        uint8_t a = get(below[0], below[1], below[2]);
+                        uint8_t b = get(c[0], c[1], c[2]);
+                        uint8_t m = side == 0 ? (a && !b ? a : 0) : (b && !a ? b : 0);
+                        mask[(size_t)j * nu + i] = m;
+                        any |= m != 0;
+                    }
+                }
+                if (!any) continue;
+
+                const int first = (int)mesh.vertices.size();   // older corners are stale
+                auto vertex = [&](int i, int j, uint8_t m) {
+                    size_t k = (size_t)j * (nu + 1) + i;
+                    if (corner[k] >= first && cornerMat[k] == m) return corner[k];
+                    double p[3];
+                    p[d] = org[d] + s * size[d];
+                    p[u] = org[u] + i * size[u];
+                    p[v] = org[v] + j * size[v];
+                    corner[k] = (int)mesh.vertices.size();
+                    cornerMat[k] = m;
+                    mesh.vertices.push_back(Point3D(p[0], p[1], p[2]));
+                    if (!palette.empty()) mesh.colors.push_back(palette[m]);
+                    return corner[k];
+                };
+
+                for (int j=0; j<nv; ++j) {
+                    for (int i=0; i<nu; ) {
+                        uint8_t m = mask[(size_t)j * nu + i];
+                        if (!m) { ++i; continue; }
+                        int w = 1;
+                        while (i + w < nu && mask[(size_t)j * nu + i + w] == m) ++w;
+                        int h = 1;
+                        for (; j + h < nv; ++h) {
+                            const uint8_t* row = &mask[(size_t)(j + h) * nu + i];
+                            if (std::any_of(row, row + w, [m](uint8_t x) { return x != m; })) break;
+                        }
+                        for (int k=0; k<h; ++k)
+                            std::fill_n(&mask[(size_t)(j + k) * nu + i], w, (uint8_t)0);
+
+                        int p00 = vertex(i, j, m),     p10 = vertex(i + w, j, m);
+                        int p11 = vertex(i + w, j + h, m), p01 = vertex(i, j + h, m);
+                        if (side == 0) {
+                            mesh.add_face({p00, p11, p10});
+                            mesh.add_face({p00, p01, p11});
+                        } else {
+                            mesh.add_face({p00, p10, p11});
+                            mesh.add_face({p00, p11, p01});
+                        }
+                        i += w;
+                    }
+                }
+            }
+        }
+    }
+}
+
+inline Mesh3D greedy_mesh(const VoxelGrid& g,
+                          const Point3D& cell = Point3D(1,1,1),
+                          const Point3D& origin = Point3D(0,0,0),
+                          const std::vector<Point3D>& palette = {}) {
+    Mesh3D mesh;
+    const int n[3] = { g.nx, g.ny, g.nz };
+    greedy_mesh_into(mesh, n, [&g](int x, int y, int z) { return g.get(x,y,z); },
+                     cell, origin, palette);
+    return mesh;
+}
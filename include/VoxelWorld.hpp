@@ -0,0 +1,193 @@
+#pragma once
+#include "VoxelGrid.hpp"
+#include "MeshRenderer2D.hpp"
+#include "ParallelFor.hpp"
+#include "Projection3D.hpp"
+#include "Transformation3D.hpp"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Unbounded voxel world stored as 32^3 chunks, each with its own greedy
+// mesh (greedy_mesh_into). Edits only mark the touched chunk dirty, plus
+// the neighbour across a chunk border when the edited cell is on one;
+// remesh() rebuilds just the dirty chunks, spread over worker threads.
+// render() draws chunk by chunk and skips chunks outside the view.
+//
+//   VoxelWorld w(Point3D(1,1,1), Point3D(0,0,0), palette);
+//   w.fill_box(0,0,0, 256,8,256, 1);
+//   w.remesh();
+//   w.set(10,8,10, 2); w.remesh();     // one chunk, a few ms
+//   w.render(renderer);
+class VoxelWorld {
+public:
+    static constexpr int kChunk = 32;
+
+    struct Chunk {
+        int cx, cy, cz;                 // chunk coordinates
+        VoxelGrid cells{ kChunk, kChunk, kChunk };
+        Mesh3D mesh;                    // world space
+        Point3D lo, hi;                 // bounds of mesh
+        bool dirty = true;
+    };
+
+    // cell: size of one voxel; origin: world position of cell (0,0,0)'s
+    // lower corner; palette: vertex color per material (optional)
+    explicit VoxelWorld(const Point3D& cell = Point3D(1,1,1),
+                        const Point3D& origin = Point3D(0,0,0),
+                        std::vector<Point3D> palette = {})
+        : cell(cell), origin(origin), palette(std::move(palette)) {}
+
+    uint8_t get(int x, int y, int z) const {
+        auto it = chunks.find(key(x >> 5, y >> 5, z >> 5));     // >> 5: floor(x / 32)
+        return it == chunks.end() ? 0 : it->second->cells.cells[local(x, y, z)];
+    }
+
+    void set(int x, int y, int z, uint8_t m) {
+        const int cx = x >> 5, cy = y >> 5, cz = z >> 5;
+        Chunk* c = m ? &chunk(cx, cy, cz) : find(cx, cy, cz);
+        if (!c) return;
+        uint8_t& v = c->cells.cells[local(x, y, z)];
+        if (v == m) return;
+        v = m;
+        mark(c);
+        // A border cell also shows or hides a face of the neighbour
+        const int lx = x & (kChunk-1), ly = y & (kChunk-1), lz = z & (kChunk-1);
+        if (lx == 0) mark(find(cx-1, cy, cz));
+        if (lx == kChunk-1) mark(find(cx+1, cy, cz));
+        if (ly == 0) mark(find(cx, cy-1, cz));
+        if (ly == kChunk-1) mark(find(cx, cy+1, cz));
+        if (lz == 0) mark(find(cx, cy, cz-1));
+        if (lz == kChunk-1) mark(find(cx, cy, cz+1));
+    }
+
+    // Fill the half-open box [x0,x1) x [y0,y1) x [z0,z1)
+    void fill_box(int x0, int y0, int z0, int x1, int y1, int z1, uint8_t m) {
+        for (int y=y0; y<y1; ++y)
+            for (int z=z0; z<z1; ++z)
+                for (int x=x0; x<x1; ++x) set(x, y, z, m);
+    }
+
+    // Rebuild the mesh of every dirty chunk; threads <= 0 uses all cores.
+    // Returns the number of chunks remeshed.
+    int remesh(int threads = 0) {
+        std::vector<Chunk*> work;
+        work.swap(dirtyList);
+        parallel_for(0, (int)work.size(), [&](int b, int e) {
+            for (int i=b; i<e; ++i) build(*work[i]);
+        }, threads);
+        return (int)work.size();
+    }
+
+    size_t dirty_count() const { return dirtyList.size(); }
+    size_t chunk_count() const { return chunks.size(); }
+
+    template<typename Fn>
+    void for_each_chunk(Fn&& fn) const { for (const auto& c : chunks) fn(*c.second); }
+
+    // Chunks whose bounds may reach the view volume of `proj` after `view`
+    // (box corners against each side of the frustum; never drops a chunk
+    // that has something on screen)
+    std::vector<const Chunk*> visible(const Transformation3D& view, const Projection3D& proj) const {
+        std::vector<const Chunk*> out;
+        const double f = proj.type == ProjectionType::PERSPECTIVE ? 1.0 / std::tan(proj.fov / 2.0) : 1.0;
+        for (const auto& kv : chunks) {
+            const Chunk& c = *kv.second;
+            if (c.mesh.faces.empty()) continue;
+            unsigned all = ~0u;             // bit k: every corner is outside plane k
+            for (int k=0; k<8 && all; ++k) {
+                Point3D p = view.apply(Point3D(k & 1 ? c.hi.x : c.lo.x,
+                                               k & 2 ? c.hi.y : c.lo.y,
+                                               k & 4 ? c.hi.z : c.lo.z));
+                unsigned bits = 0;
+                if (proj.type == ProjectionType::PERSPECTIVE) {
+                    if (p.z <= proj.nearZ) bits |= 1;
+                    if (p.z >= proj.farZ)  bits |= 2;
+                    if (p.x * f >  p.z) bits |= 4;
+                    if (p.x * f < -p.z) bits |= 8;
+                    if (p.y * f >  p.z) bits |= 16;
+                    if (p.y * f < -p.z) bits |= 32;
+                } else {
+                    if (p.x >  1.0) bits |= 4;
+                    if (p.x < -1.0) bits |= 8;
+                    if (p.y >  1.0) bits |= 16;
+                    if (p.y < -1.0) bits |= 32;
+                }
+                all &= bits;
+            }
+            if (!all) out.push_back(&c);
+        }
+        return out;
+    }
+
+    // Draw the visible chunks with r's camera and projection. Returns the
+    // number of chunks drawn.
+    int render(MeshRenderer2D& r, RenderMode mode = RenderMode::Gouraud) {
+        const Transformation3D V = r.camera.view_matrix();
+        auto list = visible(V, r.projection);
+        for (const Chunk* c : list) {
+            scratch.vertices.resize(c->mesh.vertices.size());
+            for (size_t i=0; i<scratch.vertices.size(); ++i) scratch.vertices[i] = V.apply(c->mesh.vertices[i]);
+            scratch.faces  = c->mesh.faces;
+            scratch.colors = c->mesh.colors;
+            scratch.invalidate_triangulation();     // same face count, other faces
+            r.render(scratch, scratch.compute_vertex_normals(), mode);
+        }
+        return (int)list.size();
+    }
+
+private:
+    Point3D cell, origin;
+    std::vector<Point3D> palette;
+    std::unordered_map<uint64_t, std::unique_ptr<Chunk>> chunks;
+    std::vector<Chunk*> dirtyList;
+    Mesh3D scratch;                     // view-space copy for render()
+
+    static uint64_t key(int cx, int cy, int cz) {
+        return ((uint64_t)(cx & 0x1FFFFF) << 42) | ((uint64_t)(cy & 0x1FFFFF) << 21) | (uint64_t)(cz & 0x1FFFFF);
+    }
+    static size_t local(int x, int y, int z) {
+        return ((size_t)(y & (kChunk-1)) * kChunk + (z & (kChunk-1))) * kChunk + (x & (kChunk-1));
+    }
+
+    Chunk* find(int cx, int cy, int cz) const {
+        auto it = chunks.find(key(cx, cy, cz));
+        return it == chunks.end() ? nullptr : it->second.get();
+    }
+
+    Chunk& chunk(int cx, int cy, int cz) {
+        auto& slot = chunks[key(cx, cy, cz)];
+        if (!slot) {
+            slot.reset(new Chunk());
+            slot->cx = cx; slot->cy = cy; slot->cz = cz;
+            dirtyList.push_back(slot.get());
+        }
+        return *slot;
+    }
+
+    void mark(Chunk* c) {
+        if (c && !c->dirty) { c->dirty = true; dirtyList.push_back(c); }
+    }
+
+    // Only reads cells, so dirty chunks are built concurrently
+    void build(Chunk& c) {
+        const int n[3] = { kChunk, kChunk, kChunk };
+        const int bx = c.cx * kChunk, by = c.cy * kChunk, bz = c.cz * kChunk;
+        const VoxelGrid& g = c.cells;
+        auto at = [&](int x, int y, int z) -> uint8_t {
+            if (g.inside(x, y, z)) return g.cells[g.index(x, y, z)];
+            return get(bx + x, by + y, bz + z);
+        };
+        c.mesh = Mesh3D();
+        greedy_mesh_into(c.mesh, n, at, cell,
+                         Point3D(origin.x + bx * cell.x, origin.y + by * cell.y, origin.z + bz * cell.z),
+                         palette);
+        c.lo = c.hi = c.mesh.vertices.empty() ? origin : c.mesh.vertices[0];
+        for (const auto& p : c.mesh.vertices) {
+            c.lo = Point3D(std::min(c.lo.x, p.x), std::min(c.lo.y, p.y), std::min(c.lo.z, p.z));
+            c.hi = Point3D(std::max(c.hi.x, p.x), std::max(c.hi.y, p.y), std::max(c.hi.z, p.z));
+        }
+        c.dirty = false;
+    }
+};
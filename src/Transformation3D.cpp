@@ -1,5 +1,6 @@
 #include "Transformation3D.hpp"
 #include <cmath>
+#include <utility>
 
 Transformation3D::Transformation3D() {
     m = {{{{1,0,0,0}},
@@ -87,6 +88,39 @@ Transformation3D Transformation3D::operator*(const Transformation3D& other) cons
     return result;
 }
 
+Transformation3D Transformation3D::inverse() const {
+    std::array<std::array<double, 8>, 4> a;
+    for (int i=0; i<4; ++i) {
+        for (int j=0; j<4; ++j) {
+            a[i][j]   = m[i][j];
+            a[i][j+4] = (i==j) ? 1.0 : 0.0;
+        }
+    }
+    for (int c=0; c<4; ++c) {
+        int pivot = c;
+        for (int r=c+1; r<4; ++r) {
+            if (std::abs(a[r][c]) > std::abs(a[pivot][c])) pivot = r;
+        }
+        if (std::abs(a[pivot][c]) < 1e-15) return Transformation3D();
+        std::swap(a[c], a[pivot]);
+        double inv = 1.0 / a[c][c];
+        for (int j=0; j<8; ++j) a[c][j] *= inv;
+        for (int r=0; r<4; ++r) {
+            if (r == c) continue;
+            double f = a[r][c];
+            if (f == 0.0) continue;
+            for (int j=0; j<8; ++j) a[r][j] -= f * a[c][j];
+        }
+    }
+    Transformation3D result;
+    for (int i=0; i<4; ++i) {
+        for (int j=0; j<4; ++j) {
+            result.m[i][j] = a[i][j+4];
+        }
+    }
+    return result;
+}
+
 std::ostream& operator<<(std::ostream& os, const Transformation3D& t) {
     for (int i=0; i<4; ++i) {
         os << "[";
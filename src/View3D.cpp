@@ -12,11 +12,13 @@ Transformation3D View3D::view_matrix() const {
     // Recomputed up (y axis)
     Point3D u = r.cross(f);
 
+    // Camera space is +Z forward (x right, y up): Projection3D divides by a
+    // positive z and the Z-buffer keeps the smaller value as nearer.
     Transformation3D view;
     view.m = {{
         {{ r.x,  r.y,  r.z, -r.dot(eye) }},
         {{ u.x,  u.y,  u.z, -u.dot(eye) }},
-        {{-f.x, -f.y, -f.z,  f.dot(eye) }},
+        {{ f.x,  f.y,  f.z, -f.dot(eye) }},
         {{ 0,    0,    0,    1          }}
     }};
     return view;
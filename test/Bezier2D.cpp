@@ -0,0 +1,146 @@
+#include "Bezier2D.hpp"
+#include <iostream>
+#include <random>
+
+static double seg_dist(const Point2D& p, const Point2D& a, const Point2D& b) {
+    double vx = b.x - a.x, vy = b.y - a.y;
+    double wx = p.x - a.x, wy = p.y - a.y;
+    double L = vx*vx + vy*vy;
+    double t = (L > 0.0) ? std::max(0.0, std::min(1.0, (wx*vx + wy*vy) / L)) : 0.0;
+    double dx = wx - t*vx, dy = wy - t*vy;
+    return std::sqrt(dx*dx + dy*dy);
+}
+
+// Worst distance from densely sampled curve points to the polyline
+template<typename Eval>
+static double max_error(Eval eval, const std::vector<Point2D>& poly) {
+    double worst = 0.0;
+    for (int i=0; i<=1024; ++i) {
+        Point2D p = eval(i / 1024.0);
+        double best = 1e30;
+        for (size_t k=0; k+1<poly.size(); ++k) best = std::min(best, seg_dist(p, poly[k], poly[k+1]));
+        worst = std::max(worst, best);
+    }
+    return worst;
+}
+
+int main() {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> U(-1.0, 1.0);
+    bool ok = true;
+
+    // Flattening: within tolerance of the curve, ends exactly on the last
+    // control point, and appends exactly the count it returns after what
+    // the caller already had (sentinels in front stay untouched)
+    const Point2D sentinel(-12345.0, 6789.0);
+    double worstQ = 0.0, worstC = 0.0;
+    size_t badCount = 0, badEnd = 0, clobbered = 0;
+    for (double tol : { 0.1, 0.25, 1.0 }) {
+        for (int i=0; i<200; ++i) {
+            double scale = std::pow(10.0, 0.3 + 2.7 * (0.5 + 0.5 * U(rng)));   // 2 .. 1000 px
+            Point2D p[4];
+            for (auto& q : p) q = Point2D(scale * U(rng), scale * U(rng));
+
+            std::vector<Point2D> out(3, sentinel);
+            out.push_back(p[0]);
+            size_t n = Bezier2D::flatten_quadratic(p[0], p[1], p[2], tol, out);
+            badCount += out.size() != 4 + n;
+            badEnd += out.back().x != p[2].x || out.back().y != p[2].y;
+            for (int k=0; k<3; ++k) clobbered += out[k].x != sentinel.x || out[k].y != sentinel.y;
+            std::vector<Point2D> poly(out.begin() + 3, out.end());
+            worstQ = std::max(worstQ, max_error([&](double t) { return Bezier2D::quad(p[0], p[1], p[2], t); }, poly) / tol);
+
+            out.assign(3, sentinel);
+            out.push_back(p[0]);
+            n = Bezier2D::flatten_cubic(p[0], p[1], p[2], p[3], tol, out);
+            badCount += out.size() != 4 + n;
+            badEnd += out.back().x != p[3].x || out.back().y != p[3].y;
+            for (int k=0; k<3; ++k) clobbered += out[k].x != sentinel.x || out[k].y != sentinel.y;
+            poly.assign(out.begin() + 3, out.end());
+            worstC = std::max(worstC, max_error([&](double t) { return Bezier2D::cubic(p[0], p[1], p[2], p[3], t); }, poly) / tol);
+        }
+    }
+    std::cout << "flatten, 600 quadratics and 600 cubics: worst error / tolerance " << worstQ << " / " << worstC
+              << ", wrong counts " << badCount << ", wrong end points " << badEnd
+              << ", caller points overwritten " << clobbered << "\n";
+    ok &= worstQ <= 1.0 + 1e-9 && worstC <= 1.0 + 1e-9 && badCount == 0 && badEnd == 0 && clobbered == 0;
+
+    // Chained: a second curve appends after the first, which stays intact
+    std::vector<Point2D> chain{ Point2D(0,0) };
+    size_t n1 = Bezier2D::flatten_cubic(Point2D(0,0), Point2D(50,120), Point2D(150,-80), Point2D(200,0), 0.25, chain);
+    std::vector<Point2D> first = chain;
+    size_t n2 = Bezier2D::flatten_quadratic(Point2D(200,0), Point2D(260,90), Point2D(320,0), 0.25, chain);
+    bool chained = chain.size() == 1 + n1 + n2 && std::equal(first.begin(), first.end(), chain.begin(),
+        [](const Point2D& a, const Point2D& b) { return a.x == b.x && a.y == b.y; });
+    std::cout << "chained curves: " << n1 << " + " << n2 << " points, first curve kept " << (chained ? "yes" : "NO") << "\n";
+    ok &= chained;
+
+    // Fixed-count tessellation against direct Bernstein evaluation, in
+    // curve units of up to 1000 px: forward differencing accumulates
+    // rounding along the curve, the batch does not. Raw output buffers get
+    // sentinels just past segments+1 that must survive.
+    const int S = 64;
+    std::vector<Point2D> pts;
+    Bezier2D::Batch<2> lines;
+    Bezier2D::Batch<3> quads;
+    Bezier2D::Batch<4> cubics;
+    for (int i=0; i<500; ++i) {
+        Point2D p[4];
+        for (auto& q : p) q = Point2D(500.0 + 500.0 * U(rng), 500.0 + 500.0 * U(rng));
+        pts.insert(pts.end(), p, p + 4);
+        lines.add(p[0], p[3]);
+        quads.add(p[0], p[1], p[2]);
+        cubics.add(p[0], p[1], p[2], p[3]);
+    }
+    auto dist = [](const Point2D& a, const Point2D& b) { return std::hypot(a.x - b.x, a.y - b.y); };
+    double fdQ = 0.0, fdC = 0.0;
+    size_t overrun = 0;
+    std::vector<Point2D> buf(S + 3);
+    for (size_t i=0; i<pts.size(); i+=4) {
+        const Point2D* p = &pts[i];
+        for (int degree : { 2, 3 }) {
+            std::fill(buf.begin(), buf.end(), sentinel);
+            if (degree == 2) Bezier2D::forward_diff_quadratic(p[0], p[1], p[2], S, buf.data());
+            else             Bezier2D::forward_diff_cubic(p[0], p[1], p[2], p[3], S, buf.data());
+            for (int k=S+1; k<S+3; ++k) overrun += buf[k].x != sentinel.x || buf[k].y != sentinel.y;
+            for (int k=0; k<=S; ++k) {
+                double t = (double)k / S;
+                if (degree == 2) fdQ = std::max(fdQ, dist(buf[k], Bezier2D::quad(p[0], p[1], p[2], t)));
+                else             fdC = std::max(fdC, dist(buf[k], Bezier2D::cubic(p[0], p[1], p[2], p[3], t)));
+            }
+        }
+    }
+    std::vector<double> xs, ys;
+    double bl = 0.0, bq = 0.0, bc = 0.0;
+    const size_t m = cubics.size();
+    Bezier2D::evaluate(lines, S, xs, ys);
+    bool sized = xs.size() == (size_t)(S + 1) * m && ys.size() == xs.size();
+    for (int k=0; k<=S; ++k)
+        for (size_t i=0; i<m; ++i) {
+            double t = (double)k / S;
+            const Point2D* p = &pts[4*i];
+            Point2D l(p[0].x + t * (p[3].x - p[0].x), p[0].y + t * (p[3].y - p[0].y));
+            bl = std::max(bl, dist(Point2D(xs[k*m + i], ys[k*m + i]), l));
+        }
+    Bezier2D::evaluate(quads, S, xs, ys);
+    sized &= xs.size() == (size_t)(S + 1) * m;
+    for (int k=0; k<=S; ++k)
+        for (size_t i=0; i<m; ++i) {
+            const Point2D* p = &pts[4*i];
+            bq = std::max(bq, dist(Point2D(xs[k*m + i], ys[k*m + i]), Bezier2D::quad(p[0], p[1], p[2], (double)k / S)));
+        }
+    Bezier2D::evaluate(cubics, S, xs, ys);
+    sized &= xs.size() == (size_t)(S + 1) * m;
+    for (int k=0; k<=S; ++k)
+        for (size_t i=0; i<m; ++i) {
+            const Point2D* p = &pts[4*i];
+            bc = std::max(bc, dist(Point2D(xs[k*m + i], ys[k*m + i]), Bezier2D::cubic(p[0], p[1], p[2], p[3], (double)k / S)));
+        }
+    std::cout << "tessellation, " << m << " curves x " << S << " segments, worst distance from Bernstein: forward diff "
+              << fdQ << " / " << fdC << " (quadratic / cubic), batch " << bl << " / " << bq << " / " << bc
+              << " (linear / quadratic / cubic); sentinels overwritten " << overrun << "\n";
+    ok &= fdQ < 1e-9 && fdC < 1e-9 && bl < 1e-9 && bq < 1e-9 && bc < 1e-9 && overrun == 0 && sized;
+
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+#include "Bresenham.hpp"
+#include "RasterBuffer.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+// Reference: the error-accumulator Bresenham Drawing2D used before the
+// up-front clipping, skipping each pixel outside the clip rectangle
+static void line_ref(RasterBuffer<uint8_t>& rb, const Bresenham::ClipRect& clip,
+                     int x0, int y0, int x1, int y1, uint8_t r, uint8_t g, uint8_t b) {
+    int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+        if (x0 >= clip.x0 && x0 < clip.x1 && y0 >= clip.y0 && y0 < clip.y1) rb.set_pixel(x0, y0, r, g, b);
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2*err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+int main() {
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> U(-400, 700);
+    size_t diffs = 0;
+    for (int ch : { 1, 3, 4 }) {
+        RasterBuffer<uint8_t> a(300,200,ch,0,false), b(300,200,ch,0,false);
+        for (int i=0; i<4000; ++i) {
+            int x0 = U(rng), y0 = U(rng), x1 = U(rng), y1 = U(rng);
+            if (i % 7 == 0) y1 = y0;                     // horizontal
+            if (i % 11 == 0) x1 = x0;                    // vertical
+            Bresenham::ClipRect clip = (i % 3 == 0) ? Bresenham::ClipRect{ 40, 30, 260, 170 }
+                                                    : Bresenham::full(a);
+            uint8_t r = (uint8_t)i, g = (uint8_t)(i >> 3), bl = (uint8_t)(i * 7);
+            Bresenham::line(a, clip, x0, y0, x1, y1, r, g, bl);
+            line_ref(b, clip, x0, y0, x1, y1, r, g, bl);
+        }
+        for (size_t k=0; k<a.data.size(); ++k) diffs += a.data[k] != b.data[k];
+    }
+    // Every short slope in both directions: the half-way ties
+    for (int dy=-12; dy<=12; ++dy)
+        for (int dx=-12; dx<=12; ++dx) {
+            RasterBuffer<uint8_t> a(40,40,1,0,false), b(40,40,1,0,false);
+            Bresenham::line(a, 20, 20, 20+dx, 20+dy, 255);
+            line_ref(b, Bresenham::full(b), 20, 20, 20+dx, 20+dy, 255, 255, 255);
+            for (size_t k=0; k<a.data.size(); ++k) diffs += a.data[k] != b.data[k];
+        }
+    std::cout << "clipped vs reference: " << diffs << " differing bytes\n";
+    bool ok = diffs == 0;
+
+    // Mostly off-screen lines: the clipped walk only visits visible pixels
+    RasterBuffer<uint8_t> rb(512,512,3,0,false);
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+    std::uniform_int_distribution<int> F(-20000, 20000);
+    std::vector<int> c(4 * 2000);
+    for (auto& v : c) v = F(rng);
+    auto t0 = std::chrono::steady_clock::now();
+    for (size_t i=0; i<c.size(); i+=4) line_ref(rb, Bresenham::full(rb), c[i], c[i+1], c[i+2], c[i+3], 255, 255, 255);
+    auto t1 = std::chrono::steady_clock::now();
+    for (size_t i=0; i<c.size(); i+=4) Bresenham::line(rb, c[i], c[i+1], c[i+2], c[i+3], 255);
+    auto t2 = std::chrono::steady_clock::now();
+    std::cout << "2000 long lines: per-pixel checks " << ms(t0,t1) << " ms, clipped " << ms(t1,t2) << " ms\n";
+
+    // On-screen wireframe-like lines
+    std::uniform_int_distribution<int> S(0, 511);
+    for (auto& v : c) v = S(rng);
+    t0 = std::chrono::steady_clock::now();
+    for (size_t i=0; i<c.size(); i+=4) line_ref(rb, Bresenham::full(rb), c[i], c[i+1], c[i+2], c[i+3], 200, 100, 50);
+    t1 = std::chrono::steady_clock::now();
+    for (size_t i=0; i<c.size(); i+=4) Bresenham::line(rb, c[i], c[i+1], c[i+2], c[i+3], 200, 100, 50);
+    t2 = std::chrono::steady_clock::now();
+    std::cout << "2000 on-screen lines: per-pixel checks " << ms(t0,t1) << " ms, clipped " << ms(t1,t2) << " ms\n";
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+#include "Drawing2D.hpp"
+#include "RasterBuffer.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+int main() {
+    // Each row offset comes out exactly once, and the union of the rows is
+    // the same disc the outline encloses
+    size_t repeated = 0, mismatched = 0;
+    for (int r=0; r<=200; ++r) {
+        std::vector<int> half(r + 1, -1);
+        Bresenham::circle_rows(r, [&](int dy, int hw) { if (half[dy] >= 0) ++repeated; half[dy] = hw; });
+        for (int dy=0; dy<=r; ++dy) if (half[dy] < 0) ++mismatched;
+
+        RasterBuffer<uint8_t> o(2*r+3, 2*r+3, 1, 0, false);
+        Bresenham::circle(o, r+1, r+1, r, 255);
+        for (int dy=0; dy<=r; ++dy) {
+            int widest = 0;
+            for (int x=0; x<=r; ++x) if (o.data[(size_t)(r+1+dy)*o.width + r+1+x]) widest = x;
+            if (widest != half[dy]) ++mismatched;
+        }
+    }
+    std::cout << "circle rows: " << repeated << " repeated, " << mismatched << " differ from the outline\n";
+    bool ok = repeated == 0 && mismatched == 0;
+
+    RasterBuffer<uint8_t> rb(400,300,3,0,false);
+    Drawing2D d(rb);
+    d.fill_circle(Point2D(100,100), 60, 200);
+    d.fill_ellipse(Point2D(280,100), 90, 40, 120);
+    d.fill_circle(Point2D(390,290), 50, 80);          // clipped
+    for (int i=0; i<6; ++i) d.circle_aa(Point2D(100,230), 10.0 + i*9.3, 255);
+    d.ellipse_aa(Point2D(280,230), 100.0, 45.5, 255);
+    d.ellipse_aa(Point2D(280,230), 30.0, 60.0, 255);
+    rb.save_ppm("circles.ppm");
+
+    // Area of the filled disc against pi r^2
+    RasterBuffer<uint8_t> g(256,256,1,0,false);
+    Drawing2D dg(g);
+    dg.fill_circle(Point2D(128,128), 100, 255);
+    size_t n = 0;
+    for (uint8_t v : g.data) n += v != 0;
+    std::cout << "disc r=100: " << n << " pixels vs pi r^2 = " << M_PI * 100 * 100 << "\n";
+    ok &= std::fabs(n - M_PI * 100 * 100) < 2 * M_PI * 100;
+
+    // Markers: one batch call against one call per disc
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> U(-10.0, 1034.0);
+    std::vector<Point2D> centers(10000);
+    for (auto& c : centers) c = Point2D(U(rng), U(rng));
+    RasterBuffer<uint8_t> a(1024,1024,3,0,false), b(1024,1024,3,0,false);
+    Drawing2D da(a), db(b);
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+    db.fill_markers(centers, 4, 255);                 // warm both targets
+    for (const auto& c : centers) da.fill_circle(c, 4, 255);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int k=0; k<10; ++k) for (const auto& c : centers) da.fill_circle(c, 4, 255);
+    auto t1 = std::chrono::steady_clock::now();
+    for (int k=0; k<10; ++k) db.fill_markers(centers, 4, 255);
+    auto t2 = std::chrono::steady_clock::now();
+    std::cout << "10 x 10000 markers: " << ms(t0,t1) << " ms one by one, " << ms(t1,t2) << " ms batched, "
+              << (a.data == b.data ? "identical" : "DIFFERENT") << "\n";
+    ok &= a.data == b.data;
+
+    // One CircleScratch carried across calls whose radius, target size and
+    // disc count grow and shrink, so the row table and band order are
+    // reused at both larger and smaller sizes than they hold
+    Bresenham::CircleScratch scratch;
+    size_t reusedDiffer = 0;
+    const int sizes[][3] = { { 512, 384, 9 }, { 64, 48, 2 }, { 640, 700, 25 }, { 100, 100, 0 }, { 300, 200, 14 } };
+    for (const auto& sz : sizes) {
+        const int w = sz[0], h = sz[1], r = sz[2];
+        std::uniform_real_distribution<double> X(-30.0, w + 30.0), Y(-30.0, h + 30.0);
+        std::vector<int> xs(200 + 300 * r), ys(xs.size());
+        for (size_t i=0; i<xs.size(); ++i) { xs[i] = (int)X(rng); ys[i] = (int)Y(rng); }
+        RasterBuffer<uint8_t> one(w, h, 1, 0, false), batched(w, h, 1, 0, false);
+        for (size_t i=0; i<xs.size(); ++i) Bresenham::fill_circle(one, xs[i], ys[i], r, 255);
+        Bresenham::fill_circles(batched, xs.data(), ys.data(), xs.size(), r, 255, scratch);
+        reusedDiffer += one.data != batched.data;
+    }
+    std::cout << "reused scratch over 5 sizes: " << reusedDiffer << " differ from one by one\n";
+    ok &= reusedDiffer == 0;
+
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
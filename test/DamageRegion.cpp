@@ -0,0 +1,58 @@
+#include "CompoundGraphicObject2D.hpp"
+#include "GO_Point2D.hpp"
+#include "GO_Polyline2D.hpp"
+#include "GO_Polygon2D.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+int main() {
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<double> U(0.0, 800.0), D(-15.0, 15.0);
+    CompoundGraphicObject2D scene;
+    std::vector<std::shared_ptr<GO_Point2D>> markers;
+    for (int i=0; i<20000; ++i) {
+        Point2D o(U(rng), U(rng));
+        if (i % 2) {
+            scene.add(std::make_shared<GO_Polyline2D>(std::vector<Point2D>{ o, Point2D(o.x + D(rng), o.y + D(rng)) }));
+        } else {
+            markers.push_back(std::make_shared<GO_Point2D>(o));
+            scene.add(markers.back());
+        }
+    }
+    scene.add(std::make_shared<GO_Polygon2D>(std::vector<Point2D>{ {50,50}, {750,80}, {400,760} }));
+
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+    RasterBuffer<uint8_t> rb(800,800,3,0,false);
+    scene.redraw(rb);                                   // first frame: everything is new
+
+    // Move a handful of markers and repaint just their old and new spots
+    std::uniform_int_distribution<size_t> pick(0, markers.size() - 1);
+    std::uniform_real_distribution<double> step(-3.0, 3.0);
+    double incMs = 0.0, fullMs = 0.0;
+    long long area = 0;
+    size_t mismatched = 0;
+    for (int frame=0; frame<10; ++frame) {
+        for (int k=0; k<5; ++k) {
+            auto m = markers[pick(rng)];
+            scene.modify(m, [&] { m->p = Point2D(m->p.x + step(rng), m->p.y + step(rng)); });
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        DamageRegion d = scene.redraw(rb);
+        auto t1 = std::chrono::steady_clock::now();
+        area += d.area();
+
+        RasterBuffer<uint8_t> ref(800,800,3,0,false);
+        auto t2 = std::chrono::steady_clock::now();
+        scene.draw(ref);
+        auto t3 = std::chrono::steady_clock::now();
+        incMs += ms(t0,t1); fullMs += ms(t2,t3);
+        for (size_t i=0; i<rb.data.size(); ++i) mismatched += rb.data[i] != ref.data[i];
+        if (frame == 9) rb.save_ppm("damage_last.ppm", d.bounds());
+    }
+    std::cout << "incremental " << incMs / 10 << " ms/frame (" << area / 10 << " px repainted), full "
+              << fullMs / 10 << " ms/frame; " << mismatched << " differing bytes\n";
+    bool ok = mismatched == 0 && area > 0 && area < 10LL * 800 * 800;
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+#include "DisplayList2D.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+int main() {
+    // 100k objects: points, short polylines, triangles, one nested group
+    std::mt19937 rng(9);
+    std::uniform_real_distribution<double> U(-20.0, 1044.0), D(-12.0, 12.0);
+    CompoundGraphicObject2D scene;
+    auto group = std::make_shared<CompoundGraphicObject2D>();
+    for (int i=0; i<100000; ++i) {
+        Point2D o(U(rng), U(rng));
+        auto& dst = (i % 10 == 0) ? *group : scene;
+        switch (i % 3) {
+            case 0: dst.add(std::make_shared<GO_Point2D>(o)); break;
+            case 1: dst.add(std::make_shared<GO_Polyline2D>(std::vector<Point2D>{
+                        o, Point2D(o.x + D(rng), o.y + D(rng)), Point2D(o.x + D(rng), o.y + D(rng)) })); break;
+            default: dst.add(std::make_shared<GO_Polygon2D>(std::vector<Point2D>{
+                        o, Point2D(o.x + D(rng), o.y + D(rng)), Point2D(o.x + D(rng), o.y + D(rng)) })); break;
+        }
+    }
+    scene.add(group);
+
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+    RasterBuffer<uint8_t> ref(1024,1024,3,0,false), a(1024,1024,3,0,false), b(1024,1024,3,0,false);
+
+    scene.draw(ref, 200);                          // warm the targets
+    auto t0 = std::chrono::steady_clock::now();
+    scene.draw(ref, 200);
+    auto t1 = std::chrono::steady_clock::now();
+
+    DisplayList2D dl;
+    dl.compile(scene, 200);
+    auto t2 = std::chrono::steady_clock::now();
+    dl.replay(a);
+    dl.replay(a);
+    auto t3 = std::chrono::steady_clock::now();
+    dl.replay(b, 0);
+    dl.replay(b, 0);
+    auto t4 = std::chrono::steady_clock::now();
+
+    std::cout << dl.segments() << " segments, " << dl.points() << " points\n"
+              << "tree draw " << ms(t0,t1) << " ms, compile " << ms(t1,t2)
+              << " ms, replay " << ms(t2,t3) / 2 << " ms, parallel replay " << ms(t3,t4) / 2 << " ms\n"
+              << "replay " << (a.data == ref.data ? "matches" : "DIFFERS FROM") << " tree draw, parallel "
+              << (b.data == ref.data ? "matches" : "DIFFERS") << "\n";
+    bool ok = dl.segments() > 0 && a.data == ref.data && b.data == ref.data;
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
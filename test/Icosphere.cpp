@@ -0,0 +1,92 @@
+#include "MeshBuilders.hpp"
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <unordered_map>
+
+// The previous std::map midpoint cache, for timing and cross-checking
+static Mesh3D subdivide_reference(const Mesh3D& mesh, int level, double radius) {
+    Mesh3D result;
+    result.vertices = mesh.vertices;
+    result.faces = mesh.faces;
+    for (int l=0; l<level; ++l) {
+        std::map<std::pair<int,int>,int> cache;
+        std::vector<Face> newFaces;
+        for (const auto& f : result.faces) {
+            int v0=f.indices[0], v1=f.indices[1], v2=f.indices[2];
+            auto midpoint = [&](int a, int b) {
+                auto key = std::make_pair(std::min(a,b), std::max(a,b));
+                auto it = cache.find(key);
+                if (it != cache.end()) return it->second;
+                Point3D pm = (result.vertices[a] + result.vertices[b]) * 0.5;
+                double len = std::sqrt(pm.x*pm.x + pm.y*pm.y + pm.z*pm.z);
+                result.vertices.push_back(Point3D(pm.x/len*radius, pm.y/len*radius, pm.z/len*radius));
+                return cache[key] = (int)result.vertices.size() - 1;
+            };
+            int a = midpoint(v0,v1), b = midpoint(v1,v2), c = midpoint(v2,v0);
+            newFaces.push_back({{v0,a,c}});
+            newFaces.push_back({{v1,b,a}});
+            newFaces.push_back({{v2,c,b}});
+            newFaces.push_back({{a,b,c}});
+        }
+        result.faces = newFaces;
+    }
+    return result;
+}
+
+int main() {
+    bool ok = true;
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+    Mesh3D base = make_icosahedron(2.0);
+    for (int L=0; L<=7; ++L) {
+        auto t0 = std::chrono::steady_clock::now();
+        Mesh3D m = subdivide_icosphere(base, L, 2.0);
+        auto t1 = std::chrono::steady_clock::now();
+        Mesh3D r = (L <= 6) ? subdivide_reference(base, L, 2.0) : Mesh3D();
+        auto t2 = std::chrono::steady_clock::now();
+
+        // Closed 2-manifold on the sphere: V - E + F = 2, every edge used twice
+        std::unordered_map<uint64_t,int> uses;
+        for (const auto& f : m.faces)
+            for (int j=0; j<3; ++j) {
+                int a = f.indices[j], b = f.indices[(j+1)%3];
+                ++uses[((uint64_t)std::min(a,b) << 32) | (uint32_t)std::max(a,b)];
+            }
+        size_t bad = 0;
+        for (auto& kv : uses) bad += kv.second != 2;
+        double radiusErr = 0.0;
+        for (const auto& v : m.vertices) radiusErr = std::max(radiusErr, std::abs(v.length() - 2.0));
+        long euler = (long)m.vertices.size() - (long)uses.size() + (long)m.faces.size();
+
+        // Same surface as the reference: every face's vertex set appears there
+        size_t missing = 0;
+        if (L <= 6) {
+            std::map<std::tuple<long,long,long>,int> at;
+            auto key = [](const Point3D& p) { return std::make_tuple(std::lround(p.x*1e6), std::lround(p.y*1e6), std::lround(p.z*1e6)); };
+            for (size_t i=0; i<r.vertices.size(); ++i) at[key(r.vertices[i])] = (int)i;
+            std::map<std::array<int,3>,int> refFaces;
+            for (const auto& f : r.faces) refFaces[{ f.indices[0], f.indices[1], f.indices[2] }] = 1;
+            for (const auto& f : m.faces) {
+                std::array<int,3> k;
+                bool found = true;
+                for (int j=0; j<3; ++j) {
+                    auto it = at.find(key(m.vertices[f.indices[j]]));
+                    found &= it != at.end();
+                    k[j] = found ? it->second : -1;
+                }
+                missing += !found || !refFaces.count(k);
+            }
+            missing += m.faces.size() != r.faces.size() || m.vertices.size() != r.vertices.size();
+        }
+
+        std::cout << "level " << L << ": " << m.vertices.size() << " verts, " << m.faces.size() << " faces, euler "
+                  << euler << ", bad edges " << bad << ", radius err " << radiusErr
+                  << ", faces not in reference " << missing << "; " << ms(t0,t1) << " ms";
+        if (L <= 6) std::cout << " (map-based " << ms(t1,t2) << " ms)";
+        std::cout << "\n";
+        ok &= euler == 2 && bad == 0 && radiusErr < 1e-9 && missing == 0
+              && m.faces.size() == base.faces.size() << (2 * L);
+    }
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
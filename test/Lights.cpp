@@ -0,0 +1,112 @@
+#include "Mesh3D.hpp"
+#include "MeshRenderer2D.hpp"
+#include "View3DParameters.hpp"
+#include "RasterBuffer.hpp"
+#include <iostream>
+
+int main() {
+    View3DParameters params(Point3D(0,0,5), Point3D(0,0,0), Point3D(0,1,0),
+                            60.0*M_PI/180.0, 1.0, 0.1, 100.0);
+    View3D cam = params.make_view();
+    Projection3D proj = params.make_projection();
+
+    // A 16x16 quad grid facing the camera (view space, z = 4)
+    Mesh3D floor;
+    const int n = 16;
+    for (int j=0;j<=n;++j)
+        for (int i=0;i<=n;++i) {
+            floor.vertices.push_back(Point3D(-2.0 + 4.0*i/n, -2.0 + 4.0*j/n, 4.0));
+            floor.colors.push_back(Point3D(1,1,1));
+        }
+    for (int j=0;j<n;++j)
+        for (int i=0;i<n;++i) {
+            int v0 = j*(n+1)+i, v1 = v0+1, v2 = v0+(n+1), v3 = v2+1;
+            floor.faces.push_back(Face{{v0,v2,v3,v1}});
+        }
+    std::vector<Point3D> vnorm(floor.vertices.size(), Point3D(0,0,-1));
+
+    RasterBuffer<uint8_t> rb(256,256,3,0,true);
+    MeshRenderer2D renderer(rb, cam, proj);
+
+    // Dim blue "moon" plus a ring of short-range colored point lights
+    renderer.lights.push_back(Light::directional(Point3D(0,0,-1), Point3D(0.05,0.05,0.15)));
+    for (int k=0;k<12;++k) {
+        double a = k * 2.0*M_PI/12;
+        Point3D col((k%3)==0, (k%3)==1, (k%3)==2);
+        renderer.lights.push_back(Light::point(Point3D(1.2*std::cos(a), 1.2*std::sin(a), 3.6),
+                                               col, 0.8));
+    }
+    renderer.lights.push_back(Light::spot(Point3D(0,0,0), Point3D(0,0,1), Point3D(1,1,1),
+                                          10.0, 0.05, 0.1));
+
+    rb.clear_depth();
+    renderer.render(floor, vnorm, RenderMode::Phong);
+    rb.save_ppm("lights_phong.ppm");
+
+    rb.clear_depth(); rb.data.assign(rb.data.size(),0);
+    renderer.render(floor, vnorm, RenderMode::Gouraud);
+    rb.save_ppm("lights_gouraud.ppm");
+
+    bool ok = true;
+    auto check = [&](const char* what, bool pass) { std::cout << what << ": " << (pass ? "ok" : "FAIL") << "\n"; ok &= pass; };
+    auto pixel_sum = [&](int x, int y) {
+        uint8_t r,g,b,a;
+        rb.get_pixel(x,y,r,g,b,a);
+        return (int)r + g + b;
+    };
+    auto render_phong = [&](const std::vector<Light>& lights) {
+        renderer.lights = lights;
+        rb.clear_depth(); rb.data.assign(rb.data.size(),0);
+        renderer.render(floor, vnorm, RenderMode::Phong);
+    };
+    std::vector<Light> ring = renderer.lights;
+
+    // Each dim point light over the centre adds to it
+    std::vector<Light> stack;
+    int prev = -1;
+    bool brighter = true;
+    for (int k=0;k<4;++k) {
+        double a = k * M_PI/2;
+        stack.push_back(Light::point(Point3D(0.3*std::cos(a), 0.3*std::sin(a), 3.0), Point3D(0.4,0.4,0.4), 3.0));
+        render_phong(stack);
+        int s = pixel_sum(128,128);
+        std::cout << "  " << stack.size() << " light(s): centre " << s << "\n";
+        brighter &= s > prev;
+        prev = s;
+    }
+    check("centre brightens with each light", brighter);
+
+    // Windowed falloff: nothing at or beyond the range, something inside it
+    LightSoA soa;
+    soa.build({ Light::point(Point3D(0,0,3), Point3D(1,1,1), 1.0),
+                Light::spot(Point3D(0,0,3), Point3D(0,0,1), Point3D(1,1,1), 1.0, 0.5, 0.6) });
+    const int both[2] = { 0, 1 };
+    const Point3D N(0,0,-1), V(0,0,-1);
+    Point3D at = shade_lights(soa, both, 2, N, Point3D(0,0,4.0), V, 0.7, 0.3, 16.0);
+    Point3D past = shade_lights(soa, both, 2, N, Point3D(0,0,4.5), V, 0.7, 0.3, 16.0);
+    Point3D inside = shade_lights(soa, both, 2, N, Point3D(0,0,3.9), V, 0.7, 0.3, 16.0);
+    check("zero at and beyond range",
+          at.x == 0.0 && at.y == 0.0 && at.z == 0.0 && past.x == 0.0 && past.y == 0.0 && past.z == 0.0
+          && inside.x > 0.0);
+
+    // In the corner no ring light reaches: the same pixel as the moon alone
+    render_phong(ring);
+    int withRing = pixel_sum(24,24), ringCentre = pixel_sum(128,128);
+    render_phong({ ring.front() });
+    check("out-of-range lights leave the corner unchanged",
+          withRing == pixel_sum(24,24) && ringCentre > pixel_sum(128,128));
+
+    // Culling keeps directional lights and exactly the point lights in reach
+    LightSoA cull;
+    cull.build({ Light::directional(Point3D(0,0,-1)),
+                 Light::point(Point3D(0,0,0), Point3D(1,1,1), 1.0),      // reaches the sphere
+                 Light::point(Point3D(5,0,0), Point3D(1,1,1), 1.0),      // 3.5 short
+                 Light::point(Point3D(0,2.4,0), Point3D(1,1,1), 2.0) }); // overlaps by 0.1
+    std::vector<int> kept;
+    cull_lights_sphere(cull, Point3D(0,0,0.5), 0.5, kept);
+    check("cull_lights_sphere drops out-of-range lights", kept == std::vector<int>({ 0, 1, 3 }));
+
+    std::cout << "Saved lights_phong.ppm and lights_gouraud.ppm\n";
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
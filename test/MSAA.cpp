@@ -0,0 +1,103 @@
+#include "MeshBuilders.hpp"
+#include "MeshRenderer2D.hpp"
+#include "View3DParameters.hpp"
+#include "RasterBuffer.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+int main() {
+    View3DParameters params(Point3D(3,2.5,-4), Point3D(0,0,0), Point3D(0,1,0),
+                            60.0*M_PI/180.0, 1.0, 0.1, 100.0);
+    View3D cam = params.make_view();
+    Projection3D proj = params.make_projection();
+
+    Mesh3D cube = make_cube(2, 2, 2, Point3D(0.8,0.6,0.3));
+    Transformation3D V = cam.view_matrix();
+    for (auto& p : cube.vertices) p = V.apply(p);
+    auto vnorm = cube.compute_vertex_normals();
+
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+
+    // Reference: one sample per pixel
+    RasterBuffer<uint8_t> ref(256,256,3,0,true);
+    MeshRenderer2D r0(ref, cam, proj, Point3D(0.3,0.4,-1.0));
+    auto t0 = std::chrono::steady_clock::now();
+    r0.render(cube, vnorm, RenderMode::Gouraud);
+    auto t1 = std::chrono::steady_clock::now();
+    ref.save_ppm("msaa_off.ppm");
+
+    // 4x MSAA, same scene
+    RasterBuffer<uint8_t> rb(256,256,3,0,true);
+    rb.enable_msaa(4);
+    MeshRenderer2D r4(rb, cam, proj, Point3D(0.3,0.4,-1.0));
+    auto t2 = std::chrono::steady_clock::now();
+    r4.render(cube, vnorm, RenderMode::Gouraud);
+    auto t3 = std::chrono::steady_clock::now();
+    rb.save_ppm("msaa_4x.ppm");
+
+    // Silhouette pixels get partial coverage; fully covered pixels whose
+    // samples all come from one face shade exactly as without MSAA (one
+    // evaluation at the pixel center)
+    size_t partial = 0, full = 0, straddling = 0, mismatched = 0;
+    for (int y=0;y<rb.height;++y) {
+        for (int x=0;x<rb.width;++x) {
+            size_t i = (size_t)y*rb.width + x;
+            int n = 0;
+            for (int s=0;s<rb.samples;++s) n += rb.sampleDepth[i*rb.samples+s] < 1e9;
+            if (n == 0) continue;
+            if (n < rb.samples) { ++partial; continue; }
+            ++full;
+            bool edgeRef = false;   // skip pixels next to the reference silhouette
+            for (int dy=-1; dy<=1; ++dy)
+                for (int dx=-1; dx<=1; ++dx)
+                    if (ref.in_bounds(x+dx,y+dy) && ref.depth[(size_t)(y+dy)*ref.width + x+dx] >= 1e9) edgeRef = true;
+            if (edgeRef) continue;
+            bool uniform = true;    // samples straddling two faces resolve to a blend
+            for (int k=1;k<rb.samples*3;++k)
+                uniform &= rb.sampleData[i*rb.samples*3 + k] == rb.sampleData[i*rb.samples*3 + k%3];
+            if (!uniform) { ++straddling; continue; }
+            for (int c=0;c<3;++c)
+                if (std::abs(rb.data[i*3+c] - ref.data[i*3+c]) > 1) { ++mismatched; break; }
+        }
+    }
+    std::cout << "1x: " << ms(t0,t1) << " ms, 4x MSAA: " << ms(t2,t3) << " ms\n"
+              << "partially covered pixels: " << partial << ", fully covered: " << full
+              << " (" << straddling << " straddling two faces), interior mismatches: " << mismatched << "\n";
+
+    // Wireframe goes into the samples before the resolve: edge pixels get
+    // partial coverage, somewhere between the shaded surface and white
+    RasterBuffer<uint8_t> wire(256,256,3,0,true);
+    wire.enable_msaa(4);
+    MeshRenderer2D rw(wire, cam, proj, Point3D(0.3,0.4,-1.0));
+    rw.render(cube, vnorm, RenderMode::Gouraud, true);
+    wire.save_ppm("msaa_4x_wire.ppm");
+    size_t changed = 0, blended = 0;
+    for (size_t i=0; i<(size_t)wire.width*wire.height; ++i) {
+        int c = wire.data[i*3+2], under = rb.data[i*3+2];   // blue: surface is far from white
+        if (c == under) continue;
+        ++changed;
+        blended += c < 250 && c > under;
+    }
+    std::cout << "wireframe pixels: " << changed << ", antialiased: " << blended << "\n";
+
+    // Clipped: neither the surface samples nor the wire samples land
+    // outside the clip rectangle
+    RasterBuffer<uint8_t> clipped(256,256,3,0,true);
+    clipped.enable_msaa(4);
+    clipped.set_clip({ 100, 90, 180, 170 });
+    MeshRenderer2D rc(clipped, cam, proj, Point3D(0.3,0.4,-1.0));
+    rc.render(cube, vnorm, RenderMode::Gouraud, true);
+    size_t outside = 0, inside = 0;
+    for (int y=0;y<clipped.height;++y)
+        for (int x=0;x<clipped.width;++x) {
+            size_t i = (size_t)y*clipped.width + x;
+            bool drawn = clipped.data[i*3] || clipped.data[i*3+1] || clipped.data[i*3+2];
+            (clipped.in_clip(x,y) ? inside : outside) += drawn;
+        }
+    std::cout << "clipped wireframe render: " << inside << " pixels inside the clip, " << outside << " outside\n";
+
+    bool ok = partial > 0 && mismatched == 0 && inside > 0 && outside == 0 && changed > 0 && blended * 3 > changed;
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+#include "MeshCache.hpp"
+#include "MeshBuilders.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+
+// Same mesh up to float rounding of the attributes
+static bool same(const Mesh3D& a, const Mesh3D& b) {
+    if (a.vertices.size() != b.vertices.size() || a.faces.size() != b.faces.size()
+        || a.uv.size() != b.uv.size() || a.colors.size() != b.colors.size()) return false;
+    for (size_t i=0; i<a.vertices.size(); ++i)
+        if ((a.vertices[i] - b.vertices[i]).length() > 1e-6) return false;
+    for (size_t i=0; i<a.uv.size(); ++i)
+        if (std::fabs(a.uv[i].x - b.uv[i].x) + std::fabs(a.uv[i].y - b.uv[i].y) > 1e-6) return false;
+    for (size_t i=0; i<a.colors.size(); ++i)
+        if ((a.colors[i] - b.colors[i]).length() > 1e-6) return false;
+    for (size_t f=0; f<a.faces.size(); ++f)
+        if (a.faces[f].indices != b.faces[f].indices) return false;
+    return true;
+}
+
+static void flip_byte(const std::string& path, long at) {
+    std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+    f.seekg(at);
+    char c; f.get(c);
+    f.seekp(at);
+    f.put((char)(c ^ 0x10));
+}
+
+// Edit the header and payload of a cache file and fix up its checksum, so
+// only the structural checks stand between the edit and a mapped mesh
+template<typename Fn>
+static void patch(const std::string& path, Fn&& fn) {
+    std::ifstream ifs(path, std::ios::binary);
+    std::vector<uint8_t> buf((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+    MeshCache::Header h;
+    std::memcpy(&h, buf.data(), sizeof h);
+    fn(h, buf.data());
+    h.checksum = MeshCache::checksum(buf.data() + sizeof h, buf.size() - sizeof h);
+    std::memcpy(buf.data(), &h, sizeof h);
+    std::ofstream ofs(path, std::ios::binary);
+    ofs.write(reinterpret_cast<const char*>(buf.data()), (std::streamsize)buf.size());
+}
+
+int main() {
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+    const std::string path = "mesh_cache_test.bin";
+    bool ok = true;
+
+    // Triangles with UVs
+    Mesh3D cs = make_cube_sphere(256, 1.0);
+    MeshCache::save(cs, path, 42);
+    {
+        MeshCache::MappedMesh mm;
+        bool opened = mm.open(path, 42);
+        bool match = opened && same(cs, mm.to_mesh());
+        bool aligned = opened && ((uintptr_t)mm.x() % 64 == 0) && ((uintptr_t)mm.u() % 64 == 0)
+                       && ((uintptr_t)mm.indices() % 64 == 0);
+        std::cout << "cube-sphere round trip: " << (match ? "ok" : "FAIL")
+                  << ", sections 64-byte aligned: " << (aligned ? "yes" : "NO") << "\n";
+        ok &= match && aligned;
+        ok &= !mm.open(path, 43);
+        std::cout << "wrong key rejected: " << (mm.is_open() ? "NO" : "yes") << "\n";
+    }
+
+    // Quads, colors and a pentagon: face offsets get written
+    Mesh3D mixed = make_cube_grid(4, 4);
+    for (const auto& p : mixed.vertices) mixed.colors.push_back(Point3D(p.x, p.y, 0.5));
+    mixed.add_face({0, 1, 2, 3, 4});
+    MeshCache::save(mixed, path);
+    {
+        MeshCache::MappedMesh mm;
+        bool match = mm.open(path) && same(mixed, mm.to_mesh());
+        std::cout << "mixed polygons round trip: " << (match ? "ok" : "FAIL") << "\n";
+        ok &= match;
+    }
+
+    // A flipped bit in the payload fails the checksum; a newer version is ignored
+    MeshCache::save(cs, path, 42);
+    flip_byte(path, 5000);
+    {
+        MeshCache::MappedMesh mm;
+        bool rejected = !mm.open(path, 42);
+        bool loadedUnverified = mm.open(path, 42, false);
+        std::cout << "corrupt payload rejected: " << (rejected ? "yes" : "NO")
+                  << " (opens without verify: " << (loadedUnverified ? "yes" : "no") << ")\n";
+        ok &= rejected && loadedUnverified;
+    }
+    MeshCache::save(cs, path, 42);
+    flip_byte(path, 4);
+    {
+        MeshCache::MappedMesh mm;
+        bool rejected = !mm.open(path, 42, false);
+        std::cout << "other version rejected: " << (rejected ? "yes" : "NO") << "\n";
+        ok &= rejected;
+    }
+
+    // Malformed files with a valid checksum: every section, face offset and
+    // vertex index is range-checked before open() hands out pointers
+    using H = MeshCache::Header;
+    struct Case { const char* what; const Mesh3D* mesh; std::function<void(H&, uint8_t*)> edit; };
+    auto u32 = [](uint8_t* d, uint64_t off) { return reinterpret_cast<uint32_t*>(d + off); };
+    std::vector<Case> cases = {
+        { "positions past the end",   &cs,    [](H& h, uint8_t*) { h.posOffset = h.fileSize; } },
+        { "huge vertex count",        &cs,    [](H& h, uint8_t*) { h.vertexCount = 1ull << 62; } },
+        { "uv inside the header",     &cs,    [](H& h, uint8_t*) { h.uvOffset = 64; } },
+        { "uvs without the uv flag",  &cs,    [](H& h, uint8_t*) { h.flags &= ~MeshCache::kHasUV; } },
+        { "colors past the end",      &mixed, [](H& h, uint8_t*) { h.colorOffset = h.fileSize - 64; } },
+        { "indices past the end",     &cs,    [](H& h, uint8_t*) { h.indexCount += 3000000; h.faceCount += 1000000; } },
+        { "face count past indices",  &cs,    [](H& h, uint8_t*) { h.faceCount += 1; } },
+        { "face offsets past the end",&mixed, [](H& h, uint8_t*) { h.faceCount = h.fileSize; } },
+        { "face offset out of range", &mixed, [&](H& h, uint8_t* d) { u32(d, h.faceOffset)[2] = (uint32_t)h.indexCount + 5; } },
+        { "face offsets going back",  &mixed, [&](H& h, uint8_t* d) { u32(d, h.faceOffset)[2] = 1; } },
+        { "vertex index out of range",&mixed, [&](H& h, uint8_t* d) { u32(d, h.indexOffset)[7] = (uint32_t)h.vertexCount; } },
+        { "vertex index out of range, triangles", &cs, [&](H& h, uint8_t* d) { u32(d, h.indexOffset)[h.indexCount - 1] = ~0u; } },
+    };
+    int accepted = 0;
+    for (const auto& c : cases) {
+        MeshCache::save(*c.mesh, path, 42);
+        patch(path, c.edit);
+        MeshCache::MappedMesh mm;
+        bool rejected = !mm.open(path, 42) && !mm.open(path, 42, false);
+        if (!rejected) { std::cout << "malformed file accepted: " << c.what << "\n"; ++accepted; }
+    }
+    MeshCache::save(mixed, path, 42);
+    patch(path, [](H&, uint8_t*) {});
+    {
+        MeshCache::MappedMesh mm;
+        bool intact = mm.open(path, 42) && same(mixed, mm.to_mesh());
+        std::cout << cases.size() << " malformed files, " << accepted << " accepted; re-checksummed intact file opens: "
+                  << (intact ? "yes" : "NO") << "\n";
+        ok &= accepted == 0 && intact;
+    }
+
+    // load_or_build: first call builds and writes, second maps the file
+    std::remove(path.c_str());
+    int builds = 0;
+    auto build = [&] { ++builds; return make_icosphere(8, 1.0); };
+    auto t0 = std::chrono::steady_clock::now();
+    Mesh3D a = MeshCache::load_or_build(path, 8, build);
+    auto t1 = std::chrono::steady_clock::now();
+    Mesh3D b = MeshCache::load_or_build(path, 8, build);
+    auto t2 = std::chrono::steady_clock::now();
+    MeshCache::MappedMesh mm;
+    mm.open(path, 8);
+    auto t3 = std::chrono::steady_clock::now();
+    std::cout << "icosphere(8) " << a.faces.size() << " faces: build+save " << ms(t0,t1)
+              << " ms, load to Mesh3D " << ms(t1,t2) << " ms, map+verify only " << ms(t2,t3)
+              << " ms, builds " << builds << ", same " << (same(a, b) ? "yes" : "NO") << "\n";
+    ok &= builds == 1 && same(a, b);
+    mm.close();
+    std::remove(path.c_str());
+
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
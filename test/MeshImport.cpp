@@ -0,0 +1,163 @@
+#include "MeshImport.hpp"
+#include "MeshBuilders.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static bool near(const Point3D& a, const Point3D& b) { return (a - b).length() < 1e-5; }
+
+// Same faces (by corner position and UV) in the same order
+static bool same_geometry(const Mesh3D& a, const Mesh3D& b) {
+    if (a.faces.size() != b.faces.size() || a.uv.empty() != b.uv.empty() || a.colors.empty() != b.colors.empty())
+        return false;
+    for (size_t f=0; f<a.faces.size(); ++f) {
+        const auto& fa = a.faces[f].indices;
+        const auto& fb = b.faces[f].indices;
+        if (fa.size() != fb.size()) return false;
+        for (size_t k=0; k<fa.size(); ++k) {
+            if (!near(a.vertices[fa[k]], b.vertices[fb[k]])) return false;
+            if (!a.uv.empty() && (std::fabs(a.uv[fa[k]].x - b.uv[fb[k]].x) > 1e-5 || std::fabs(a.uv[fa[k]].y - b.uv[fb[k]].y) > 1e-5))
+                return false;
+            if (!a.colors.empty() && !near(a.colors[fa[k]], b.colors[fb[k]])) return false;
+        }
+    }
+    return true;
+}
+
+// OBJ with positions and UVs written separately, so shared positions
+// come back together and v/vt pairs are deduplicated on import
+static void write_obj(const Mesh3D& m, const std::string& path) {
+    std::ofstream o(path);
+    o.precision(9);
+    for (const auto& v : m.vertices) o << "v " << v.x << ' ' << v.y << ' ' << v.z << '\n';
+    for (const auto& t : m.uv) o << "vt " << t.x << ' ' << t.y << '\n';
+    for (const auto& f : m.faces) {
+        o << 'f';
+        for (int i : f.indices) {
+            o << ' ' << i + 1;
+            if (!m.uv.empty()) o << '/' << i + 1;
+        }
+        o << '\n';
+    }
+}
+
+static void write_ply(const Mesh3D& m, const std::string& path, const char* format) {
+    std::ofstream o(path, std::ios::binary);
+    o << "ply\nformat " << format << " 1.0\ncomment test\nelement vertex " << m.vertices.size()
+      << "\nproperty float x\nproperty float y\nproperty float z\nproperty uchar red\nproperty uchar green\nproperty uchar blue\n"
+      << "element face " << m.faces.size() << "\nproperty list uchar int vertex_indices\n"
+      << "element edge 1\nproperty int vertex1\nproperty int vertex2\nend_header\n";
+    const bool ascii = std::string(format) == "ascii";
+    const bool big = std::string(format) == "binary_big_endian";
+    auto put = [&](const void* p, size_t n) {
+        const char* c = static_cast<const char*>(p);
+        for (size_t i=0; i<n; ++i) o.put(big ? c[n - 1 - i] : c[i]);
+    };
+    auto c8 = [](double c) { return (unsigned char)std::lround(c * 255.0); };
+    for (size_t i=0; i<m.vertices.size(); ++i) {
+        float xyz[3] = { (float)m.vertices[i].x, (float)m.vertices[i].y, (float)m.vertices[i].z };
+        unsigned char rgb[3] = { c8(m.colors[i].x), c8(m.colors[i].y), c8(m.colors[i].z) };
+        if (ascii) o << xyz[0] << ' ' << xyz[1] << ' ' << xyz[2] << ' ' << (int)rgb[0] << ' ' << (int)rgb[1] << ' ' << (int)rgb[2] << '\n';
+        else { for (float v : xyz) put(&v, 4); for (unsigned char c : rgb) put(&c, 1); }
+    }
+    for (const auto& f : m.faces) {
+        unsigned char n = (unsigned char)f.indices.size();
+        if (ascii) {
+            o << (int)n;
+            for (int i : f.indices) o << ' ' << i;
+            o << '\n';
+        } else {
+            put(&n, 1);
+            for (int i : f.indices) put(&i, 4);
+        }
+    }
+    int edge[2] = { 0, 1 };
+    if (ascii) o << "0 1\n"; else { put(&edge[0], 4); put(&edge[1], 4); }
+}
+
+static bool throws(const std::string& path) {
+    try { MeshImport::load_mesh(path); } catch (const std::runtime_error&) { return true; }
+    return false;
+}
+
+int main() {
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+    bool ok = true;
+    auto check = [&](const char* what, bool pass) { std::cout << what << ": " << (pass ? "ok" : "FAIL") << "\n"; ok &= pass; };
+
+    // OBJ round trip: cube-sphere positions and UVs
+    Mesh3D cs = make_cube_sphere(32, 1.0);
+    write_obj(cs, "import_test.obj");
+    Mesh3D a = MeshImport::load_obj("import_test.obj", 3);
+    check("OBJ cube-sphere round trip", same_geometry(cs, a) && a.vertices.size() == cs.vertices.size());
+
+    // Small hand-written OBJ: relative indices, a quad, vertex colors,
+    // CRLF, comments and a normal split
+    {
+        std::ofstream o("import_test.obj", std::ios::binary);
+        o << "# quad\r\nmtllib x.mtl\r\no quad\r\n"
+             "v 0 0 0 1 0 0\r\nv 1 0 0 0 1 0\r\nv 1 1 0 0 0 1\r\nv 0 1 0\r\n"
+             "vt 0 0\r\nvt 1 0\r\nvt 1 1\r\nvt 0 1\r\nvn 0 0 1\r\nvn 0 0 -1\r\n"
+             "s off\r\nf -4/-4/-1 -3/-3/-1 -2/-2/-1 -1/-1/-1\r\n"
+             "f 1/1/1 3/3/1 2/2/1\r\n"
+             "f 1//1 2//1 3//1\n";
+    }
+    Mesh3D q = MeshImport::load_obj("import_test.obj");
+    check("OBJ relative indices, colors, normal split",
+          q.faces.size() == 3 && q.faces[0].indices.size() == 4 && q.vertices.size() == 10
+          && q.uv.size() == 10 && q.colors.size() == 10
+          && near(q.colors[q.faces[0].indices[1]], Point3D(0,1,0)) && near(q.colors[q.faces[0].indices[3]], Point3D(1,1,1))
+          && q.faces[0].indices[0] != q.faces[1].indices[0]);
+
+    // PLY in all three formats, with colors and an extra element
+    Mesh3D cg = make_cube_grid(6, 5);
+    for (const auto& p : cg.vertices) cg.colors.push_back(Point3D(std::fmod(std::fabs(p.x), 1.0), 0.5, 0.25));
+    for (const char* fmt : { "ascii", "binary_little_endian", "binary_big_endian" }) {
+        write_ply(cg, "import_test.ply", fmt);
+        Mesh3D p = MeshImport::load_ply("import_test.ply", 2);
+        bool same = p.vertices.size() == cg.vertices.size() && p.faces.size() == cg.faces.size();
+        for (size_t i=0; same && i<cg.vertices.size(); ++i)
+            same = near(p.vertices[i], cg.vertices[i]) && (p.colors[i] - cg.colors[i]).length() < 0.005;
+        for (size_t f=0; same && f<cg.faces.size(); ++f) same = p.faces[f].indices == cg.faces[f].indices;
+        check((std::string("PLY ") + fmt).c_str(), same);
+    }
+
+    // Errors
+    { std::ofstream o("import_test.obj"); o << "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 4\n"; }
+    bool outOfRange = throws("import_test.obj");
+    { std::ofstream o("import_test.obj"); o << "v 0 0 x\n"; }
+    check("OBJ bad index / bad number rejected", outOfRange && throws("import_test.obj"));
+    { std::ofstream o("import_test.ply"); o << "ply\nformat ascii 1.0\nelement vertex 3\nproperty float x\nproperty float y\nproperty float z\nend_header\n0 0 0\n1 0 0\n"; }
+    check("PLY truncated rejected", throws("import_test.ply") && throws("missing.obj"));
+
+    // Throughput: a ~1.3M-triangle icosphere with UVs
+    Mesh3D big = make_icosphere(8, 1.0);
+    for (const auto& v : big.vertices) big.uv.push_back(Point2D(0.5 + 0.5 * v.x, 0.5 + 0.5 * v.y));
+    write_obj(big, "import_test.obj");
+    std::ifstream sz("import_test.obj", std::ios::binary | std::ios::ate);
+    double mb = sz.tellg() / 1048576.0;
+    for (int threads : { 1, 0 }) {
+        auto t0 = std::chrono::steady_clock::now();
+        Mesh3D m = MeshImport::load_obj("import_test.obj", threads);
+        auto t1 = std::chrono::steady_clock::now();
+        std::cout << "OBJ " << mb << " MB, " << m.faces.size() << " faces, threads " << threads << ": "
+                  << ms(t0,t1) << " ms, " << mb / (ms(t0,t1) / 1000.0) << " MB/s\n";
+        ok &= same_geometry(big, m);
+    }
+    big.colors.assign(big.vertices.size(), Point3D(0.2, 0.4, 0.6));
+    write_ply(big, "import_test.ply", "binary_little_endian");
+    std::ifstream psz("import_test.ply", std::ios::binary | std::ios::ate);
+    mb = psz.tellg() / 1048576.0;
+    auto t0 = std::chrono::steady_clock::now();
+    Mesh3D p = MeshImport::load_ply("import_test.ply");
+    auto t1 = std::chrono::steady_clock::now();
+    std::cout << "binary PLY " << mb << " MB: " << ms(t0,t1) << " ms, " << mb / (ms(t0,t1) / 1000.0) << " MB/s\n";
+    ok &= p.faces.size() == big.faces.size();
+
+    std::remove("import_test.obj");
+    std::remove("import_test.ply");
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+#include "MeshLOD.hpp"
+#include <iostream>
+#include <random>
+
+int main() {
+    bool ok = true;
+
+    // Chains: error grows and triangles shrink level by level
+    LODChain chains[3] = { make_uv_sphere_lods(32, 48), make_icosphere_lods(5), make_cube_sphere_lods(32) };
+    const char* names[3] = { "uv-sphere", "icosphere", "cube-sphere" };
+    for (int c=0; c<3; ++c) {
+        std::cout << names[c] << ":";
+        bool monotone = true;
+        for (size_t k=0; k<chains[c].levels.size(); ++k) {
+            const auto& l = chains[c].levels[k];
+            std::cout << " " << l.triangles << " (" << l.error << ")";
+            if (k && (l.error < chains[c].levels[k-1].error || l.triangles > chains[c].levels[k-1].triangles))
+                monotone = false;
+        }
+        std::cout << (monotone ? "" : "  NOT MONOTONE") << "\n";
+        ok &= monotone && chains[c].levels.size() > 1;
+    }
+
+    // A field of spheres from 3 to 300 units away, 1024 px tall viewport
+    View3DParameters params(Point3D(0,2,-5), Point3D(0,0,50), Point3D(0,1,0),
+                            60.0*M_PI/180.0, 1.0, 0.1, 1000.0);
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> U(0.0, 1.0);
+    std::vector<Point3D> centers;
+    for (int i=0; i<500; ++i) {
+        double z = 3.0 + 297.0 * U(rng) * U(rng);
+        centers.push_back(Point3D((U(rng) - 0.5) * z, (U(rng) - 0.5) * 0.5 * z, z));
+    }
+    for (int c=0; c<3; ++c) {
+        LODSelector sel(params, 1024);
+        std::vector<int> state(centers.size(), -1);
+        for (size_t i=0; i<centers.size(); ++i) sel.select(chains[c], centers[i], 1.0, state[i]);
+        std::cout << names[c] << ": " << sel.triangles << " triangles vs "
+                  << centers.size() * chains[c].levels[0].triangles << " at full detail; per level";
+        for (int n : sel.perLevel) std::cout << " " << n;
+        std::cout << "\n";
+        ok &= sel.triangles < centers.size() * chains[c].levels[0].triangles;
+    }
+
+    // Hysteresis: jitter a sphere around a switch distance
+    const LODChain& ico = chains[1];
+    LODSelector sel(params, 1024);
+    LODSelector raw(params, 1024, 0.5, 0.0);
+    double zSwitch = ico.radius * 0.5 * 1024 / std::tan(params.fov / 2) * ico.levels[2].error / sel.tolerancePx;
+    int a = -1, b = -1, prevA = -1, prevB = -1, popsA = 0, popsB = 0;
+    for (int f=0; f<200; ++f) {
+        double z = zSwitch * (1.0 + 0.05 * std::sin(f * 0.7));
+        Point3D c(0, 2, z - 5);                     // straight ahead of the eye
+        sel.select(ico, c, 1.0, a);
+        raw.select(ico, c, 1.0, b);
+        if (f && a != prevA) ++popsA;
+        if (f && b != prevB) ++popsB;
+        prevA = a; prevB = b;
+    }
+    std::cout << "level switches over 200 jittering frames: " << popsA
+              << " with hysteresis, " << popsB << " without\n";
+    ok &= popsA == 0 && popsB > 0;
+
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
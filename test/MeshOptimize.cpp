@@ -0,0 +1,84 @@
+#include "MeshOptimize.hpp"
+#include "MeshBuilders.hpp"
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <set>
+#include <tuple>
+
+// Sorted corner positions of every face: the surface, whatever the order
+static std::multiset<std::vector<std::tuple<double,double,double>>> surface(const Mesh3D& m) {
+    std::multiset<std::vector<std::tuple<double,double,double>>> s;
+    for (const auto& f : m.faces) {
+        std::vector<std::tuple<double,double,double>> c;
+        for (int v : f.indices) c.emplace_back(m.vertices[v].x, m.vertices[v].y, m.vertices[v].z);
+        std::rotate(c.begin(), std::min_element(c.begin(), c.end()), c.end());   // keep winding
+        s.insert(c);
+    }
+    return s;
+}
+
+int main() {
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+    bool ok = true;
+
+    // Cube-sphere: the six faces duplicate their shared edges. With UVs the
+    // copies sit on a UV seam and stay; without UVs they weld into a closed
+    // sphere with 6n^2+2 vertices.
+    const int n = 64;
+    Mesh3D cs = make_cube_sphere(n, 1.0);
+    Mesh3D seams = cs;
+    MeshOptimizeReport w = weld_vertices(seams, 1e-9);
+    std::cout << "with UVs   " << w << "\n";
+
+    Mesh3D plain = cs;
+    plain.uv.clear();
+    auto before = surface(plain);
+    auto t0 = std::chrono::steady_clock::now();
+    w = weld_vertices(plain, 1e-9);
+    auto t1 = std::chrono::steady_clock::now();
+    MeshOptimizeReport c = optimize_vertex_cache(plain);
+    auto t2 = std::chrono::steady_clock::now();
+    MeshOptimizeReport f = optimize_vertex_fetch(plain);
+    auto t3 = std::chrono::steady_clock::now();
+    std::cout << "without UVs " << w << " (" << ms(t0,t1) << " ms)\n"
+              << "            " << c << " (" << ms(t1,t2) << " ms)\n"
+              << "            " << f << " (" << ms(t2,t3) << " ms)\n";
+    bool sphereOk = w.verticesAfter == (size_t)6*n*n + 2 && seams.vertices.size() > w.verticesAfter
+                 && c.acmrAfter < 0.75 && c.acmrAfter < c.acmrBefore && f.acmrAfter == c.acmrAfter
+                 && surface(plain) == before;
+    ok &= sphereOk;
+
+    // Fetch order: each face's new vertices are the next unused indices
+    int high = -1;
+    bool firstUse = true;
+    for (const auto& face : plain.faces)
+        for (int v : face.indices) {
+            if (v > high + 1) firstUse = false;
+            high = std::max(high, v);
+        }
+    std::cout << "surface unchanged: " << (surface(plain) == before ? "yes" : "NO")
+              << ", vertices in first-use order: " << (firstUse ? "yes" : "NO") << "\n";
+    ok &= firstUse;
+
+    // Color seams survive a loose tolerance; quads stay quads
+    Mesh3D grid = make_cube_grid(8, 8);
+    grid.colors.resize(grid.vertices.size());
+    for (size_t i=0; i<grid.vertices.size(); ++i) grid.colors[i] = Point3D((i / 8) % 2, 0.5, 0.5);
+    grid.uv.clear();
+    MeshOptimizeReport g = weld_vertices(grid, 1e-6);
+    std::map<std::tuple<double,double,double>,int> positions;
+    for (const auto& p : grid.vertices) ++positions[std::make_tuple(p.x, p.y, p.z)];
+    int split = 0;
+    for (const auto& kv : positions) split += kv.second > 1;
+    std::cout << "cube grid   " << g << ", " << positions.size() << " positions, " << split << " on color seams\n";
+    ok &= split > 0 && g.verticesAfter == positions.size() + split;     // at most two colors meet
+
+    // Icosphere, built level by level: far from cache order
+    Mesh3D ico = make_icosphere(6, 1.0);
+    std::cout << "icosphere   " << optimize_vertex_cache(ico) << "\n";
+    std::cout << "            " << optimize_vertex_fetch(ico) << "\n";
+
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,125 @@
+#include "MeshSimplify.hpp"
+#include "MeshBuilders.hpp"
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+
+// Edges by position: how many faces use each, and the Euler characteristic
+static void topology(const Mesh3D& m, int& open, int& nonManifold, long& euler) {
+    std::map<std::tuple<double,double,double>,int> ids;
+    std::vector<int> id(m.vertices.size());
+    for (size_t v=0; v<m.vertices.size(); ++v)
+        id[v] = ids.emplace(std::make_tuple(m.vertices[v].x, m.vertices[v].y, m.vertices[v].z), (int)ids.size()).first->second;
+    std::map<std::pair<int,int>,int> edges;
+    for (const auto& f : m.faces)
+        for (size_t k=0; k<f.indices.size(); ++k) {
+            int a = id[f.indices[k]], b = id[f.indices[(k+1) % f.indices.size()]];
+            ++edges[{ std::min(a,b), std::max(a,b) }];
+        }
+    open = nonManifold = 0;
+    for (const auto& e : edges) { open += e.second == 1; nonManifold += e.second > 2; }
+    euler = (long)ids.size() - (long)edges.size() + (long)m.faces.size();
+}
+
+// Gap between face planes and the sphere of radius r: "max / mean"
+static std::string sphere_gap(const Mesh3D& m, double r, double* maxGap = nullptr) {
+    double worst = 0.0, sum = 0.0;
+    for (const auto& f : m.faces) {
+        Point3D n = m.face_normal(f).normalized();
+        double g = r - std::fabs(n.dot(m.vertices[f.indices[0]]));
+        worst = std::max(worst, g);
+        sum += g;
+    }
+    if (maxGap) *maxGap = worst;
+    return std::to_string(worst) + " / " + std::to_string(sum / std::max<size_t>(1, m.faces.size()));
+}
+
+int main() {
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+    int open, bad; long euler;
+    bool ok = true;
+
+    // 1.3M-triangle icosphere down to 1%
+    Mesh3D ico = make_icosphere(8, 1.0);
+    auto t0 = std::chrono::steady_clock::now();
+    double err = 0.0;
+    Mesh3D low = simplify_mesh(ico, ico.faces.size() / 100, HUGE_VAL, &err);
+    auto t1 = std::chrono::steady_clock::now();
+    topology(low, open, bad, euler);
+    double gap;
+    std::string gaps = sphere_gap(low, 1.0, &gap);
+    std::cout << "icosphere " << ico.faces.size() << " -> " << low.faces.size() << " faces in " << ms(t0,t1)
+              << " ms; open " << open << ", non-manifold " << bad << ", euler " << euler
+              << ", sphere gap max/mean " << gaps << " (uniform 20480-face icosphere "
+              << sphere_gap(make_icosphere(5), 1.0) << "), error " << err << "\n";
+    // The error is an RMS vertex-to-plane figure and does not bound how far
+    // a large face sags inside the sphere; the gap bound is a regression
+    // check at about twice today's 0.027
+    ok &= open == 0 && bad == 0 && euler == 2 && gap < 0.05;
+
+    // Cube-sphere: the six faces meet on UV seams, which must not open
+    Mesh3D cs = make_cube_sphere(64, 1.0);
+    Mesh3D csLow = simplify_mesh(cs, 2000);
+    topology(cs, open, bad, euler);
+    std::cout << "cube-sphere before: open " << open << ", euler " << euler << "\n";
+    ok &= open == 0 && euler == 2;
+    topology(csLow, open, bad, euler);
+    std::map<std::tuple<double,double,double,double,double>,int> attrs;
+    for (size_t v=0; v<cs.vertices.size(); ++v)
+        attrs[std::make_tuple(cs.vertices[v].x, cs.vertices[v].y, cs.vertices[v].z, cs.uv[v].x, cs.uv[v].y)] = 1;
+    int lost = 0;
+    for (size_t v=0; v<csLow.vertices.size(); ++v)
+        lost += !attrs.count(std::make_tuple(csLow.vertices[v].x, csLow.vertices[v].y, csLow.vertices[v].z,
+                                             csLow.uv[v].x, csLow.uv[v].y));
+    std::cout << "cube-sphere " << cs.faces.size() << " -> " << csLow.faces.size() << " faces; open "
+              << open << ", non-manifold " << bad << ", euler " << euler
+              << ", vertices with attributes not from the input " << lost << "\n";
+    ok &= open == 0 && bad == 0 && euler == 2 && lost == 0 && csLow.faces.size() <= 2000;
+
+    // Open bumpy sheet: the rectangular border stays put
+    Mesh3D sheet;
+    const int S = 200;
+    for (int j=0; j<=S; ++j)
+        for (int i=0; i<=S; ++i)
+            sheet.add_vertex(Point3D(i, 3.0 * std::sin(i * 0.05) * std::cos(j * 0.04), j));
+    for (int j=0; j<S; ++j)
+        for (int i=0; i<S; ++i) {
+            int v = j * (S+1) + i;
+            sheet.add_face({ v, v + S + 1, v + S + 2 });
+            sheet.add_face({ v, v + S + 2, v + 1 });
+        }
+    Mesh3D sheetLow = simplify_mesh(sheet, 4000);
+    topology(sheetLow, open, bad, euler);
+    // Every border edge left must run along the rectangle
+    int off = 0;
+    std::map<std::pair<int,int>,int> edges;
+    for (const auto& f : sheetLow.faces)
+        for (int k=0; k<3; ++k) {
+            int a = f.indices[k], b = f.indices[(k+1)%3];
+            ++edges[{ std::min(a,b), std::max(a,b) }];
+        }
+    double borderLen = 0.0;
+    for (const auto& e : edges) {
+        if (e.second != 1) continue;
+        const Point3D &a = sheetLow.vertices[e.first.first], &b = sheetLow.vertices[e.first.second];
+        bool side = (a.x == 0 && b.x == 0) || (a.x == S && b.x == S) || (a.z == 0 && b.z == 0) || (a.z == S && b.z == S);
+        off += !side;
+        borderLen += std::hypot(a.x - b.x, a.z - b.z);
+    }
+    std::cout << "sheet " << sheet.faces.size() << " -> " << sheetLow.faces.size() << " faces; border edges off the rectangle "
+              << off << ", border length " << borderLen << " (expect " << 4 * S << "), non-manifold " << bad << "\n";
+    ok &= off == 0 && std::fabs(borderLen - 4 * S) < 1e-9 && bad == 0;
+
+    // Error bound instead of a face count
+    for (double tol : { 1e-4, 1e-3, 1e-2 }) {
+        Mesh3D m = simplify_mesh(ico, 0, tol, &err);
+        std::cout << "max error " << tol << ": " << m.faces.size() << " faces, largest collapse " << err
+                  << ", sphere gap max/mean " << sphere_gap(m, 1.0) << "\n";
+        ok &= err <= tol && m.faces.size() < ico.faces.size();
+    }
+
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+#include "Drawing2D.hpp"
+#include "PathRasterizer.hpp"
+#include "RasterBuffer.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+static double coverage_sum(const RasterBuffer<uint8_t>& rb) {
+    double s = 0.0;
+    for (uint8_t v : rb.data) s += v / 255.0;
+    return s;
+}
+
+static std::vector<Point2D> ngon(Point2D c, double r, int n) {
+    std::vector<Point2D> pts;
+    for (int k=0; k<n; ++k) {
+        double t = 2.0 * M_PI * k / n;
+        pts.emplace_back(c.x + r * std::cos(t), c.y + r * std::sin(t));
+    }
+    return pts;
+}
+
+int main() {
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+    bool ok = true;
+    // Total coverage within a pixel of the exact area (8-bit rounding)
+    auto check = [&](const char* what, double got, double expect) {
+        bool pass = std::fabs(got - expect) < 1.0;
+        std::cout << what << " coverage " << got << " vs " << expect << (pass ? "" : "  FAIL") << "\n";
+        ok &= pass;
+    };
+
+    // Filled disc at a sub-pixel offset: total coverage is its area
+    RasterBuffer<uint8_t> rb(128,128,1,0,false);
+    Drawing2D d(rb);
+    const double r = 40.0;
+    d.fill_path_aa(ngon(Point2D(64.3,63.7), r, 512));
+    double area = 0.5 * 512 * r * r * std::sin(2.0 * M_PI / 512);
+    check("disc", coverage_sum(rb), area);
+
+    // Partly off-screen: the clipped parts still count inside
+    std::fill(rb.data.begin(), rb.data.end(), 0);
+    d.fill_path_aa({ Point2D(-20,10), Point2D(50,10), Point2D(50,30), Point2D(-20,30) });
+    check("clipped rect", coverage_sum(rb), 1000.0);
+
+    // Strokes cover width x length, plus half a width per square cap
+    std::fill(rb.data.begin(), rb.data.end(), 0);
+    d.line_aa(Point2D(10.5,20), Point2D(110.5,20), 4.0);
+    check("4px line", coverage_sum(rb), 400.0);
+    std::fill(rb.data.begin(), rb.data.end(), 0);
+    d.line_aa(Point2D(10.5,20), Point2D(110.5,20), 4.0, 255, LineCap::Square);
+    check("square caps", coverage_sum(rb), 416.0);
+
+    // Holes: an inner square wound against the outer one cuts it out under
+    // the non-zero rule; wound the same way it adds to it
+    std::vector<Point2D> outer = { Point2D(20,20), Point2D(100,20), Point2D(100,100), Point2D(20,100) };
+    std::vector<Point2D> inner = { Point2D(40,40), Point2D(80,40), Point2D(80,80), Point2D(40,80) };
+    std::vector<Point2D> hole(inner.rbegin(), inner.rend());
+    PathRasterizer path;
+    for (int reversed=1; reversed>=0; --reversed) {
+        std::fill(rb.data.begin(), rb.data.end(), 0);
+        path.begin(rb.width, rb.height);
+        path.add_polygon(outer);
+        path.add_polygon(reversed ? hole : inner);
+        path.fill(rb, 255);
+        const uint8_t centre = rb.data[60*128 + 60], ring = rb.data[30*128 + 60];
+        bool pass = ring == 255 && centre == (reversed ? 0 : 255);
+        std::cout << (reversed ? "opposite" : "same") << "-wound inner square: centre " << (int)centre
+                  << ", ring " << (int)ring << (pass ? "" : "  FAIL") << "\n";
+        ok &= pass;
+        check(reversed ? "square with hole" : "square over square", coverage_sum(rb), reversed ? 4800.0 : 6400.0);
+    }
+
+    // Joins and caps on a zig-zag
+    RasterBuffer<uint8_t> out(320,120,3,0,false);
+    Drawing2D o(out);
+    std::vector<Point2D> zig = { Point2D(0,80), Point2D(30,20), Point2D(60,80), Point2D(90,30) };
+    const LineJoin joins[3] = { LineJoin::Miter, LineJoin::Bevel, LineJoin::Round };
+    const LineCap  caps[3]  = { LineCap::Butt, LineCap::Square, LineCap::Round };
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i=0; i<3; ++i) {
+        std::vector<Point2D> p;
+        for (const auto& q : zig) p.push_back(Point2D(q.x + 15 + i*105, q.y + 5));
+        o.polyline_aa(p, 10.0, 255, joins[i], caps[i]);
+        o.polyline_aa(p, 1.0, 80);
+    }
+    o.polyline_aa(ngon(Point2D(160,60), 50, 5), 3.0, 160, LineJoin::Miter, LineCap::Butt, true, 0.5);
+    auto t1 = std::chrono::steady_clock::now();
+    out.save_ppm("path_aa.ppm");
+    std::cout << "strokes: " << ms(t0,t1) << " ms\n";
+
+    // Many small paths: cost follows edges + touched pixels, not the target
+    RasterBuffer<uint8_t> big(1024,1024,1,0,false);
+    Drawing2D b(big);
+    auto t2 = std::chrono::steady_clock::now();
+    for (int i=0; i<2000; ++i) {
+        double x = 20 + (i * 37) % 980, y = 20 + (i * 91) % 980;
+        b.line_aa(Point2D(x,y), Point2D(x + 15, y + 7), 1.5);
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    std::cout << "2000 short AA lines on 1024^2: " << ms(t2,t3) << " ms\n";
+
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
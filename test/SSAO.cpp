@@ -0,0 +1,115 @@
+#include "MeshBuilders.hpp"
+#include "MeshRenderer2D.hpp"
+#include "SSAO.hpp"
+#include "View3DParameters.hpp"
+#include "RasterBuffer.hpp"
+#include <iostream>
+
+int main() {
+    View3DParameters params(Point3D(-4,6,-6), Point3D(3,0,3), Point3D(0,1,0),
+                            60.0*M_PI/180.0, 1.0, 0.1, 100.0);
+    View3D cam = params.make_view();
+    Projection3D proj = params.make_projection();
+
+    // Stepped cube grid on a floor: plenty of creases for contact shadows
+    Mesh3D grid = make_cube_grid_custom(8, 8, 1.0, 1.0, 1.0, 0.0,
+        [](int i, int j) { return Transformation3D::translation(0, 0.5*((i*3 + j) % 4), 0); });
+    int f0 = grid.add_vertex(Point3D(-6,-0.5,-6)), f1 = grid.add_vertex(Point3D(12,-0.5,-6));
+    int f2 = grid.add_vertex(Point3D(12,-0.5,12)), f3 = grid.add_vertex(Point3D(-6,-0.5,12));
+    grid.add_face({ f0, f1, f2, f3 });
+    Transformation3D V = cam.view_matrix();
+    for (auto& p : grid.vertices) p = V.apply(p);
+    auto vnorm = grid.compute_vertex_normals();
+
+    const int W = 512, H = 512;
+    RasterBuffer<uint8_t> rb(W,H,1,0,true);
+    MeshRenderer2D renderer(rb, cam, proj, Point3D(0.3,0.4,-1.0));
+    auto draw = [&] {
+        std::fill(rb.data.begin(), rb.data.end(), 0);
+        rb.clear_depth();
+        renderer.render(grid, vnorm, RenderMode::Flat);
+    };
+    draw();
+    rb.save_ppm("ssao_before.ppm");
+
+    SSAOPass ssao;
+    ssao.budgetMsPerMP = 40.0;
+    ssao.apply(rb, proj);
+    rb.save_ppm("ssao_after.ppm");
+
+    // AO at a world point, averaged over a 3x3 pixel neighbourhood
+    auto ao_at = [&](const Point3D& world) {
+        Point2D ndc = proj.project(V.apply(world));
+        int x = (int)((ndc.x + 1.0) * 0.5 * W), y = (int)((1.0 - ndc.y) * 0.5 * H);
+        double s = 0.0;
+        for (int dy=-1; dy<=1; ++dy)
+            for (int dx=-1; dx<=1; ++dx) s += ssao.ao[(size_t)(y+dy)*W + (x+dx)];
+        return s / 9.0;
+    };
+    bool ok = true;
+    auto check = [&](const char* what, double v, bool pass) {
+        std::cout << what << ": " << v << (pass ? "" : "  FAIL") << "\n";
+        ok &= pass;
+    };
+
+    double mean = 0.0; size_t covered = 0;
+    for (size_t i=0;i<ssao.ao.size();++i) {
+        if (rb.depth[i] >= 1e9) continue;
+        mean += ssao.ao[i]; ++covered;
+    }
+    mean /= std::max<size_t>(1, covered);
+    std::cout << "mean AO " << mean << "\n";
+
+    // Floor against the grid's -x and -z walls, and the top of cube (0,1)
+    // against the taller (0,2) behind it
+    check("floor contact, -x wall", ao_at(Point3D(-0.56,-0.5,4.0)), ao_at(Point3D(-0.56,-0.5,4.0)) < 0.8);
+    check("floor contact, -z wall", ao_at(Point3D(4.0,-0.5,-0.56)), ao_at(Point3D(4.0,-0.5,-0.56)) < 0.8);
+    check("step crease", ao_at(Point3D(0.0,1.0,1.46)), ao_at(Point3D(0.0,1.0,1.46)) < 0.8);
+    // Open floor and a cube top well away from anything taller
+    check("open floor", ao_at(Point3D(-3.0,-0.5,4.0)), ao_at(Point3D(-3.0,-0.5,4.0)) > 0.95);
+    check("open floor, near", ao_at(Point3D(2.0,-0.5,-3.0)), ao_at(Point3D(2.0,-0.5,-3.0)) > 0.95);
+
+    // Budget controller: the step count it picks for a measured frame time
+    // (wall time itself depends on the machine, so it is only reported)
+    {
+        SSAOPass c;
+        c.budgetMsPerMP = 40.0;
+        c.steps = 6;
+        bool pass = c.planned_steps(60.0) == 3          // over: 6 * 30/60
+                 && c.planned_steps(200.0) == c.minSteps  // far over: floor
+                 && c.planned_steps(34.0) == 6          // between aim and 0.85 budget: hold
+                 && c.planned_steps(20.0) == 7          // 20 * 7/6 < 30: one more
+                 && c.planned_steps(27.0) == 6;         // 27 * 7/6 > 30: hold
+        c.steps = c.maxSteps;
+        pass &= c.planned_steps(1.0) == c.maxSteps;
+        c.steps = c.minSteps;
+        pass &= c.planned_steps(500.0) == c.minSteps;
+        c.budgetMsPerMP = 0.0;
+        c.steps = 5;
+        pass &= c.planned_steps(500.0) == 5;            // no budget: fixed steps
+        check("controller decisions", pass, pass);
+    }
+
+    // Fresh image each frame; after every apply() the pass runs with the
+    // step count the controller planned from that frame's time
+    bool followed = true;
+    double best = 1e30;
+    for (int frame=0; frame<10; ++frame) {
+        draw();
+        ssao.apply(rb, proj);
+        followed &= ssao.steps >= ssao.minSteps && ssao.steps <= ssao.maxSteps;
+        best = std::min(best, ssao.lastMsPerMP);
+    }
+    SSAOPass probe;                                     // same settings, steps before the frame
+    probe.budgetMsPerMP = ssao.budgetMsPerMP;
+    probe.steps = ssao.steps;
+    draw();
+    ssao.apply(rb, proj);
+    followed &= ssao.steps == probe.planned_steps(ssao.lastMsPerMP);
+    check("steps follow the controller", followed, followed);
+    std::cout << "best " << best << " ms/MP against a budget of " << ssao.budgetMsPerMP
+              << " (not asserted), steps " << ssao.steps << "\n";
+
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include "MeshBuilders.hpp"
+#include "MeshRenderer2D.hpp"
+#include "ShadowMap.hpp"
+#include "View3DParameters.hpp"
+#include "RasterBuffer.hpp"
+#include <chrono>
+#include <iostream>
+
+static void append(Mesh3D& dst, const Mesh3D& src) {
+    int base = (int)dst.vertices.size();
+    dst.vertices.insert(dst.vertices.end(), src.vertices.begin(), src.vertices.end());
+    dst.uv.insert(dst.uv.end(), src.uv.begin(), src.uv.end());
+    dst.colors.insert(dst.colors.end(), src.colors.begin(), src.colors.end());
+    for (auto f : src.faces) {
+        for (int& i : f.indices) i += base;
+        dst.faces.push_back(f);
+    }
+}
+
+int main() {
+    View3DParameters params(Point3D(0,8,-12), Point3D(0,0,0), Point3D(0,1,0),
+                            60.0*M_PI/180.0, 1.0, 0.1, 100.0);
+    View3D cam = params.make_view();
+    Projection3D proj = params.make_projection();
+
+    // World: a floor slab with a 4x4 block of pillars on it
+    Mesh3D world = transform_mesh(make_cube(20, 0.2, 20, Point3D(0.8,0.8,0.8)),
+                                  Transformation3D::translation(0,-0.1,0));
+    Mesh3D pillars = make_cube_grid_custom(4, 4, 1.0, 1.0, 1.0, 1.0,
+        [](int i, int j) {
+            return Transformation3D::translation(-3.5, 0.5 + 0.5*(i+j)*0.5, -3.5) *
+                   Transformation3D::scaling(1.0, 1.0 + 0.5*(i+j), 1.0);
+        },
+        [](int i, int j) { return Point3D(0.9, 0.5 + 0.1*i, 0.3 + 0.1*j); });
+    append(world, pillars);
+
+    const Point3D sunWorld(0.5, 1.0, 0.3);
+
+    // Shadow pass: 3 cascades over the first 40 units of the view frustum
+    ShadowMap shadows(1024);
+    shadows.setup_cascades(params, sunWorld, 3, 40.0);
+    auto t0 = std::chrono::steady_clock::now();
+    shadows.render(world);
+    auto t1 = std::chrono::steady_clock::now();
+    shadows.set_camera(cam);
+
+    // Shaded pass in view space
+    Mesh3D view = transform_mesh(world, cam.view_matrix());
+    auto vnorm = view.compute_vertex_normals();
+    Point3D sunView = cam.view_matrix().apply(sunWorld) - cam.view_matrix().apply(Point3D(0,0,0));
+
+    RasterBuffer<uint8_t> rb(512,512,3,0,true);
+    MeshRenderer2D renderer(rb, cam, proj, sunView);
+    renderer.shadowMap = &shadows;
+
+    const char* names[] = { "shadow_flat.ppm", "shadow_gouraud.ppm", "shadow_phong.ppm" };
+    RenderMode modes[] = { RenderMode::Flat, RenderMode::Gouraud, RenderMode::Phong };
+    double shadedMs = 0.0;
+    for (int m=0;m<3;++m) {
+        rb.clear_depth(); rb.data.assign(rb.data.size(),0);
+        auto s0 = std::chrono::steady_clock::now();
+        renderer.render(view, vnorm, modes[m]);
+        auto s1 = std::chrono::steady_clock::now();
+        if (modes[m] == RenderMode::Phong) shadedMs = std::chrono::duration<double,std::milli>(s1-s0).count();
+        rb.save_ppm(names[m]);
+    }
+
+    double depthMs = std::chrono::duration<double,std::milli>(t1-t0).count();
+    std::cout << "depth-only (3 x 1024^2): " << depthMs << " ms, "
+              << "shaded Phong (512^2): " << shadedMs << " ms\n";
+
+    // A point on the floor right behind a pillar (away from the sun) is shadowed
+    Point3D behind = cam.view_matrix().apply(Point3D(-4.2, 0.0, -4.15));
+    Point3D upView = cam.view_matrix().apply(Point3D(0,1,0)) - cam.view_matrix().apply(Point3D(0,0,0));
+    std::cout << "visibility behind pillar: " << shadows.visibility(behind, upView)
+              << ", in the open: " << shadows.visibility(cam.view_matrix().apply(Point3D(6,0,6)), upView)
+              << "\n";
+    bool ok = shadows.visibility(behind, upView) < 0.5
+           && shadows.visibility(cam.view_matrix().apply(Point3D(6,0,6)), upView) > 0.5;
+
+    // A concave L-shaped roof casts an L: the notch a fan from its first
+    // corner would cover stays lit
+    Mesh3D roof;
+    const double pts[6][2] = { {2,-2}, {2,0}, {0,0}, {0,2}, {-2,2}, {-2,-2} };
+    for (const auto& p : pts) roof.add_vertex(Point3D(p[0], 2.0, p[1]));
+    roof.add_face({ 0, 1, 2, 3, 4, 5 });
+    ShadowMap roofShadow(512);
+    roofShadow.setup_directional(Point3D(0.05, 1.0, 0.02), Point3D(0,1,0), 4.0);
+    roofShadow.render(roof);
+    roofShadow.set_camera(cam);
+    double notch = roofShadow.visibility(cam.view_matrix().apply(Point3D(0.25, 0.0, 1.0)), upView);
+    double arm   = roofShadow.visibility(cam.view_matrix().apply(Point3D(-1.0, 0.0, -1.0)), upView);
+    std::cout << "L-shaped roof: visibility under the notch " << notch << ", under an arm " << arm << "\n";
+    ok &= notch == 1.0 && arm == 0.0;
+
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,136 @@
+#include "MeshBuilders.hpp"
+#include "MeshRenderer2D.hpp"
+#include "View3DParameters.hpp"
+#include "RasterBuffer.hpp"
+#include <chrono>
+#include <iostream>
+
+// Twice the signed area of a triangle seen along +z
+static double area2(const Point3D& a, const Point3D& b, const Point3D& c) {
+    return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+int main() {
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+    bool ok = true;
+
+    // Concave star: n-2 triangles, all wound like the face, areas add up
+    Mesh3D star;
+    std::vector<int> ring;
+    for (int i=0; i<10; ++i) {
+        double r = (i % 2) ? 0.4 : 1.0, a = i * M_PI / 5.0;
+        ring.push_back(star.add_vertex(Point3D(r * std::cos(a), r * std::sin(a), 0.0)));
+    }
+    std::rotate(ring.begin(), ring.begin() + 1, ring.end());     // start on a reflex corner
+    star.add_face(ring);
+    const Triangulation& T = star.triangulation();
+    double polyArea = 0.0, triArea = 0.0, minArea = 1e30;
+    for (size_t i=0; i<ring.size(); ++i)
+        polyArea += area2(Point3D(0,0,0), star.vertices[ring[i]], star.vertices[ring[(i+1) % ring.size()]]);
+    for (const auto& t : T.tris) {
+        double a = area2(star.vertices[t[0]], star.vertices[t[1]], star.vertices[t[2]]);
+        triArea += a;
+        minArea = std::min(minArea, a);
+    }
+    bool starOk = T.tris.size() == 8 && minArea > 0 && std::fabs(triArea - polyArea) < 1e-9;
+    std::cout << "star: " << T.tris.size() << " triangles, area " << triArea / 2 << " of " << polyArea / 2
+              << ", smallest " << minArea / 2 << (starOk ? "" : "  FAIL") << "\n";
+    ok &= starOk;
+
+    // Cached until the generation changes. The cache holds topology only:
+    // moving vertices keeps it, editing a face in place (same counts, which
+    // the cache used to be keyed on) and invalidating rebuilds it.
+    const void* before = T.tris.data();
+    uint64_t gen = star.generation();
+    for (auto& v : star.vertices) v = v * 2.0;
+    bool kept = star.triangulation().tris.data() == before && star.generation() == gen;
+    std::reverse(star.faces[0].indices.begin(), star.faces[0].indices.end());
+    star.invalidate_triangulation();
+    const auto& t0 = star.triangulation().tris[0];
+    bool flipped = star.generation() != gen
+                && area2(star.vertices[t0[0]], star.vertices[t0[1]], star.vertices[t0[2]]) < 0;
+    star.add_face({ 0, 2, 4 });
+    bool added = star.triangulation().tris.size() == 9 && star.triangulation().face.back() == 1;
+    std::cout << "cache kept after moving vertices: " << (kept ? "yes" : "NO")
+              << ", face edited in place: " << (flipped ? "rebuilt" : "STALE")
+              << ", add_face: " << (added ? "rebuilt" : "STALE") << "\n";
+    ok &= kept && flipped && added;
+
+    // An L-shaped hexagon drawn with a fan from its first corner would
+    // spill into the notch; ear clipping covers exactly the L
+    View3DParameters params(Point3D(0,0,0), Point3D(0,0,1), Point3D(0,1,0),
+                            60.0*M_PI/180.0, 1.0, 0.1, 100.0);
+    View3D cam = params.make_view();
+    Projection3D proj = params.make_projection();
+    Mesh3D L;
+    const double pts[6][2] = { {2,0}, {2,1}, {1,1}, {1,2}, {0,2}, {0,0} };
+    for (const auto& p : pts) L.add_vertex(Point3D(p[0] - 1.0, p[1] - 1.0, 5.0));
+    L.add_face({ 0, 5, 4, 3, 2, 1 });               // clockwise on screen: faces the camera
+    RasterBuffer<uint8_t> rb(256,256,3,0,true);
+    MeshRenderer2D r(rb, cam, proj);
+    r.render(L, L.compute_vertex_normals(), RenderMode::Flat);
+    size_t covered = 0;
+    for (double d : rb.depth) covered += d < 1e9;
+    const double pxPerUnit = 128.0 / std::tan(M_PI / 6.0) / 5.0;
+    const double expect = 3.0 * pxPerUnit * pxPerUnit;
+    bool lOk = std::fabs(covered - expect) < 0.02 * expect;
+    std::cout << "L-shape: " << covered << " pixels, expected " << expect << (lOk ? "" : "  FAIL") << "\n";
+    ok &= lOk;
+
+    // Triangulated in world space (as ShadowMap::render does), then moved
+    // into view space in place: culling must follow the moved vertices, so
+    // the frame matches a mesh that was never triangulated before
+    {
+        View3DParameters eye(Point3D(2,1.5,-4), Point3D(0,0,0), Point3D(0,1,0),
+                             60.0*M_PI/180.0, 1.0, 0.1, 100.0);
+        Transformation3D V = eye.make_view().view_matrix();
+        Mesh3D warm = make_cube(), fresh = make_cube();
+        warm.triangulation();
+        for (auto& p : warm.vertices) p = V.apply(p);
+        for (auto& p : fresh.vertices) p = V.apply(p);
+        RasterBuffer<uint8_t> wa(256,256,3,0,true), fa(256,256,3,0,true);
+        MeshRenderer2D(wa, cam, proj).render(warm, warm.compute_vertex_normals(), RenderMode::Flat);
+        MeshRenderer2D(fa, cam, proj).render(fresh, fresh.compute_vertex_normals(), RenderMode::Flat);
+        size_t lit = 0;
+        for (double d : fa.depth) lit += d < 1e9;
+        bool same = wa.data == fa.data && wa.depth == fa.depth && lit > 0;
+        std::cout << "cube triangulated before the view transform: " << lit << " px, "
+                  << (same ? "same as a fresh mesh" : "DIFFERS from a fresh mesh") << "\n";
+        ok &= same;
+    }
+
+    // Frame cost: cached triangulation against rebuilding it every frame
+    Mesh3D cs = make_cube_sphere(96, 1.0);
+    Transformation3D V = View3DParameters(Point3D(0,0,-3), Point3D(0,0,0), Point3D(0,1,0),
+                                          60.0*M_PI/180.0, 1.0, 0.1, 100.0).make_view().view_matrix();
+    for (auto& p : cs.vertices) p = V.apply(p);
+    auto vn = cs.compute_vertex_normals();
+    RasterBuffer<uint8_t> a(256,256,3,0,true), b(256,256,3,0,true);
+    MeshRenderer2D ra(a, cam, proj), rbld(b, cam, proj);
+    // Rebuilding the triangulation every frame against the cached one:
+    // frames interleaved, best of each (reported, not asserted)
+    double cachedMs = 1e30, rebuiltMs = 1e30;
+    for (int i=0; i<12; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        std::fill(a.data.begin(), a.data.end(), 0); a.clear_depth(); ra.render(cs, vn, RenderMode::Gouraud);
+        auto t1 = std::chrono::steady_clock::now();
+        std::fill(b.data.begin(), b.data.end(), 0); b.clear_depth(); cs.invalidate_triangulation(); rbld.render(cs, vn, RenderMode::Gouraud);
+        auto t2 = std::chrono::steady_clock::now();
+        cachedMs = std::min(cachedMs, ms(t0,t1));
+        rebuiltMs = std::min(rebuiltMs, ms(t1,t2));
+    }
+    double build = 1e30;
+    for (int i=0; i<5; ++i) {
+        cs.invalidate_triangulation();
+        auto t0 = std::chrono::steady_clock::now();
+        cs.triangulation();
+        build = std::min(build, ms(t0, std::chrono::steady_clock::now()));
+    }
+    std::cout << "cube-sphere " << cs.faces.size() << " faces: " << cachedMs << " ms/frame cached, "
+              << rebuiltMs << " ms/frame rebuilding (triangulation " << build << " ms), same image "
+              << (a.data == b.data ? "yes" : "NO") << "\n";
+    ok &= a.data == b.data;
+
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+#include "VoxelWorld.hpp"
+#include "View3DParameters.hpp"
+#include "RasterBuffer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+
+// Face area per outward axis direction over all chunk meshes
+static std::map<int,double> area_by_facing(const VoxelWorld& w) {
+    std::map<int,double> a;
+    w.for_each_chunk([&](const VoxelWorld::Chunk& c) {
+        for (const auto& f : c.mesh.faces) {
+            Point3D n = c.mesh.face_normal(f);
+            int k = std::fabs(n.x) > 1e-9 ? (n.x > 0 ? 0 : 1) : std::fabs(n.y) > 1e-9 ? (n.y > 0 ? 2 : 3) : (n.z > 0 ? 4 : 5);
+            a[k] += 0.5 * std::sqrt(n.x*n.x + n.y*n.y + n.z*n.z);
+        }
+    });
+    return a;
+}
+
+// Same world as one VoxelGrid, meshed in one piece
+static std::map<int,double> area_reference(const VoxelWorld& w, int X, int Y, int Z) {
+    VoxelGrid g(X, Y, Z);
+    for (int y=0; y<Y; ++y) for (int z=0; z<Z; ++z) for (int x=0; x<X; ++x) g.set(x, y, z, w.get(x, y, z));
+    Mesh3D m = greedy_mesh(g);
+    std::map<int,double> a;
+    for (const auto& f : m.faces) {
+        Point3D n = m.face_normal(f);
+        int k = std::fabs(n.x) > 1e-9 ? (n.x > 0 ? 0 : 1) : std::fabs(n.y) > 1e-9 ? (n.y > 0 ? 2 : 3) : (n.z > 0 ? 4 : 5);
+        a[k] += 0.5 * std::sqrt(n.x*n.x + n.y*n.y + n.z*n.z);
+    }
+    return a;
+}
+
+static bool same(const std::map<int,double>& a, const std::map<int,double>& b) {
+    if (a.size() != b.size()) return false;
+    for (const auto& e : a) if (!b.count(e.first) || std::fabs(b.at(e.first) - e.second) > 1e-6) return false;
+    return true;
+}
+
+int main() {
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+    using clk = std::chrono::steady_clock;
+
+    // 256 x 48 x 256 rolling terrain, two materials
+    const int X = 256, Y = 48, Z = 256;
+    VoxelWorld w(Point3D(1,1,1), Point3D(0,0,0), { Point3D(1,1,1), Point3D(0.4,0.8,0.3), Point3D(0.6,0.5,0.4) });
+    for (int z=0; z<Z; ++z)
+        for (int x=0; x<X; ++x) {
+            int h = 20 + (int)(12 * std::sin(x * 0.04) * std::cos(z * 0.05));
+            for (int y=0; y<h; ++y) w.set(x, y, z, y + 3 < h ? 2 : 1);
+        }
+    auto t0 = clk::now();
+    int built = w.remesh();
+    auto t1 = clk::now();
+    size_t tris = 0;
+    w.for_each_chunk([&](const VoxelWorld::Chunk& c) { tris += c.mesh.faces.size(); });
+    std::cout << "full build: " << built << " chunks, " << tris << " triangles, " << ms(t0,t1) << " ms\n";
+    bool match = same(area_by_facing(w), area_reference(w, X, Y, Z));
+    std::cout << "matches one-piece mesh area: " << (match ? "yes" : "NO") << "\n";
+    bool ok = match && built == (int)w.chunk_count();
+
+    // Interior edit: one chunk
+    t0 = clk::now();
+    w.set(40, 30, 40, 1);
+    built = w.remesh();
+    t1 = clk::now();
+    std::cout << "interior edit: " << built << " chunk(s) remeshed, " << ms(t0,t1) << " ms\n";
+    ok &= built == 1;
+
+    // Edit on a chunk edge: the cell's chunk and the two neighbours it touches
+    t0 = clk::now();
+    w.set(63, 5, 64, 0);
+    built = w.remesh();
+    t1 = clk::now();
+    std::cout << "edge edit: " << built << " chunk(s) remeshed, " << ms(t0,t1) << " ms\n";
+    ok &= built == 3;
+
+    // Dig a tunnel across chunk borders, remesh once
+    for (int x=20; x<200; ++x) for (int y=10; y<14; ++y) for (int z=100; z<104; ++z) w.set(x, y, z, 0);
+    t0 = clk::now();
+    built = w.remesh();
+    t1 = clk::now();
+    std::cout << "tunnel: " << built << " chunk(s) remeshed, " << ms(t0,t1) << " ms\n";
+    match = same(area_by_facing(w), area_reference(w, X, Y, Z));
+    std::cout << "still matches one-piece mesh: " << (match ? "yes" : "NO") << "\n";
+    ok &= match;
+
+    // Culling: a chunk left out must draw nothing on its own. Triangles
+    // reaching behind the near plane are skipped there, the renderer does
+    // not clip them (it would smear them across the screen).
+    View3DParameters params(Point3D(40,45,-10), Point3D(90,15,60), Point3D(0,1,0),
+                            60.0*M_PI/180.0, 1.0, 0.1, 500.0);
+    View3D cam = params.make_view();
+    Projection3D proj = params.make_projection();
+    RasterBuffer<uint8_t> culled(256,256,3,0,true);
+    MeshRenderer2D rc(culled, cam, proj, Point3D(0.3,0.4,-1.0));
+    t0 = clk::now();
+    int drawn = w.render(rc, RenderMode::Flat);
+    t1 = clk::now();
+
+    const Transformation3D V = cam.view_matrix();
+    auto shown = w.visible(V, proj);
+    size_t leaked = 0;
+    w.for_each_chunk([&](const VoxelWorld::Chunk& c) {
+        if (std::find(shown.begin(), shown.end(), &c) != shown.end()) return;
+        Mesh3D m;
+        for (const auto& p : c.mesh.vertices) m.vertices.push_back(V.apply(p));
+        for (const auto& f : c.mesh.faces) {
+            bool front = true;
+            for (int i : f.indices) front &= m.vertices[i].z > proj.nearZ;
+            if (front) m.faces.push_back(f);
+        }
+        RasterBuffer<uint8_t> alone(256,256,3,0,true);
+        MeshRenderer2D ra(alone, cam, proj, Point3D(0.3,0.4,-1.0));
+        ra.render(m, m.compute_vertex_normals(), RenderMode::Flat);
+        for (uint8_t v : alone.data) leaked += v != 0;
+    });
+    std::cout << "render: " << drawn << " of " << w.chunk_count() << " chunks drawn, " << ms(t0,t1)
+              << " ms; bytes drawn by culled chunks " << leaked << "\n";
+    culled.save_ppm("voxel_world.ppm");
+    ok &= drawn > 0 && drawn < (int)w.chunk_count() && leaked == 0;
+
+    std::cout << (ok ? "PASS" : "FAIL") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+#include "MeshBuilders.hpp"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <random>
+
+// Exposed unit faces per (axis, facing, material), counted cell by cell
+static std::map<int,double> exposed(const VoxelGrid& g) {
+    std::map<int,double> area;
+    const int dx[6] = { 1,-1, 0, 0, 0, 0 }, dy[6] = { 0, 0, 1,-1, 0, 0 }, dz[6] = { 0, 0, 0, 0, 1,-1 };
+    for (int y=0; y<g.ny; ++y)
+        for (int z=0; z<g.nz; ++z)
+            for (int x=0; x<g.nx; ++x) {
+                uint8_t m = g.get(x,y,z);
+                if (!m) continue;
+                for (int k=0; k<6; ++k)
+                    if (!g.get(x+dx[k], y+dy[k], z+dz[k])) area[k * 256 + m] += 1.0;
+            }
+    return area;
+}
+
+// Same tally from the mesh: every triangle must be axis-aligned, have
+// solid behind it and empty space in front (make_cube winding: the
+// geometric normal points into the solid)
+static std::map<int,double> measured(const Mesh3D& mesh, const VoxelGrid& g, int& bad) {
+    std::map<int,double> area;
+    for (const auto& f : mesh.faces) {
+        Point3D n = mesh.face_normal(f);
+        const Point3D& a = mesh.vertices[f.indices[0]];
+        const Point3D& b = mesh.vertices[f.indices[1]];
+        const Point3D& c = mesh.vertices[f.indices[2]];
+        Point3D ctr((a.x+b.x+c.x)/3, (a.y+b.y+c.y)/3, (a.z+b.z+c.z)/3);
+        double len = std::sqrt(n.x*n.x + n.y*n.y + n.z*n.z);
+        Point3D in(n.x/len, n.y/len, n.z/len);
+        int axis = std::fabs(in.x) > 0.5 ? 0 : std::fabs(in.y) > 0.5 ? 1 : 2;
+        double comp = axis == 0 ? in.x : axis == 1 ? in.y : in.z;
+        if (std::fabs(std::fabs(comp) - 1.0) > 1e-12) { ++bad; continue; }
+        auto cellAt = [&](double s) {
+            return g.get((int)std::floor(ctr.x + s*in.x), (int)std::floor(ctr.y + s*in.y),
+                         (int)std::floor(ctr.z + s*in.z));
+        };
+        uint8_t m = cellAt(0.5);
+        if (!m || cellAt(-0.5)) { ++bad; continue; }
+        area[(axis * 2 + (comp < 0 ? 0 : 1)) * 256 + m] += 0.5 * len;
+    }
+    return area;
+}
+
+static bool same(const std::map<int,double>& a, const std::map<int,double>& b) {
+    if (a.size() != b.size()) return false;
+    for (const auto& e : a) {
+        auto it = b.find(e.first);
+        if (it == b.end() || std::fabs(it->second - e.second) > 1e-9) return false;
+    }
+    return true;
+}
+
+int main() {
+    auto ms = [](auto t0, auto t1) { return std::chrono::duration<double, std::milli>(t1 - t0).count(); };
+
+    // Random blobs of three materials: exact face coverage and orientation
+    std::mt19937 rng(5);
+    for (int trial=0; trial<20; ++trial) {
+        VoxelGrid g(12, 9, 10);
+        for (auto& c : g.cells) c = (rng() % 3 == 0) ? (uint8_t)(1 + rng() % 3) : 0;
+        Mesh3D m = greedy_mesh(g);
+        int bad = 0;
+        bool ok = same(exposed(g), measured(m, g, bad));
+        if (!ok || bad) std::cout << "trial " << trial << ": coverage " << (ok ? "ok" : "WRONG")
+                                  << ", bad triangles " << bad << "\n";
+    }
+    std::cout << "random grids checked\n";
+
+    // Single cube: same winding as make_cube
+    VoxelGrid one(1,1,1);
+    one.set(0,0,0,1);
+    Mesh3D vc = greedy_mesh(one, Point3D(1,1,1), Point3D(-0.5,-0.5,-0.5));
+    Mesh3D mc = make_cube();
+    int agree = 0;
+    for (const auto& f : vc.faces) {
+        Point3D n = vc.face_normal(f);
+        for (const auto& g : mc.faces) {
+            Point3D k = mc.face_normal(g);
+            if (n.x*k.x + n.y*k.y + n.z*k.z > 0.99) { ++agree; break; }
+        }
+    }
+    std::cout << "single cube: " << vc.faces.size() << " triangles, " << agree << " match make_cube normals\n";
+
+    // Skyline and terrain: triangles vs one cube per cell
+    struct Case { const char* name; int M, N; std::function<int(int,int)> h; };
+    Case cases[] = {
+        { "flat 64x64", 64, 64, [](int, int) { return 1; } },
+        { "skyline 64x64", 64, 64, [](int i, int j) { return 1 + ((i / 8) * 7 + (j / 8) * 3) % 12; } },
+        { "terrain 128x128", 128, 128, [](int i, int j) {
+              return 1 + (int)(8 + 6 * std::sin(i * 0.07) * std::cos(j * 0.05)); } },
+    };
+    for (const auto& cs : cases) {
+        size_t cubes = 0;
+        for (int i=0; i<cs.M; ++i) for (int j=0; j<cs.N; ++j) cubes += cs.h(i,j);
+        auto t0 = std::chrono::steady_clock::now();
+        Mesh3D m = make_cube_grid_merged(cs.M, cs.N, cs.h, 1.0, 1.0, 1.0,
+                                         [](int i, int j) { return ((i / 16 + j / 16) & 1) ? Point3D(1,0,0) : Point3D(0,0,1); });
+        auto t1 = std::chrono::steady_clock::now();
+        std::cout << cs.name << ": " << cubes << " cubes, " << cubes * 12 << " triangles as cubes ("
+                  << cs.M * cs.N * 12 << " as one scaled cube per column) -> "
+                  << m.faces.size() << " triangles, " << m.vertices.size() << " vertices ("
+                  << cubes * 8 << " as cubes); " << ms(t0,t1) << " ms\n";
+    }
+    return 0;
+}